@@ -0,0 +1,812 @@
+/*
+havJSONBenchmark.cpp
+
+Measures parsing, reading values, serialization and BSON conversion over the usual JSON benchmark corpora. canada.json and
+twitter.json are also parsed into bound structs, and twitter.json is parsed with a filter, written again after a patch
+changed one member, and converted to BSON files in a batch.
+
+Usage: havJSONBenchmark [--quick] [data directory]
+
+twitter.json, canada.json, citm_catalog.json and log.ndjson are read from the data directory (defaults to the current
+directory). Missing files are replaced by generated documents of the same shape, and a deeply nested document is always
+generated. Throughput is reported relative to the size of the JSON text, so all rows of a corpus are comparable. --quick runs
+every operation once on small generated documents and only checks the results.
+*/
+
+// Note: GCC flags the replaced allocation functions below as mismatched once they are inlined
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+#include "../havJSON.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+
+#ifdef _WIN32
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// Fixed-schema views of canada.json and twitter.json for the bound struct rows. The twitter view only binds a few members of
+// each status, so all others are skipped.
+struct havJSONBenchmarkGeometry
+{
+    std::string type;
+    std::vector<std::vector<std::vector<double>>> coordinates;
+};
+
+struct havJSONBenchmarkProperties
+{
+    std::string name;
+};
+
+struct havJSONBenchmarkFeature
+{
+    std::string type;
+    havJSONBenchmarkProperties properties;
+    havJSONBenchmarkGeometry geometry;
+};
+
+struct havJSONBenchmarkFeatureCollection
+{
+    std::string type;
+    std::vector<havJSONBenchmarkFeature> features;
+};
+
+struct havJSONBenchmarkUser
+{
+    unsigned long long id = 0;
+    std::string screen_name;
+    int followers_count = 0;
+};
+
+struct havJSONBenchmarkStatus
+{
+    unsigned long long id = 0;
+    std::string text;
+    havJSONBenchmarkUser user;
+    int retweet_count = 0;
+};
+
+struct havJSONBenchmarkTimeline
+{
+    std::vector<havJSONBenchmarkStatus> statuses;
+};
+
+HAVJSON_BINDING(havJSONBenchmarkGeometry, HAVJSON_FIELD(havJSONBenchmarkGeometry, type), HAVJSON_FIELD(havJSONBenchmarkGeometry, coordinates));
+HAVJSON_BINDING(havJSONBenchmarkProperties, HAVJSON_FIELD(havJSONBenchmarkProperties, name));
+HAVJSON_BINDING(havJSONBenchmarkFeature, HAVJSON_FIELD(havJSONBenchmarkFeature, type), HAVJSON_FIELD(havJSONBenchmarkFeature, properties), HAVJSON_FIELD(havJSONBenchmarkFeature, geometry));
+HAVJSON_BINDING(havJSONBenchmarkFeatureCollection, HAVJSON_FIELD(havJSONBenchmarkFeatureCollection, type), HAVJSON_FIELD(havJSONBenchmarkFeatureCollection, features));
+HAVJSON_BINDING(havJSONBenchmarkUser, HAVJSON_FIELD(havJSONBenchmarkUser, id), HAVJSON_FIELD(havJSONBenchmarkUser, screen_name), HAVJSON_FIELD(havJSONBenchmarkUser, followers_count));
+HAVJSON_BINDING(havJSONBenchmarkStatus, HAVJSON_FIELD(havJSONBenchmarkStatus, id), HAVJSON_FIELD(havJSONBenchmarkStatus, text), HAVJSON_FIELD(havJSONBenchmarkStatus, user), HAVJSON_FIELD(havJSONBenchmarkStatus, retweet_count));
+HAVJSON_BINDING(havJSONBenchmarkTimeline, HAVJSON_FIELD(havJSONBenchmarkTimeline, statuses));
+
+namespace
+{
+    std::atomic<std::size_t> gHeapAllocations(0);
+
+    struct havJSONBenchmarkCorpus
+    {
+        std::string mName;
+        std::string mContent;
+        // File with the same content, used by the ParseFile row
+        std::string mFileName;
+        bool mGenerated = false;
+        bool mLines = false;
+    };
+
+    struct havJSONBenchmarkResult
+    {
+        double mSeconds = 0.0;
+        std::size_t mAllocations = 0;
+    };
+
+    // Small deterministic generator, so generated corpora are the same on every run
+    class havJSONBenchmarkRandom
+    {
+    public:
+        unsigned int Next(unsigned int maxValue)
+        {
+            mState = mState * 6364136223846793005ULL + 1442695040888963407ULL;
+
+            return static_cast<unsigned int>((mState >> 33) % maxValue);
+        }
+
+        double NextDouble(double minValue, double maxValue)
+        {
+            return minValue + (maxValue - minValue) * (static_cast<double>(Next(1000000000)) / 1000000000.0);
+        }
+
+    private:
+        unsigned long long mState = 42;
+    };
+
+    std::string FormatDouble(double value)
+    {
+        char buffer[32];
+
+        std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+
+        return buffer;
+    }
+
+    // Statuses with nested user and entity objects, many short strings and non-ASCII text (like twitter.json)
+    std::string CreateTwitterDocument(int numOfStatuses)
+    {
+        havJSONBenchmarkRandom random;
+
+        static const char* texts[] =
+        {
+            "@aym0566x \\n\\n\\u540d\\u524d:\\u524d\\u7530\\u3042\\u3086\\u307f\\n\\u7b2c\\u4e00\\u5370\\u8c61:\\u306a\\u3093\\u304b\\u6016\\u3063\\uff01",
+            "RT @KATANA77: \\u3048\\u3063\\u305d\\u3046\\u306a\\u306e\\uff1f http://t.co/ly1OYhL8Sq",
+            "\\\"Just setting up my twttr\\\" - a quote with escapes \\/ and a tab\\t",
+            "Plain ASCII status text that is a little longer than the others to exercise the string scanner"
+        };
+
+        std::string jsonContent = "{\"statuses\":[";
+
+        for (int index = 0; index < numOfStatuses; ++index)
+        {
+            if (index > 0)
+            {
+                jsonContent += ",";
+            }
+
+            std::string id = std::to_string(505874924095815681ULL + random.Next(1000000));
+
+            jsonContent += "{\"metadata\":{\"result_type\":\"recent\",\"iso_language_code\":\"ja\"},\"created_at\":\"Sun Aug 31 00:29:15 +0000 2014\",";
+            jsonContent += "\"id\":" + id + ",\"id_str\":\"" + id + "\",\"text\":\"" + texts[random.Next(4)] + "\",";
+            jsonContent += "\"source\":\"<a href=\\\"https://mobile.twitter.com\\\" rel=\\\"nofollow\\\">Mobile Web (M2)</a>\",\"truncated\":false,";
+            jsonContent += "\"in_reply_to_status_id\":null,\"in_reply_to_user_id\":" + std::to_string(random.Next(100000000)) + ",";
+            jsonContent += "\"user\":{\"id\":" + std::to_string(random.Next(2000000000)) + ",\"name\":\"\\u7a7a\\u679c\\u3000\\u2606\",\"screen_name\":\"user" + std::to_string(index) + "\",";
+            jsonContent += "\"location\":\"\\u57fc\\u7389\",\"description\":\"\\u30ea\\u30a2\\u30eb\\u3067\\u306f\",\"url\":null,\"protected\":false,";
+            jsonContent += "\"followers_count\":" + std::to_string(random.Next(10000)) + ",\"friends_count\":" + std::to_string(random.Next(10000)) + ",";
+            jsonContent += "\"profile_background_color\":\"C0DEED\",\"profile_use_background_image\":true,\"default_profile\":true,\"following\":false},";
+            jsonContent += "\"geo\":null,\"coordinates\":null,\"place\":null,\"retweet_count\":" + std::to_string(random.Next(500)) + ",\"favorite_count\":0,";
+            jsonContent += "\"entities\":{\"hashtags\":[{\"text\":\"tag\",\"indices\":[" + std::to_string(random.Next(50)) + ",60]}],\"symbols\":[],";
+            jsonContent += "\"urls\":[{\"url\":\"http://t.co/ly1OYhL8Sq\",\"expanded_url\":\"http://example.com/path\",\"indices\":[20,42]}],";
+            jsonContent += "\"user_mentions\":[{\"screen_name\":\"aym0566x\",\"name\":\"\\u524d\\u7530\",\"id\":586671909,\"indices\":[0,9]}]},";
+            jsonContent += "\"favorited\":false,\"retweeted\":false,\"lang\":\"ja\"}";
+        }
+
+        jsonContent += "],\"search_metadata\":{\"completed_in\":0.087,\"max_id\":505874924095815681,\"query\":\"%E4%B8%80\",\"count\":100,\"since_id\":0}}";
+
+        return jsonContent;
+    }
+
+    // A polygon with long arrays of coordinate pairs (like canada.json)
+    std::string CreateCanadaDocument(int numOfPoints)
+    {
+        havJSONBenchmarkRandom random;
+
+        std::string jsonContent = "{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\",\"properties\":{\"name\":\"Canada\"},\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[";
+
+        for (int index = 0; index < numOfPoints; ++index)
+        {
+            // Rings of 1000 points
+            if (index % 1000 == 0)
+            {
+                jsonContent += (index > 0) ? "],[" : "[";
+            }
+            else
+            {
+                jsonContent += ",";
+            }
+
+            jsonContent += "[" + FormatDouble(random.NextDouble(-141.0, -52.0)) + "," + FormatDouble(random.NextDouble(41.0, 83.0)) + "]";
+        }
+
+        jsonContent += "]]}}]}";
+
+        return jsonContent;
+    }
+
+    // Objects keyed by numeric IDs plus arrays of small records with many integers (like citm_catalog.json)
+    std::string CreateCatalogDocument(int numOfEvents)
+    {
+        havJSONBenchmarkRandom random;
+
+        std::string jsonContent = "{\"areaNames\":{";
+
+        for (int index = 0; index < 20; ++index)
+        {
+            jsonContent += ((index > 0) ? ",\"" : "\"") + std::to_string(205705993 + index) + "\":\"Arri\\u00e8re-sc\\u00e8ne central " + std::to_string(index) + "\"";
+        }
+
+        jsonContent += "},\"events\":{";
+
+        for (int index = 0; index < numOfEvents; ++index)
+        {
+            std::string id = std::to_string(138586341 + index);
+
+            jsonContent += ((index > 0) ? ",\"" : "\"") + id + "\":{\"description\":null,\"id\":" + id + ",\"logo\":null,\"name\":\"30th Anniversary Tour\",";
+            jsonContent += "\"subTopicIds\":[337184269,337184283],\"subjectCode\":null,\"subtitle\":null,\"topicIds\":[324846099,107888604]}";
+        }
+
+        jsonContent += "},\"performances\":[";
+
+        for (int index = 0; index < numOfEvents; ++index)
+        {
+            if (index > 0)
+            {
+                jsonContent += ",";
+            }
+
+            jsonContent += "{\"eventId\":" + std::to_string(138586341 + index) + ",\"id\":" + std::to_string(339887544 + index) + ",\"logo\":null,\"name\":null,\"prices\":[";
+
+            for (int priceIndex = 0; priceIndex < 3; ++priceIndex)
+            {
+                jsonContent += ((priceIndex > 0) ? ",{" : "{") + std::string("\"amount\":") + std::to_string(90250 + random.Next(10000)) + ",\"audienceSubCategoryId\":337100890,\"seatCategoryId\":" + std::to_string(338937295 + priceIndex) + "}";
+            }
+
+            jsonContent += "],\"seatCategories\":[{\"areas\":[{\"areaId\":205705999,\"blockIds\":[]},{\"areaId\":205705998,\"blockIds\":[]}],\"seatCategoryId\":338937295}],";
+            jsonContent += "\"seatMapImage\":null,\"start\":" + std::to_string(1372701600000ULL + random.Next(100000000)) + ",\"venueCode\":\"PLEYEL_PLEYEL\"}";
+        }
+
+        jsonContent += "],\"venueNames\":{\"PLEYEL_PLEYEL\":\"Salle Pleyel\"}}";
+
+        return jsonContent;
+    }
+
+    // One log record per line
+    std::string CreateLogLines(int numOfLines)
+    {
+        havJSONBenchmarkRandom random;
+
+        static const char* levels[] = { "debug", "info", "warning", "error" };
+
+        std::string jsonContent;
+
+        for (int index = 0; index < numOfLines; ++index)
+        {
+            jsonContent += "{\"time\":\"2024-05-01T12:" + std::to_string(10 + index % 50) + ":00.123Z\",\"level\":\"" + levels[random.Next(4)] + "\",\"service\":\"api\",";
+            jsonContent += "\"requestId\":\"" + std::to_string(random.Next(1000000000)) + "\",\"status\":" + std::to_string(200 + random.Next(4) * 100) + ",";
+            jsonContent += "\"latency\":" + FormatDouble(random.NextDouble(0.1, 250.0)) + ",\"message\":\"GET /api/v1/items/" + std::to_string(index) + " completed\",";
+            jsonContent += "\"tags\":[\"http\",\"v1\"],\"user\":{\"id\":" + std::to_string(random.Next(100000)) + ",\"admin\":" + ((random.Next(2) == 0) ? "false" : "true") + "}}\n";
+        }
+
+        return jsonContent;
+    }
+
+    // Alternately nested objects and arrays
+    std::string CreateDeepDocument(int depth)
+    {
+        std::string jsonContent;
+
+        for (int index = 0; index < depth; ++index)
+        {
+            jsonContent += (index % 2 == 0) ? "{\"level\":" + std::to_string(index) + ",\"child\":" : "[" + std::to_string(index) + ",";
+        }
+
+        jsonContent += "null";
+
+        for (int index = depth - 1; index >= 0; --index)
+        {
+            jsonContent += (index % 2 == 0) ? "}" : "]";
+        }
+
+        return jsonContent;
+    }
+
+    // Reads every value through operator[] and the typed getters, like a hot loop over a parsed configuration does
+    double ReadValues(const havJSON::havJSONData& valueNode)
+    {
+        double sum = 0.0;
+
+        if (valueNode.isArray() == true)
+        {
+            int arraySize = static_cast<int>(valueNode.arraySize());
+
+            for (int index = 0; index < arraySize; ++index)
+            {
+                sum += ReadValues(valueNode[index]);
+            }
+        }
+        else if (valueNode.isObject() == true)
+        {
+            for (const auto& item : std::get<havJSON::havJSONObject>(valueNode.getValueRef()))
+            {
+                sum += ReadValues(valueNode[item.first]);
+            }
+        }
+        else if (valueNode.isString() == true)
+        {
+            sum += static_cast<double>(valueNode.toString().size());
+        }
+        else if (valueNode.isBoolean() == true)
+        {
+            sum += (valueNode.toBoolean() == true) ? 1.0 : 0.0;
+        }
+        else if (valueNode.isNull() == false)
+        {
+            sum += valueNode.toDouble();
+        }
+
+        return sum;
+    }
+
+    bool ReadFileContents(const std::filesystem::path& fileName, std::string& fileContents)
+    {
+        std::ifstream fileStream(fileName, std::ios::binary);
+
+        if (fileStream.is_open() == false)
+        {
+            return false;
+        }
+
+        fileContents.assign(std::istreambuf_iterator<char>(fileStream), std::istreambuf_iterator<char>());
+
+        return true;
+    }
+
+    bool WriteFileContents(const std::filesystem::path& fileName, const std::string& fileContents)
+    {
+        std::ofstream fileStream(fileName, std::ios::binary);
+
+        fileStream.write(fileContents.data(), static_cast<std::streamsize>(fileContents.size()));
+
+        return fileStream.good();
+    }
+
+    std::size_t GetPeakRSS()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS memoryCounters;
+
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters)) == FALSE)
+        {
+            return 0;
+        }
+
+        return memoryCounters.PeakWorkingSetSize;
+#else
+        struct rusage resourceUsage;
+
+        if (getrusage(RUSAGE_SELF, &resourceUsage) != 0)
+        {
+            return 0;
+        }
+
+#ifdef __APPLE__
+        // Note: Reported in bytes on macOS, but in kilobytes elsewhere
+        return static_cast<std::size_t>(resourceUsage.ru_maxrss);
+#else
+        return static_cast<std::size_t>(resourceUsage.ru_maxrss) * 1024;
+#endif
+#endif
+    }
+
+    // Runs function until minSeconds have passed (at least minIterations times) and returns the fastest run. Allocations are
+    // counted during the first run.
+    template<typename Function>
+    bool Measure(Function&& function, double minSeconds, int minIterations, havJSONBenchmarkResult& result)
+    {
+        result.mSeconds = 0.0;
+
+        double totalSeconds = 0.0;
+
+        for (int iteration = 0; iteration < minIterations || totalSeconds < minSeconds; ++iteration)
+        {
+            std::size_t allocationsBefore = gHeapAllocations;
+
+            std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+            if (function() == false)
+            {
+                return false;
+            }
+
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+            if (iteration == 0)
+            {
+                result.mAllocations = gHeapAllocations - allocationsBefore;
+            }
+
+            if (iteration == 0 || seconds < result.mSeconds)
+            {
+                result.mSeconds = seconds;
+            }
+
+            totalSeconds += seconds;
+        }
+
+        return true;
+    }
+
+    void PrintResult(const std::string& operationName, std::size_t contentSize, const havJSONBenchmarkResult& result)
+    {
+        double megabytesPerSecond = (result.mSeconds > 0.0) ? (static_cast<double>(contentSize) / (1024.0 * 1024.0)) / result.mSeconds : 0.0;
+
+        std::cout << "  " << std::left << std::setw(36) << operationName << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << megabytesPerSecond << " MB/s" << std::setw(10) << std::setprecision(3) << result.mSeconds * 1000.0 << " ms"
+                  << std::setw(12) << result.mAllocations << " allocations\n";
+    }
+
+    bool RunCorpus(const havJSONBenchmarkCorpus& corpus, double minSeconds, int minIterations)
+    {
+        std::cout << corpus.mName << " (" << corpus.mContent.size() / 1024 << " KB" << ((corpus.mGenerated == true) ? ", generated" : "") << ")\n";
+
+        bool result = true;
+
+        auto run = [&](const std::string& operationName, auto&& function)
+        {
+            havJSONBenchmarkResult benchmarkResult;
+
+            if (Measure(function, minSeconds, minIterations, benchmarkResult) == false)
+            {
+                std::cout << "  " << operationName << " failed!\n";
+
+                result = false;
+
+                return;
+            }
+
+            PrintResult(operationName, corpus.mContent.size(), benchmarkResult);
+        };
+
+        havJSON::havJSONStream stream;
+
+        if (corpus.mLines == true)
+        {
+            havJSON::havJSONLineReader reader;
+            havJSON::havJSONParallelParser parallelParser;
+
+            havJSON::havJSONData records;
+
+            run("havJSONLineReader::next", [&]()
+            {
+                havJSON::havJSONData record;
+
+                reader.open(corpus.mContent);
+
+                while (reader.next(record) == true)
+                {
+                }
+
+                return reader.failed() == false;
+            });
+
+            run("havJSONLineReader::openFile", [&]()
+            {
+                havJSON::havJSONData record;
+
+                if (reader.openFile(corpus.mFileName) == false)
+                {
+                    return false;
+                }
+
+                while (reader.next(record) == true)
+                {
+                }
+
+                return reader.failed() == false;
+            });
+
+            run("havJSONParallelParser::ParseLines", [&]() { return parallelParser.ParseLines(corpus.mContent, records); });
+
+            run("Read loop", [&]() { return ReadValues(records) != 0.0; });
+
+            std::string lineContents;
+
+            run("havJSONLineWriter::write", [&]()
+            {
+                lineContents.clear();
+
+                havJSON::havJSONOutputBuffer outputBuffer(lineContents);
+                havJSON::havJSONLineWriter writer(outputBuffer);
+
+                for (const std::shared_ptr<havJSON::havJSONData>& record : std::get<std::vector<std::shared_ptr<havJSON::havJSONData>>>(records.getValueRef()))
+                {
+                    writer.write(*record);
+                }
+
+                return writer.close();
+            });
+
+            return result;
+        }
+
+        havJSON::havJSONData root;
+
+        stream.SetParserType(havJSON::havJSONParserType::Tokenizer);
+
+        run("ParseContent (tokenizer)", [&]() { return stream.ParseContent(corpus.mContent, root); });
+
+        stream.SetParserType(havJSON::havJSONParserType::RecursiveDescent);
+
+        run("ParseContent (recursive descent)", [&]() { return stream.ParseContent(corpus.mContent, root); });
+
+        havJSON::havJSONDocument document;
+
+        run("ParseContent (document)", [&]() { return stream.ParseContent(corpus.mContent, document); });
+
+        // Note: Without its last byte, the document is read up to its end before the error is found, so rejecting it should take
+        // as long as parsing it
+        std::string_view truncatedContent(corpus.mContent.data(), corpus.mContent.find_last_not_of(" \t\n\r"));
+
+        run("TryParseContent (truncated)", [&]() { return stream.TryParseContent(truncatedContent, root).mCode == havJSON::havJSONErrorCode::UnexpectedEnd; });
+
+        run("ParseFile", [&]() { return stream.ParseFile(corpus.mFileName, root); });
+
+        run("Read loop", [&]() { return ReadValues(root) != 0.0; });
+
+        std::string jsonContent;
+
+        run("ConvertJSONToString", [&]()
+        {
+            jsonContent.clear();
+
+            return stream.ConvertJSONToString(root, jsonContent);
+        });
+
+        // The compact output has to parse into the same tree again
+        havJSON::havJSONData roundTripRoot;
+        std::string roundTripContent;
+
+        if (stream.ParseContent(jsonContent, roundTripRoot) == false || stream.ConvertJSONToString(roundTripRoot, roundTripContent) == false || roundTripContent != jsonContent)
+        {
+            std::cout << "  Round trip through JSON text failed!\n";
+
+            result = false;
+        }
+
+        run("ConvertJSONToString (formatted)", [&]()
+        {
+            jsonContent.clear();
+
+            return stream.ConvertJSONToString(root, jsonContent, true);
+        });
+
+        std::vector<char> bsonContent;
+
+        run("ConvertJSONToBSON", [&]() { return stream.ConvertJSONToBSON(root, bsonContent); });
+
+        havJSON::havJSONData bsonRoot;
+
+        run("ParseBSONContent", [&]() { return stream.ParseBSONContent(bsonContent.data(), bsonContent.size(), bsonRoot); });
+
+        if (corpus.mName == "canada.json")
+        {
+            havJSONBenchmarkFeatureCollection featureCollection;
+
+            run("ParseContent (bound struct)", [&]() { return stream.ParseContent(corpus.mContent, featureCollection); });
+
+            run("ConvertJSONToString (bound struct)", [&]()
+            {
+                jsonContent.clear();
+
+                return stream.ConvertJSONToString(featureCollection, jsonContent);
+            });
+        }
+        else if (corpus.mName == "twitter.json")
+        {
+            havJSONBenchmarkTimeline timeline;
+
+            run("ParseContent (bound struct, partial)", [&]() { return stream.ParseContent(corpus.mContent, timeline); });
+
+            // Note: Every run changes one member of the first status, so only its path to the root is written again
+            havJSON::havJSONSerializationCache serializationCache;
+            havJSON::havJSONPatch patch(serializationCache);
+
+            havJSON::havJSONData patchDocument;
+            stream.ParseContent(R"([{"op":"replace","path":"/statuses/0/retweet_count","value":0}])", patchDocument);
+
+            stream.ConvertJSONToString(root, jsonContent, serializationCache);
+
+            run("ConvertJSONToString (cached)", [&]()
+            {
+                jsonContent.clear();
+
+                return patch.apply(root, patchDocument) == true && stream.ConvertJSONToString(root, jsonContent, serializationCache) == true;
+            });
+
+            std::string uncachedContent;
+
+            if (stream.ConvertJSONToString(root, uncachedContent) == false || uncachedContent != jsonContent)
+            {
+                std::cout << "  Cached output differs from uncached output!\n";
+
+                result = false;
+            }
+
+            // Note: Selects the same members as the bound struct
+            havJSON::havJSONFilter statusFilter { "/statuses/*/id", "/statuses/*/text", "/statuses/*/user/id", "/statuses/*/user/screen_name",
+                                                  "/statuses/*/user/followers_count", "/statuses/*/retweet_count" };
+
+            run("ParseContent (filtered)", [&]() { return stream.ParseContent(corpus.mContent, root, statusFilter); });
+        }
+
+        return result;
+    }
+}
+
+namespace
+{
+    // Converts copies of the corpus file to BSON files, one after another and with the batch converter
+    bool RunBatch(const havJSONBenchmarkCorpus& corpus, const std::filesystem::path& temporaryDirectory, double minSeconds, int minIterations)
+    {
+        const int numOfFiles = 16;
+
+        std::cout << corpus.mName << " x " << numOfFiles << " (conversion to BSON files)\n";
+
+        std::vector<havJSON::havJSONBatchFile> files;
+
+        for (int index = 0; index < numOfFiles; ++index)
+        {
+            files.push_back({ corpus.mFileName, (temporaryDirectory / ("batch" + std::to_string(index) + ".bson")).string() });
+        }
+
+        bool result = true;
+
+        auto run = [&](const std::string& operationName, auto&& function)
+        {
+            havJSONBenchmarkResult benchmarkResult;
+
+            if (Measure(function, minSeconds, minIterations, benchmarkResult) == false)
+            {
+                std::cout << "  " << operationName << " failed!\n";
+
+                result = false;
+
+                return;
+            }
+
+            PrintResult(operationName, corpus.mContent.size() * numOfFiles, benchmarkResult);
+        };
+
+        havJSON::havJSONStream stream;
+        stream.SetParserType(havJSON::havJSONParserType::RecursiveDescent);
+
+        havJSON::havJSONData root;
+        std::vector<char> bsonContent;
+
+        run("ParseFile + WriteBSONFile", [&]()
+        {
+            for (const havJSON::havJSONBatchFile& file : files)
+            {
+                if (stream.ParseFile(file.mInputFileName, root) == false || stream.WriteBSONFile(file.mOutputFileName, root, bsonContent) == false)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        });
+
+        havJSON::havJSONBatchConverter batchConverter;
+
+        run("havJSONBatchConverter::ConvertFiles", [&]()
+        {
+            std::vector<havJSON::havJSONResult> results = batchConverter.ConvertFiles(files);
+
+            return std::none_of(results.begin(), results.end(), [](const havJSON::havJSONResult& fileResult) { return fileResult.failed(); });
+        });
+
+        return result;
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    ++gHeapAllocations;
+
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+int main(int argc, char* argv[])
+{
+    bool quick = false;
+
+    std::filesystem::path dataDirectory = ".";
+
+    for (int index = 1; index < argc; ++index)
+    {
+        if (std::string(argv[index]) == "--quick")
+        {
+            quick = true;
+        }
+        else
+        {
+            dataDirectory = argv[index];
+        }
+    }
+
+    // Quick runs only check the results
+    int scale = (quick == true) ? 1 : 20;
+    double minSeconds = (quick == true) ? 0.0 : 0.5;
+    int minIterations = (quick == true) ? 1 : 3;
+
+    std::filesystem::path temporaryDirectory = std::filesystem::temp_directory_path() / ("havJSONBenchmark" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+
+    std::filesystem::create_directories(temporaryDirectory);
+
+    struct havJSONBenchmarkSource
+    {
+        const char* mFileName;
+        std::string (*mCreate)(int scale);
+        bool mLines;
+    };
+
+    havJSONBenchmarkSource sources[] =
+    {
+        { "twitter.json", [](int scale) { return CreateTwitterDocument(50 * scale); }, false },
+        { "canada.json", [](int scale) { return CreateCanadaDocument(5600 * scale); }, false },
+        { "citm_catalog.json", [](int scale) { return CreateCatalogDocument(120 * scale); }, false },
+        { "log.ndjson", [](int scale) { return CreateLogLines(1000 * scale); }, true },
+        { "deep_nesting.json", [](int) { return CreateDeepDocument(512); }, false }
+    };
+
+    std::vector<havJSONBenchmarkCorpus> corpora;
+
+    for (const havJSONBenchmarkSource& source : sources)
+    {
+        havJSONBenchmarkCorpus corpus;
+
+        corpus.mName = source.mFileName;
+        corpus.mLines = source.mLines;
+
+        std::filesystem::path fileName = dataDirectory / source.mFileName;
+
+        if (quick == false && ReadFileContents(fileName, corpus.mContent) == true)
+        {
+            corpus.mFileName = fileName.string();
+        }
+        else
+        {
+            corpus.mContent = source.mCreate(scale);
+            corpus.mGenerated = true;
+
+            fileName = temporaryDirectory / source.mFileName;
+
+            if (WriteFileContents(fileName, corpus.mContent) == false)
+            {
+                std::cout << "Unable to write JSON file: " << fileName.string() << "\n";
+
+                return 1;
+            }
+
+            corpus.mFileName = fileName.string();
+        }
+
+        corpora.push_back(std::move(corpus));
+    }
+
+    bool result = true;
+
+    for (const havJSONBenchmarkCorpus& corpus : corpora)
+    {
+        result = RunCorpus(corpus, minSeconds, minIterations) && result;
+    }
+
+    result = RunBatch(corpora[0], temporaryDirectory, minSeconds, minIterations) && result;
+
+    std::cout << "Peak RSS: " << GetPeakRSS() / 1024 << " KB\n";
+
+    std::error_code errorCode;
+
+    std::filesystem::remove_all(temporaryDirectory, errorCode);
+
+    return (result == true) ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+/*
+havJSONNodeSizeBenchmark.cpp
+
+Reports how many bytes a parsed document needs per node.
+
+The previous node layout (type tag next to a variant that held std::map objects and stored null as a string) is reproduced
+below, so the output shows the size before and after the compact layout.
+*/
+
+// Note: GCC flags the replaced allocation functions below as mismatched once they are inlined
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+#include "../havJSON.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<std::size_t> gHeapBytes(0);
+    std::atomic<std::size_t> gHeapAllocations(0);
+
+    // Layout of havJSONData before the compact node layout
+    struct havJSONLegacyNode
+    {
+        havJSON::havJSONDataType mType;
+        std::variant<bool, int, unsigned int, long, unsigned long, long long, unsigned long long, double, const char*, std::string, std::vector<std::shared_ptr<havJSONLegacyNode>>, std::map<std::string, std::shared_ptr<havJSONLegacyNode>>> mValue;
+    };
+
+    std::size_t CountNodes(const havJSON::havJSONData& valueNode)
+    {
+        std::size_t count = 1;
+
+        if (valueNode.isArray() == true)
+        {
+            for (const std::shared_ptr<havJSON::havJSONData>& item : std::get<std::vector<std::shared_ptr<havJSON::havJSONData>>>(valueNode.getValueRef()))
+            {
+                count += CountNodes(*item);
+            }
+        }
+        else if (valueNode.isObject() == true)
+        {
+            for (const auto& item : std::get<havJSON::havJSONObject>(valueNode.getValueRef()))
+            {
+                count += CountNodes(*item.second);
+            }
+        }
+
+        return count;
+    }
+
+    std::string CreateDocument(int numOfRecords)
+    {
+        std::string jsonContent = "[";
+
+        for (int index = 0; index < numOfRecords; ++index)
+        {
+            if (index > 0)
+            {
+                jsonContent += ",";
+            }
+
+            jsonContent += "{\"id\":" + std::to_string(index) + ",\"active\":" + ((index % 2 == 0) ? "true" : "false") + ",\"parent\":null,\"score\":" + std::to_string(index) + ".5,\"name\":\"item" + std::to_string(index) + "\",\"tags\":[1,2,3]}";
+        }
+
+        jsonContent += "]";
+
+        return jsonContent;
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    gHeapBytes += size;
+    ++gHeapAllocations;
+
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+int main(int argc, char* argv[])
+{
+    int numOfRecords = (argc > 1) ? std::atoi(argv[1]) : 100000;
+
+    std::string jsonContent = CreateDocument(numOfRecords);
+
+    havJSON::havJSONStream stream;
+    stream.SetParserType(havJSON::havJSONParserType::RecursiveDescent);
+
+    havJSON::havJSONDocument document;
+
+    std::size_t heapBytesBefore = gHeapBytes;
+
+    if (stream.ParseContent(jsonContent, document) == false)
+    {
+        std::cout << "Unable to parse benchmark document!\n";
+
+        return 1;
+    }
+
+    std::size_t heapBytes = gHeapBytes - heapBytesBefore;
+
+    // The arena blocks are allocated through operator new as well
+    heapBytes -= document.arena().GetReservedBytes();
+
+    std::size_t numOfNodes = CountNodes(document.root());
+
+    std::cout << "Nodes:                        " << numOfNodes << "\n";
+    std::cout << "sizeof(node), before:         " << sizeof(havJSONLegacyNode) << " bytes\n";
+    std::cout << "sizeof(node), after:          " << sizeof(havJSON::havJSONData) << " bytes\n";
+    std::cout << "Arena bytes per node:         " << static_cast<double>(document.arena().GetAllocatedBytes()) / static_cast<double>(numOfNodes) << " (node and reference count)\n";
+    std::cout << "Heap bytes per node:          " << static_cast<double>(heapBytes) / static_cast<double>(numOfNodes) << " (container buffers, keys and long strings)\n";
+    std::cout << "Total bytes per node:         " << static_cast<double>(document.arena().GetAllocatedBytes() + heapBytes) / static_cast<double>(numOfNodes) << "\n";
+
+    return 0;
+}
@@ -74,15 +74,28 @@ SOFTWARE.
 #undef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdint>
 #include <cuchar>
 #include <cstring>
-#include <codecvt>
 #include <deque>
+#include <exception>
+#include <functional>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <limits>
@@ -90,13 +103,41 @@ SOFTWARE.
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <sstream>
 #include <type_traits>
+#include <unordered_map>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <variant>
 #include <vector>
 
+// Define HAVJSON_NO_SIMD to use the scalar scanner only
+#ifndef HAVJSON_NO_SIMD
+#if defined(__AVX2__)
+#define HAVJSON_SIMD_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAVJSON_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define HAVJSON_SIMD_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Nesting depth up to which the recursive descent, SAX and bound struct parsers recurse, whatever the parse options allow. Deeper
+// input fails like an exceeded depth limit instead of overflowing the stack. Define it before including the header to change it.
+#ifndef HAVJSON_MAX_RECURSION_DEPTH
+#define HAVJSON_MAX_RECURSION_DEPTH 2048
+#endif
+
 static_assert(sizeof(signed char) == 1, "expected char to be 1 byte");
 static_assert(sizeof(unsigned char) == 1, "expected unsigned char to be 1 byte");
 static_assert(sizeof(signed char) == 1, "expected int8 to be 1 byte");
@@ -126,6 +167,12 @@ namespace havJSON
         BSON
     };
 
+    enum class havJSONParserType : std::uint8_t
+    {
+        Tokenizer,       // Tokenize the whole document first, then build the tree from the tokens
+        RecursiveDescent // Build the tree directly while scanning the document
+    };
+
     enum class havJSONDataType : std::uint8_t
     {
         Null,
@@ -146,6 +193,7 @@ namespace havJSON
     {
         Double = 0x01,      // double
         String = 0x02,      // string
+        Document = 0x03,    // embedded document
         Array = 0x04,       // array: integer values as keys
         BinaryData = 0x05,  // binary data in bytes
         Boolean = 0x08,     // 0x00 = false, 0x01 = true
@@ -185,30 +233,381 @@ namespace havJSON
     {
         havJSONToken mToken;
         std::optional<std::string> mValue;
+        // Byte offset into the input past the end of the token
+        std::size_t mOffset = 0;
+    };
+
+    class havJSONData;
+
+#ifdef HAVJSON_INTERNED_KEYS
+#ifndef HAVJSON_ORDERED_OBJECTS
+#error "HAVJSON_INTERNED_KEYS requires HAVJSON_ORDERED_OBJECTS"
+#endif
+
+    // Object key that shares its characters with all equal keys taken from the same havJSONKeyTable. It converts to
+    // const std::string& and std::string_view, so it can be used like the std::string keys without HAVJSON_INTERNED_KEYS.
+    class havJSONKey
+    {
+    public:
+        havJSONKey(std::string value) : mValue(std::make_shared<const std::string>(std::move(value))) {}
+
+        explicit havJSONKey(std::shared_ptr<const std::string> value) : mValue(std::move(value)) {}
+
+        const std::string& str() const { return *mValue; }
+
+        const char* data() const { return mValue->data(); }
+        std::size_t size() const { return mValue->size(); }
+        bool empty() const { return mValue->empty(); }
+
+        operator const std::string&() const { return *mValue; }
+        operator std::string_view() const { return *mValue; }
+
+        // Note: Keys from the same table are equal if they share their characters, so the comparison of the characters is mostly skipped
+        friend bool operator==(const havJSONKey& key, const havJSONKey& otherKey) { return key.mValue == otherKey.mValue || *key.mValue == *otherKey.mValue; }
+        friend bool operator!=(const havJSONKey& key, const havJSONKey& otherKey) { return (key == otherKey) == false; }
+        friend bool operator==(const havJSONKey& key, std::string_view otherKey) { return *key.mValue == otherKey; }
+        friend bool operator!=(const havJSONKey& key, std::string_view otherKey) { return *key.mValue != otherKey; }
+        friend bool operator==(std::string_view key, const havJSONKey& otherKey) { return key == *otherKey.mValue; }
+        friend bool operator!=(std::string_view key, const havJSONKey& otherKey) { return key != *otherKey.mValue; }
+        friend bool operator<(const havJSONKey& key, const havJSONKey& otherKey) { return *key.mValue < *otherKey.mValue; }
+
+        // Note: Concatenation keeps code written against std::string keys compiling
+        friend std::string operator+(const havJSONKey& key, std::string_view otherValue) { return std::string(*key.mValue).append(otherValue); }
+        friend std::string operator+(std::string_view value, const havJSONKey& key) { return std::string(value).append(*key.mValue); }
+
+        friend std::ostream& operator<<(std::ostream& outputStream, const havJSONKey& key) { return outputStream << *key.mValue; }
+
+    private:
+        std::shared_ptr<const std::string> mValue;
     };
 
-    struct havJSONBSONTypeValue
+    // Stores every distinct key once. Keys handed out stay valid after the table is cleared or destroyed. Once the table holds
+    // maxKeys keys (or a key is longer than maxKeySize), further keys are created without being stored, so documents with
+    // unique keys can't grow the table without bounds.
+    class havJSONKeyTable
     {
-        havJSONBSONType mType;
-        int mCurrentIndex;
-        std::int32_t mTotalLength;
+    public:
+        explicit havJSONKeyTable(std::size_t maxKeys = 65536, std::size_t maxKeySize = 256) : mMaxKeys(maxKeys), mMaxKeySize(maxKeySize) {}
+
+        havJSONKey intern(std::string_view key)
+        {
+            std::unordered_map<std::string_view, std::shared_ptr<const std::string>>::const_iterator itr = mKeys.find(key);
+
+            if (itr != mKeys.end())
+            {
+                return havJSONKey(itr->second);
+            }
+
+            std::shared_ptr<const std::string> value = std::make_shared<const std::string>(key);
+
+            if (mKeys.size() < mMaxKeys && key.size() <= mMaxKeySize)
+            {
+                // Note: The view refers to the stored string, which doesn't move
+                mKeys.emplace(std::string_view(*value), value);
+            }
+
+            return havJSONKey(std::move(value));
+        }
+
+        void clear() { mKeys.clear(); }
+
+        std::size_t size() const { return mKeys.size(); }
+
+    private:
+        std::unordered_map<std::string_view, std::shared_ptr<const std::string>> mKeys;
+        std::size_t mMaxKeys;
+        std::size_t mMaxKeySize;
     };
 
-    struct havJSONBSONDataType
+    typedef havJSONKey havJSONObjectKey;
+#else
+    typedef std::string havJSONObjectKey;
+#endif
+
+    // Object storage that keeps the insertion order of its keys. Small objects are searched linearly; once an object grows past
+    // IndexThreshold keys, an open-addressing hash index over the entry positions is built and kept up to date on insert and erase.
+    // Note: Keys must not be modified through iterators, otherwise the hash index goes stale.
+    class havJSONOrderedObject
     {
-        havJSONDataType mDataType;
-        int mIndexToWriteTotalSizeTo;
-        int mArrayTotalSize;
-        std::uint16_t mCurrentArrayItemIndex;
+    public:
+        typedef havJSONObjectKey key_type;
+        typedef std::shared_ptr<havJSONData> mapped_type;
+        typedef std::pair<key_type, std::shared_ptr<havJSONData>> value_type;
+        typedef std::vector<value_type>::size_type size_type;
+        typedef std::vector<value_type>::iterator iterator;
+        typedef std::vector<value_type>::const_iterator const_iterator;
+
+        static constexpr size_type IndexThreshold = 16;
+
+        havJSONOrderedObject() = default;
+
+        havJSONOrderedObject(const havJSONOrderedObject& value) : mEntries(value.mEntries)
+        {
+            RebuildIndex();
+        }
+
+        havJSONOrderedObject(havJSONOrderedObject&& value) = default;
+
+        havJSONOrderedObject& operator=(const havJSONOrderedObject& value)
+        {
+            if (this != &value)
+            {
+                mEntries = value.mEntries;
+
+                RebuildIndex();
+            }
+
+            return *this;
+        }
+
+        havJSONOrderedObject& operator=(havJSONOrderedObject&& value) = default;
+
+        iterator begin() { return mEntries.begin(); }
+        iterator end() { return mEntries.end(); }
+        const_iterator begin() const { return mEntries.begin(); }
+        const_iterator end() const { return mEntries.end(); }
+        const_iterator cbegin() const { return mEntries.cbegin(); }
+        const_iterator cend() const { return mEntries.cend(); }
+
+        size_type size() const { return mEntries.size(); }
+        bool empty() const { return mEntries.empty(); }
+
+        void clear()
+        {
+            mEntries.clear();
+            mIndex.reset();
+        }
+
+        void reserve(size_type count)
+        {
+            mEntries.reserve(count);
+        }
+
+        iterator find(std::string_view key)
+        {
+            return mEntries.begin() + FindPosition(key);
+        }
+
+        const_iterator find(std::string_view key) const
+        {
+            return mEntries.begin() + FindPosition(key);
+        }
+
+        size_type count(std::string_view key) const
+        {
+            return (FindPosition(key) != mEntries.size()) ? 1 : 0;
+        }
+
+        // Like std::map, an existing key is left untouched
+        std::pair<iterator, bool> insert(value_type value)
+        {
+            size_type position = FindPosition(value.first);
+
+            if (position != mEntries.size())
+            {
+                return { mEntries.begin() + position, false };
+            }
+
+            mEntries.push_back(std::move(value));
+
+            if (mIndex != nullptr)
+            {
+                if ((mEntries.size() * 2) > GetIndexCapacity())
+                {
+                    RebuildIndex();
+                }
+                else
+                {
+                    AddToIndex(mEntries.size() - 1);
+                }
+            }
+            else if (mEntries.size() > IndexThreshold)
+            {
+                RebuildIndex();
+            }
+
+            return { mEntries.end() - 1, true };
+        }
+
+        iterator erase(const_iterator itr)
+        {
+            if (mIndex != nullptr)
+            {
+                RemoveFromIndex(static_cast<size_type>(itr - mEntries.cbegin()));
+            }
+
+            return mEntries.erase(itr);
+        }
+
+        size_type erase(std::string_view key)
+        {
+            size_type position = FindPosition(key);
+
+            if (position == mEntries.size())
+            {
+                return 0;
+            }
+
+            erase(mEntries.begin() + position);
+
+            return 1;
+        }
+
+        mapped_type& operator[](const std::string& key)
+        {
+            return (*insert({ key, nullptr }).first).second;
+        }
+
+        bool operator==(const havJSONOrderedObject& value) const { return mEntries == value.mEntries; }
+        bool operator!=(const havJSONOrderedObject& value) const { return mEntries != value.mEntries; }
+
+    private:
+        // Note: KeyType is std::string_view for lookups and key_type on insert, which lets interned keys be compared by address first
+        template<typename KeyType>
+        size_type FindPosition(const KeyType& key) const
+        {
+            if (mIndex == nullptr)
+            {
+                for (size_type position = 0; position < mEntries.size(); ++position)
+                {
+                    if (mEntries[position].first == key)
+                    {
+                        return position;
+                    }
+                }
+
+                return mEntries.size();
+            }
+
+            const std::uint32_t* slots = mIndex.get() + 1;
+
+            std::size_t mask = GetIndexCapacity() - 1;
+
+            for (std::size_t slot = std::hash<std::string_view>()(std::string_view(key)) & mask; slots[slot] != 0; slot = (slot + 1) & mask)
+            {
+                // Note: Slots store the entry position plus one, so zero marks an empty slot
+                size_type position = slots[slot] - 1;
+
+                if (mEntries[position].first == key)
+                {
+                    return position;
+                }
+            }
+
+            return mEntries.size();
+        }
+
+        void AddToIndex(size_type position)
+        {
+            std::uint32_t* slots = mIndex.get() + 1;
+
+            std::size_t mask = GetIndexCapacity() - 1;
+
+            std::size_t slot = std::hash<std::string_view>()(std::string_view(mEntries[position].first)) & mask;
+
+            while (slots[slot] != 0)
+            {
+                slot = (slot + 1) & mask;
+            }
+
+            slots[slot] = static_cast<std::uint32_t>(position + 1);
+        }
+
+        // Note: Has to be called before the entry is erased, since its key is needed to find its slot
+        void RemoveFromIndex(size_type position)
+        {
+            std::uint32_t* slots = mIndex.get() + 1;
+
+            std::size_t mask = GetIndexCapacity() - 1;
+
+            std::size_t hole = std::hash<std::string_view>()(std::string_view(mEntries[position].first)) & mask;
+
+            while (slots[hole] != position + 1)
+            {
+                hole = (hole + 1) & mask;
+            }
+
+            // 1. Close the hole by moving back the following slots of the probe sequence that can't be found past it otherwise
+            for (std::size_t slot = (hole + 1) & mask; slots[slot] != 0; slot = (slot + 1) & mask)
+            {
+                std::size_t homeSlot = std::hash<std::string_view>()(std::string_view(mEntries[slots[slot] - 1].first)) & mask;
+
+                if (((slot - homeSlot) & mask) >= ((slot - hole) & mask))
+                {
+                    slots[hole] = slots[slot];
+                    hole = slot;
+                }
+            }
+
+            slots[hole] = 0;
+
+            // 2. Erasing shifts the positions of all following entries down by one
+            if (position + 1 < mEntries.size())
+            {
+                std::uint32_t erasedSlotValue = static_cast<std::uint32_t>(position + 1);
+
+                // Note: Without a branch, so the loop is vectorized
+                for (std::size_t slot = 0; slot <= mask; ++slot)
+                {
+                    slots[slot] -= static_cast<std::uint32_t>(slots[slot] > erasedSlotValue);
+                }
+            }
+        }
+
+        void RebuildIndex()
+        {
+            mIndex.reset();
+
+            if (mEntries.size() <= IndexThreshold)
+            {
+                return;
+            }
+
+            // Keep the load factor at or below one half
+            std::size_t capacity = 64;
+
+            while (capacity < mEntries.size() * 4)
+            {
+                capacity *= 2;
+            }
+
+            // The first element holds the capacity, so an object without an index only pays for one pointer
+            mIndex.reset(new std::uint32_t[capacity + 1]());
+            mIndex[0] = static_cast<std::uint32_t>(capacity);
+
+            for (size_type position = 0; position < mEntries.size(); ++position)
+            {
+                AddToIndex(position);
+            }
+        }
+
+        std::size_t GetIndexCapacity() const { return mIndex[0]; }
+
+        std::vector<value_type> mEntries;
+        std::unique_ptr<std::uint32_t[]> mIndex;
     };
 
+    // Define HAVJSON_ORDERED_OBJECTS to store objects in a havJSONOrderedObject (insertion order) instead of a std::map (sorted keys)
+#ifdef HAVJSON_ORDERED_OBJECTS
+    typedef havJSONOrderedObject havJSONObject;
+#else
+    typedef std::map<std::string, std::shared_ptr<havJSONData>> havJSONObject;
+#endif
+
     class havJSONData
     {
     public:
-        typedef std::variant<bool, int, unsigned int, long, unsigned long, std::int64_t, std::uint64_t, double, const char*, std::string, std::vector<std::shared_ptr<havJSONData>>, std::map<std::string, std::shared_ptr<havJSONData>>> havJSONVariant;
+        typedef std::variant<std::monostate, bool, int, unsigned int, long, unsigned long, long long, unsigned long long, double, const char*, std::string, std::vector<std::shared_ptr<havJSONData>>, havJSONObject> havJSONVariant;
 
-        explicit havJSONData(const havJSONVariant& value, havJSONDataType valueType) : mType(valueType), mValue(std::move(value))
+        // Note: The type follows the stored value; valueType only matters for null values
+        explicit havJSONData(const havJSONVariant& value, havJSONDataType valueType) : mValue(value)
         {
+            NormalizeValue(valueType);
+        }
+
+        explicit havJSONData(havJSONVariant&& value, havJSONDataType valueType) : mValue(std::move(value))
+        {
+            NormalizeValue(valueType);
         }
 
         explicit havJSONData(havJSONDataType valueType = havJSONDataType::Null)
@@ -216,7 +615,7 @@ namespace havJSON
             switch (valueType)
             {
                 case havJSONDataType::Null:
-                    setValue<std::string>(std::string("null"), havJSONDataType::Null);
+                    setValue<std::monostate>(std::monostate(), havJSONDataType::Null);
                     break;
 
                 case havJSONDataType::Boolean:
@@ -240,11 +639,11 @@ namespace havJSON
                     break;
 
                 case havJSONDataType::Int64:
-                    setValue<std::int64_t>(0, havJSONDataType::Int64);
+                    setValue<long long>(0, havJSONDataType::Int64);
                     break;
 
                 case havJSONDataType::UInt64:
-                    setValue<std::uint64_t>(0, havJSONDataType::UInt64);
+                    setValue<unsigned long long>(0, havJSONDataType::UInt64);
                     break;
 
                 case havJSONDataType::Double:
@@ -264,8 +663,8 @@ namespace havJSON
 
                 case havJSONDataType::Object:
                     {
-                        std::map<std::string, std::shared_ptr<havJSONData>> tmpObject;
-                        setValue<std::map<std::string, std::shared_ptr<havJSONData>>>(std::move(tmpObject), havJSONDataType::Object);
+                        havJSONObject tmpObject;
+                        setValue<havJSONObject>(std::move(tmpObject), havJSONDataType::Object);
                     }
                     break;
 
@@ -274,11 +673,11 @@ namespace havJSON
             }
         }
 
-        explicit havJSONData(havJSONData&& value) : mType(value.mType), mValue(std::move(value.mValue))
+        explicit havJSONData(havJSONData&& value) : mValue(std::move(value.mValue))
         {
         }
 
-        explicit havJSONData(const havJSONData& value) : mType(value.mType), mValue(value.mValue)
+        explicit havJSONData(const havJSONData& value) : mValue(value.mValue)
         {
         }
 
@@ -287,16 +686,15 @@ namespace havJSON
         explicit havJSONData(unsigned int value) { setValue<unsigned int>(value, havJSONDataType::UInt); }
         explicit havJSONData(long value) { setValue<long>(value, havJSONDataType::Long); }
         explicit havJSONData(unsigned long value) { setValue<unsigned long>(value, havJSONDataType::ULong); }
-        explicit havJSONData(std::int64_t value) { setValue<std::int64_t>(value, havJSONDataType::Int64); }
-        explicit havJSONData(std::uint64_t value) { setValue<std::uint64_t>(value, havJSONDataType::UInt64); }
+        explicit havJSONData(long long value) { setValue<long long>(value, havJSONDataType::Int64); }
+        explicit havJSONData(unsigned long long value) { setValue<unsigned long long>(value, havJSONDataType::UInt64); }
         explicit havJSONData(double value) { setValue<double>(value, havJSONDataType::Double); }
         explicit havJSONData(const char* value) { setValue<std::string>(std::string(value), havJSONDataType::String); }
         explicit havJSONData(const std::string& value) { setValue<std::string>(value, havJSONDataType::String); }
 
         havJSONData& operator=(havJSONData&& value)
         {
-            mValue = value.mValue;
-            mType = value.mType;
+            mValue = std::move(value.mValue);
 
             return *this;
         }
@@ -306,7 +704,6 @@ namespace havJSON
             if (this != &value)
             {
                 mValue = value.mValue;
-                mType = value.mType;
             }
 
             return *this;
@@ -314,269 +711,167 @@ namespace havJSON
 
         void operator=(const havJSONVariant& value)
         {
-            if (std::holds_alternative<bool>(value))
-            {
-                mType = havJSONDataType::Boolean;
-            }
-            else if (std::holds_alternative<int>(value))
-            {
-                mType = havJSONDataType::Int;
-            }
-            else if (std::holds_alternative<unsigned int>(value))
-            {
-                mType = havJSONDataType::UInt;
-            }
-            else if (std::holds_alternative<long>(value))
-            {
-                mType = havJSONDataType::Long;
-            }
-            else if (std::holds_alternative<unsigned long>(value))
-            {
-                mType = havJSONDataType::ULong;
-            }
-            else if (std::holds_alternative<std::int64_t>(value))
-            {
-                mType = havJSONDataType::Int64;
-            }
-            else if (std::holds_alternative<std::uint64_t>(value))
-            {
-                mType = havJSONDataType::UInt64;
-            }
-            else if (std::holds_alternative<double>(value))
-            {
-                mType = havJSONDataType::Double;
-            }
-            else if (std::holds_alternative<const char*>(value))
-            {
-                mType = havJSONDataType::String;
-                mValue = std::string(std::get<const char*>(value));
-                return;
-            }
-            else if (std::holds_alternative<std::string>(value))
-            {
-                mType = havJSONDataType::String;
-            }
-            else
+            if (std::holds_alternative<std::vector<std::shared_ptr<havJSONData>>>(value) ||
+                std::holds_alternative<havJSONObject>(value))
             {
                 throw std::runtime_error("Unsupported type!");
             }
 
             mValue = value;
+
+            NormalizeValue(getType());
         }
 
         havJSONVariant* getAddress() { return &mValue; }
 
         havJSONVariant getValue() const { return mValue; }
 
-        havJSONDataType getType() const { return mType; }
-
-        bool isArray() { return mType == havJSONDataType::Array; }
-        bool isObject() { return mType == havJSONDataType::Object; }
-        bool isNull() { return mType == havJSONDataType::Null; }
-        bool isBoolean() { return mType == havJSONDataType::Boolean; }
-        bool isInt() { return mType == havJSONDataType::Int; }
-        bool isUInt() { return mType == havJSONDataType::UInt; }
-        bool isLong() { return mType == havJSONDataType::Long; }
-        bool isULong() { return mType == havJSONDataType::ULong; }
-        bool isInt64() { return mType == havJSONDataType::Int64; }
-        bool isUInt64() { return mType == havJSONDataType::UInt64; }
-        bool isDouble() { return mType == havJSONDataType::Double; }
-        bool isString() { return mType == havJSONDataType::String; }
+        // Unlike getValue, this doesn't copy the value (and with it, the whole subtree of arrays and objects)
+        const havJSONVariant& getValueRef() const { return mValue; }
 
-        template<typename T>
-        T convertTo(bool explicitCast, T defaultValue)
+        havJSONDataType getType() const
         {
-            if (explicitCast == false)
+            // Indexed by the alternatives of havJSONVariant
+            static constexpr havJSONDataType types[] =
             {
-                if constexpr (std::is_same_v<T, bool> == true)
-                {
-                    bool value;
-
-                    std::stringstream(toString()) >> std::boolalpha >> value;
-
-                    return value;
-                }
+                havJSONDataType::Null, havJSONDataType::Boolean, havJSONDataType::Int, havJSONDataType::UInt, havJSONDataType::Long, havJSONDataType::ULong,
+                havJSONDataType::Int64, havJSONDataType::UInt64, havJSONDataType::Double, havJSONDataType::String, havJSONDataType::String, havJSONDataType::Array,
+                havJSONDataType::Object
+            };
 
-                std::string::size_type idx;
+            static_assert(sizeof(types) / sizeof(types[0]) == std::variant_size_v<havJSONVariant>, "Type table doesn't match havJSONVariant!");
 
-                std::string value = toString();
+            return types[mValue.index()];
+        }
 
-                if constexpr (std::is_same_v<T, int> == true)
-                {
-                    return std::stoi(value, &idx);
-                }
-                else if constexpr (std::is_same_v<T, unsigned int> == true)
-                {
-                    return std::stoul(value, &idx);
-                }
-                else if constexpr (std::is_same_v<T, long> == true)
-                {
-                    return std::stol(value, &idx);
-                }
-                else if constexpr (std::is_same_v<T, unsigned long> == true)
-                {
-                    return std::stoul(value, &idx);
-                }
-                else if constexpr (std::is_same_v<T, std::int64_t> == true)
-                {
-                    return std::stoll(value, &idx);
-                }
-                else if constexpr (std::is_same_v<T, std::uint64_t> == true)
-                {
-                    return std::stoull(value, &idx);
-                }
-                else if constexpr (std::is_same_v<T, double> == true)
-                {
-                    return std::stod(value, &idx);
-                }
-                else
-                {
-                    throw std::runtime_error("Unsupported type!");
-                }
+        bool isArray() const { return getType() == havJSONDataType::Array; }
+        bool isObject() const { return getType() == havJSONDataType::Object; }
+        bool isNull() const { return getType() == havJSONDataType::Null; }
+        bool isBoolean() const { return getType() == havJSONDataType::Boolean; }
+        bool isInt() const { return getType() == havJSONDataType::Int; }
+        bool isUInt() const { return getType() == havJSONDataType::UInt; }
+        bool isLong() const { return getType() == havJSONDataType::Long; }
+        bool isULong() const { return getType() == havJSONDataType::ULong; }
+        bool isInt64() const { return getType() == havJSONDataType::Int64; }
+        bool isUInt64() const { return getType() == havJSONDataType::UInt64; }
+        bool isDouble() const { return getType() == havJSONDataType::Double; }
+        bool isString() const { return getType() == havJSONDataType::String; }
+
+        // Returns the stored value if it has type T. Otherwise, explicitCast decides: If true, defaultValue is returned. If false,
+        // numbers and booleans are converted to T (out of range values throw std::out_of_range) and strings are parsed. Null
+        // returns defaultValue for bool and throws std::invalid_argument for numbers.
+        template<typename T>
+        T convertTo(bool explicitCast, T defaultValue) const
+        {
+            if (const T* value = std::get_if<T>(&mValue))
+            {
+                return *value;
             }
 
-            try
+            if (explicitCast == true)
             {
-                return std::get<T>(mValue);
-            }
-            catch (const std::bad_variant_access& e)
-            {
-                return defaultValue;
+                return defaultValue;
             }
+
+            return std::visit([&](const auto& value) { return ConvertValue<T>(value, defaultValue); }, mValue);
         }
 
-        bool toBoolean(bool explicitCast = false, bool defaultValue = false)
+        bool toBoolean(bool explicitCast = false, bool defaultValue = false) const
         {
             return convertTo<bool>(explicitCast, defaultValue);
         }
 
-        int toInt(bool explicitCast = false, int defaultValue = 0)
+        int toInt(bool explicitCast = false, int defaultValue = 0) const
         {
             return convertTo<int>(explicitCast, defaultValue);
         }
 
-        unsigned int toUInt(bool explicitCast = false, unsigned int defaultValue = 0)
+        unsigned int toUInt(bool explicitCast = false, unsigned int defaultValue = 0) const
         {
             return convertTo<unsigned int>(explicitCast, defaultValue);
         }
 
-        long toLong(bool explicitCast = false, long defaultValue = 0)
+        long toLong(bool explicitCast = false, long defaultValue = 0) const
         {
             return convertTo<long>(explicitCast, defaultValue);
         }
 
-        unsigned long toULong(bool explicitCast = false, unsigned long defaultValue = 0)
+        unsigned long toULong(bool explicitCast = false, unsigned long defaultValue = 0) const
         {
             return convertTo<unsigned long>(explicitCast, defaultValue);
         }
 
-        std::int64_t toInt64(bool explicitCast = false, std::int64_t defaultValue = 0)
+        long long toInt64(bool explicitCast = false, long long defaultValue = 0) const
         {
-            return convertTo<std::int64_t>(explicitCast, defaultValue);
+            return convertTo<long long>(explicitCast, defaultValue);
         }
 
-        std::uint64_t toUInt64(bool explicitCast = false, std::uint64_t defaultValue = 0)
+        unsigned long long toUInt64(bool explicitCast = false, unsigned long long defaultValue = 0) const
         {
-            return convertTo<std::uint64_t>(explicitCast, defaultValue);
+            return convertTo<unsigned long long>(explicitCast, defaultValue);
         }
 
-        double toDouble(bool explicitCast = false, double defaultValue = 0.0)
+        double toDouble(bool explicitCast = false, double defaultValue = 0.0) const
         {
             return convertTo<double>(explicitCast, defaultValue);
         }
 
-        std::string toString()
+        std::string toString() const
         {
-            switch (mType)
+            switch (getType())
             {
-                case havJSONDataType::Null: return dataToString<std::string>();
-                case havJSONDataType::Boolean: return dataToString<bool>();
+                case havJSONDataType::Null: return "null";
+                case havJSONDataType::Boolean: return (std::get<bool>(mValue) == true) ? "true" : "false";
                 case havJSONDataType::Int: return dataToString<int>();
                 case havJSONDataType::UInt: return dataToString<unsigned int>();
                 case havJSONDataType::Long: return dataToString<long>();
                 case havJSONDataType::ULong: return dataToString<unsigned long>();
-                case havJSONDataType::Int64: return dataToString<std::int64_t>();
-                case havJSONDataType::UInt64: return dataToString<std::uint64_t>();
+                case havJSONDataType::Int64: return dataToString<long long>();
+                case havJSONDataType::UInt64: return dataToString<unsigned long long>();
                 case havJSONDataType::Double: return dataToString<double>();
-                case havJSONDataType::String: return dataToString<std::string>();
+                case havJSONDataType::String: return std::get<std::string>(mValue);
                 default: throw std::runtime_error("Unsupported type!");
             }
 
             return std::string();
         }
 
-        havJSONData& operator[](int index)
-        {
-            if (mType != havJSONDataType::Array)
-            {
-                throw std::runtime_error("Value is not an array!");
-            }
-
-            auto value = std::get<std::vector<std::shared_ptr<havJSONData>>>(mValue);
-
-            return *value[index].get();
-        }
-
-        havJSONData& operator[](const char* key)
-        {
-            if (mType != havJSONDataType::Object)
-            {
-                throw std::runtime_error("Value is not an object!");
-            }
-
-            auto value = std::get<std::map<std::string, std::shared_ptr<havJSONData>>>(mValue);
-
-            if (value.find(key) == value.end())
-            {
-                throw std::runtime_error("Key was not found in object!");
-            }
-
-            return *value[key].get();
-        }
-
-        havJSONData& operator[](const std::string& key)
-        {
-            if (mType != havJSONDataType::Object)
-            {
-                throw std::runtime_error("Value is not an object!");
-            }
+        // Note: Element access returns references into the container, so it doesn't copy the container or its children
+        havJSONData& operator[](int index) { return GetElement(index); }
+        const havJSONData& operator[](int index) const { return GetElement(index); }
 
-            auto value = std::get<std::map<std::string, std::shared_ptr<havJSONData>>>(mValue);
-
-            if (value.find(key) == value.end())
-            {
-                throw std::runtime_error("Key was not found in object!");
-            }
+        havJSONData& operator[](const char* key) { return GetMember(key); }
+        const havJSONData& operator[](const char* key) const { return GetMember(key); }
 
-            return *value[key].get();
-        }
+        havJSONData& operator[](const std::string& key) { return GetMember(key); }
+        const havJSONData& operator[](const std::string& key) const { return GetMember(key); }
 
         // Array & Object
         void clear()
         {
-            if (mType == havJSONDataType::Array)
+            if (getType() == havJSONDataType::Array)
             {
                 std::get<std::vector<std::shared_ptr<havJSONData>>>(mValue).clear();
             }
 
-            if (mType == havJSONDataType::Object)
+            if (getType() == havJSONDataType::Object)
             {
-                std::get<std::map<std::string, std::shared_ptr<havJSONData>>>(mValue).clear();
+                std::get<havJSONObject>(mValue).clear();
             }
 
             throw std::runtime_error("Value is not an array or object!");
         }
 
-        bool empty()
+        bool empty() const
         {
-            if (mType == havJSONDataType::Array)
+            if (getType() == havJSONDataType::Array)
             {
                 return std::get<std::vector<std::shared_ptr<havJSONData>>>(mValue).empty();
             }
 
-            if (mType == havJSONDataType::Object)
+            if (getType() == havJSONDataType::Object)
             {
-                return std::get<std::map<std::string, std::shared_ptr<havJSONData>>>(mValue).empty();
+                return std::get<havJSONObject>(mValue).empty();
             }
 
             throw std::runtime_error("Value is not an array or object!");
@@ -585,7 +880,7 @@ namespace havJSON
         // Array
         void erase(std::vector<std::shared_ptr<havJSONData>>::iterator itr)
         {
-            if (mType == havJSONDataType::Array)
+            if (getType() == havJSONDataType::Array)
             {
                 std::get<std::vector<std::shared_ptr<havJSONData>>>(mValue).erase(itr);
 
@@ -597,7 +892,7 @@ namespace havJSON
 
         std::vector<std::shared_ptr<havJSONData>>::iterator arrayBegin()
         {
-            if (mType == havJSONDataType::Array)
+            if (getType() == havJSONDataType::Array)
             {
                 return std::get<std::vector<std::shared_ptr<havJSONData>>>(mValue).begin();
             }
@@ -607,7 +902,7 @@ namespace havJSON
 
         std::vector<std::shared_ptr<havJSONData>>::iterator arrayEnd()
         {
-            if (mType == havJSONDataType::Array)
+            if (getType() == havJSONDataType::Array)
             {
                 return std::get<std::vector<std::shared_ptr<havJSONData>>>(mValue).end();
             }
@@ -619,7 +914,7 @@ namespace havJSON
         {
             try
             {
-                if (mType != havJSONDataType::Array)
+                if (getType() != havJSONDataType::Array)
                 {
                     throw std::runtime_error("Value is not an array!");
                 }
@@ -638,7 +933,7 @@ namespace havJSON
         {
             try
             {
-                if (mType != havJSONDataType::Array)
+                if (getType() != havJSONDataType::Array)
                 {
                     throw std::runtime_error("Value is not an array!");
                 }
@@ -655,7 +950,7 @@ namespace havJSON
 
         void insert(int index, std::shared_ptr<havJSONData> newValue)
         {
-            if (mType == havJSONDataType::Array)
+            if (getType() == havJSONDataType::Array)
             {
                 auto itr = std::get<std::vector<std::shared_ptr<havJSONData>>>(mValue).begin();
 
@@ -669,7 +964,7 @@ namespace havJSON
 
         void push_back(std::shared_ptr<havJSONData> newValue)
         {
-            if (mType == havJSONDataType::Array)
+            if (getType() == havJSONDataType::Array)
             {
                 std::get<std::vector<std::shared_ptr<havJSONData>>>(mValue).push_back(std::move(newValue));
 
@@ -681,7 +976,7 @@ namespace havJSON
 
         void push_front(std::shared_ptr<havJSONData> newValue)
         {
-            if (mType == havJSONDataType::Array)
+            if (getType() == havJSONDataType::Array)
             {
                 auto itr = std::get<std::vector<std::shared_ptr<havJSONData>>>(mValue).begin();
 
@@ -695,7 +990,7 @@ namespace havJSON
 
         void pop_back()
         {
-            if (mType == havJSONDataType::Array)
+            if (getType() == havJSONDataType::Array)
             {
                 std::get<std::vector<std::shared_ptr<havJSONData>>>(mValue).pop_back();
 
@@ -707,7 +1002,7 @@ namespace havJSON
 
         void pop_front()
         {
-            if (mType == havJSONDataType::Array)
+            if (getType() == havJSONDataType::Array)
             {
                 auto itr = std::get<std::vector<std::shared_ptr<havJSONData>>>(mValue).begin();
 
@@ -721,7 +1016,7 @@ namespace havJSON
 
         void remove(int index)
         {
-            if (mType == havJSONDataType::Array)
+            if (getType() == havJSONDataType::Array)
             {
                 auto itr = std::get<std::vector<std::shared_ptr<havJSONData>>>(mValue).begin();
 
@@ -733,11 +1028,11 @@ namespace havJSON
             throw std::runtime_error("Value is not an array!");
         }
 
-        bool contains(std::shared_ptr<havJSONData> newValue)
+        bool contains(const std::shared_ptr<havJSONData>& newValue) const
         {
-            if (mType == havJSONDataType::Array)
+            if (getType() == havJSONDataType::Array)
             {
-                auto value = std::get<std::vector<std::shared_ptr<havJSONData>>>(mValue);
+                const std::vector<std::shared_ptr<havJSONData>>& value = std::get<std::vector<std::shared_ptr<havJSONData>>>(mValue);
 
                 return std::find(value.begin(), value.end(), newValue) != value.end();
             }
@@ -749,7 +1044,7 @@ namespace havJSON
         {
             try
             {
-                if (mType != havJSONDataType::Array)
+                if (getType() != havJSONDataType::Array)
                 {
                     throw std::runtime_error("Value is not an array!");
                 }
@@ -764,9 +1059,9 @@ namespace havJSON
             }
         }
 
-        std::vector<std::shared_ptr<havJSONData>>::size_type arraySize()
+        std::vector<std::shared_ptr<havJSONData>>::size_type arraySize() const
         {
-            if (mType == havJSONDataType::Array)
+            if (getType() == havJSONDataType::Array)
             {
                 return std::get<std::vector<std::shared_ptr<havJSONData>>>(mValue).size();
             }
@@ -775,21 +1070,21 @@ namespace havJSON
         }
 
         // Object
-        std::map<std::string, std::shared_ptr<havJSONData>>::iterator objectBegin()
+        havJSONObject::iterator objectBegin()
         {
-            if (mType == havJSONDataType::Object)
+            if (getType() == havJSONDataType::Object)
             {
-                return std::get<std::map<std::string, std::shared_ptr<havJSONData>>>(mValue).begin();
+                return std::get<havJSONObject>(mValue).begin();
             }
 
             throw std::runtime_error("Value is not an object!");
         }
 
-        std::map<std::string, std::shared_ptr<havJSONData>>::iterator objectEnd()
+        havJSONObject::iterator objectEnd()
         {
-            if (mType == havJSONDataType::Object)
+            if (getType() == havJSONDataType::Object)
             {
-                return std::get<std::map<std::string, std::shared_ptr<havJSONData>>>(mValue).end();
+                return std::get<havJSONObject>(mValue).end();
             }
 
             throw std::runtime_error("Value is not an object!");
@@ -797,9 +1092,9 @@ namespace havJSON
 
         void insert(std::string key, std::shared_ptr<havJSONData> newValue)
         {
-            if (mType == havJSONDataType::Object)
+            if (getType() == havJSONDataType::Object)
             {
-                std::get<std::map<std::string, std::shared_ptr<havJSONData>>>(mValue).insert({key, std::move(newValue)});
+                std::get<havJSONObject>(mValue).insert({key, std::move(newValue)});
 
                 return;
             }
@@ -807,11 +1102,11 @@ namespace havJSON
             throw std::runtime_error("Value is not an object!");
         }
 
-        void erase(std::map<std::string, std::shared_ptr<havJSONData>>::iterator itr)
+        void erase(havJSONObject::iterator itr)
         {
-            if (mType == havJSONDataType::Object)
+            if (getType() == havJSONDataType::Object)
             {
-                std::get<std::map<std::string, std::shared_ptr<havJSONData>>>(mValue).erase(itr);
+                std::get<havJSONObject>(mValue).erase(itr);
 
                 return;
             }
@@ -821,19 +1116,19 @@ namespace havJSON
 
         havJSONData& find(const std::string& key)
         {
-            if (mType != havJSONDataType::Object)
+            if (getType() != havJSONDataType::Object)
             {
                 throw std::runtime_error("Value is not an object!");
             }
 
-            return *std::get<std::map<std::string, std::shared_ptr<havJSONData>>>(mValue).find(key)->second.get();
+            return *std::get<havJSONObject>(mValue).find(key)->second.get();
         }
 
         void remove(const std::string& key)
         {
-            if (mType == havJSONDataType::Object)
+            if (getType() == havJSONDataType::Object)
             {
-                auto value = std::get<std::map<std::string, std::shared_ptr<havJSONData>>>(mValue);
+                havJSONObject& value = std::get<havJSONObject>(mValue);
 
                 auto itr = value.find(key);
 
@@ -848,11 +1143,11 @@ namespace havJSON
             throw std::runtime_error("Value is not an object!");
         }
 
-        bool contains(const std::string& key)
+        bool contains(const std::string& key) const
         {
-            if (mType == havJSONDataType::Object)
+            if (getType() == havJSONDataType::Object)
             {
-                auto value = std::get<std::map<std::string, std::shared_ptr<havJSONData>>>(mValue);
+                const havJSONObject& value = std::get<havJSONObject>(mValue);
 
                 return value.find(key) != value.end();
             }
@@ -860,11 +1155,11 @@ namespace havJSON
             throw std::runtime_error("Value is not an object!");
         }
 
-        std::map<std::string, std::shared_ptr<havJSONData>>::size_type objectSize()
+        havJSONObject::size_type objectSize() const
         {
-            if (mType == havJSONDataType::Object)
+            if (getType() == havJSONDataType::Object)
             {
-                return std::get<std::map<std::string, std::shared_ptr<havJSONData>>>(mValue).size();
+                return std::get<havJSONObject>(mValue).size();
             }
 
             throw std::runtime_error("Value is not an object!");
@@ -872,3816 +1167,9975 @@ namespace havJSON
 
     private:
         template<typename T>
-        void setValue(const T& value, havJSONDataType valueType)
+        void setValue(const T& value, havJSONDataType /*valueType*/)
         {
-            mType = valueType;
             mValue = value;
         }
 
-        template<typename T>
-        std::string dataToString()
+        void NormalizeValue(havJSONDataType valueType)
         {
-            auto dataRef = std::get<T>(mValue);
-
-            std::ostringstream out;
-
-            out << dataRef;
+            // Null was stored as the string "null" in earlier versions
+            if (valueType == havJSONDataType::Null)
+            {
+                mValue = std::monostate();
+            }
+            else if (std::holds_alternative<const char*>(mValue))
+            {
+                mValue = std::string(std::get<const char*>(mValue));
+            }
+        }
 
-            std::string result = out.str();
+        havJSONData& GetElement(int index) const
+        {
+            const std::vector<std::shared_ptr<havJSONData>>* value = std::get_if<std::vector<std::shared_ptr<havJSONData>>>(&mValue);
 
-            if constexpr (std::is_same_v<T, bool> == true)
+            if (value == nullptr)
             {
-                if (result == "1")
-                {
-                    return "true";
-                }
-
-                return "false";
+                throw std::runtime_error("Value is not an array!");
             }
 
-            return result;
+            return *(*value)[index];
         }
 
-        havJSONDataType mType;
-        havJSONVariant mValue;
-    };
-
-    class havJSONStream
-    {
-    public:
-        havJSONStream() {}
-        ~havJSONStream() {}
-
-        bool SkipWhitespaces(char currentChar, bool ignoreSpace)
+        template<typename KeyType>
+        havJSONData& GetMember(const KeyType& key) const
         {
-            if (ignoreSpace == false)
+            const havJSONObject* value = std::get_if<havJSONObject>(&mValue);
+
+            if (value == nullptr)
             {
-                if (currentChar == ' ')
-                {
-                    return true;
-                }
+                throw std::runtime_error("Value is not an object!");
             }
 
-            if (currentChar == '\\' || currentChar == '/' || currentChar == '\b' || currentChar == '\f' ||
-                currentChar == '\n' || currentChar == '\r' || currentChar == '\t' || currentChar == '\v')
+            // Note: Looked up only once
+            havJSONObject::const_iterator itr = value->find(key);
+
+            if (itr == value->end())
             {
-                return true;
+                throw std::runtime_error("Key was not found in object!");
             }
 
-            return false;
+            return *itr->second;
         }
 
-        havJSONToken CheckToken(char currentChar)
+        template<typename T, typename ValueType>
+        static T ConvertValue(const ValueType& value, T defaultValue)
         {
-            switch (currentChar)
+            if constexpr (std::is_same_v<ValueType, std::string> == true)
             {
-                case '[': return havJSONToken::LeftSquareBracket;
-                case '{': return havJSONToken::LeftCurlyBracket;
-                case ']': return havJSONToken::RightSquareBracket;
-                case '}': return havJSONToken::RightCurlyBracket;
-                case ':': return havJSONToken::Colon;
-                case ',': return havJSONToken::Comma;
-                default: return havJSONToken::None;
+                std::string::size_type idx;
+
+                if constexpr (std::is_same_v<T, bool> == true)
+                {
+                    if (value == "true" || value == "false")
+                    {
+                        return value == "true";
+                    }
+
+                    return defaultValue;
+                }
+                else if constexpr (std::is_same_v<T, int> == true)
+                {
+                    return std::stoi(value, &idx);
+                }
+                else if constexpr (std::is_same_v<T, unsigned int> == true)
+                {
+                    return std::stoul(value, &idx);
+                }
+                else if constexpr (std::is_same_v<T, long> == true)
+                {
+                    return std::stol(value, &idx);
+                }
+                else if constexpr (std::is_same_v<T, unsigned long> == true)
+                {
+                    return std::stoul(value, &idx);
+                }
+                else if constexpr (std::is_same_v<T, long long> == true)
+                {
+                    return std::stoll(value, &idx);
+                }
+                else if constexpr (std::is_same_v<T, unsigned long long> == true)
+                {
+                    return std::stoull(value, &idx);
+                }
+                else if constexpr (std::is_same_v<T, double> == true)
+                {
+                    return std::stod(value, &idx);
+                }
+                else
+                {
+                    throw std::runtime_error("Unsupported type!");
+                }
             }
-        }
+            else if constexpr (std::is_same_v<ValueType, const char*> == true)
+            {
+                return ConvertValue<T>(std::string(value), defaultValue);
+            }
+            else if constexpr (std::is_arithmetic_v<ValueType> == true)
+            {
+                if constexpr (std::is_same_v<T, bool> == true)
+                {
+                    return value != 0;
+                }
+                else if constexpr (std::is_floating_point_v<T> == true || std::is_same_v<ValueType, bool> == true)
+                {
+                    return static_cast<T>(value);
+                }
+                else
+                {
+                    if (IsInRange<T>(value) == false)
+                    {
+                        throw std::out_of_range("Value is out of range!");
+                    }
 
-        char GetTokenAsCharacter(havJSONToken currentToken)
-        {
-            switch (currentToken)
+                    return static_cast<T>(value);
+                }
+            }
+            else if constexpr (std::is_same_v<ValueType, std::monostate> == true)
             {
-                case havJSONToken::LeftSquareBracket: return '[';
-                case havJSONToken::LeftCurlyBracket: return '{';
-                case havJSONToken::RightSquareBracket: return ']';
-                case havJSONToken::RightCurlyBracket: return '}';
-                case havJSONToken::Colon: return ':';
-                case havJSONToken::Comma: return ',';
-                default: return '\0';
+                // Note: As in earlier versions, toBoolean returns defaultValue for null, while the number getters throw
+                if constexpr (std::is_same_v<T, bool> == true)
+                {
+                    return defaultValue;
+                }
+                else
+                {
+                    throw std::invalid_argument("Value is null!");
+                }
+            }
+            else
+            {
+                throw std::runtime_error("Unsupported type!");
             }
         }
 
-        std::string CodePointToString(const unsigned int codePoint)
+        // Checks whether the number fits into the integral type T. The fractional part of floating point values is ignored.
+        template<typename T, typename ValueType>
+        static bool IsInRange(ValueType value)
         {
-            // Note: null-terminated string
-            char value[5] = { '\0' };
-
-            if (codePoint < 0x80)
+            if constexpr (std::is_floating_point_v<ValueType> == true)
             {
-                value[0] = codePoint;
+                if (std::isfinite(value) == false)
+                {
+                    return false;
+                }
+
+                ValueType integralValue = std::trunc(value);
+
+                return integralValue >= static_cast<ValueType>(std::numeric_limits<T>::lowest()) && integralValue < static_cast<ValueType>(std::numeric_limits<T>::max()) + 1;
             }
-            else if (codePoint < 0x800)
+            else if constexpr (std::is_signed_v<ValueType> == std::is_signed_v<T>)
             {
-                value[0] = (codePoint >> 6) | 0xc0;
-                value[1] = (codePoint & 0x3f) | 0x80;
+                return value >= std::numeric_limits<T>::lowest() && value <= std::numeric_limits<T>::max();
             }
-            else if (codePoint < 0x10000)
+            else if constexpr (std::is_signed_v<ValueType> == true)
             {
-                value[0] = (codePoint >> 12) | 0xe0;
-                value[1] = ((codePoint >> 6) & 0x3f) | 0x80;
-                value[2] = (codePoint & 0x3f) | 0x80;
+                return value >= 0 && static_cast<std::make_unsigned_t<ValueType>>(value) <= std::numeric_limits<T>::max();
             }
-            else if (codePoint < 0x110000)
+            else
             {
-                value[0] = (codePoint >> 18) | 0xf0;
-                value[1] = ((codePoint >> 12) & 0x3f) | 0x80;
-                value[2] = ((codePoint >> 6) & 0x3f) | 0x80;
-                value[3] = (codePoint & 0x3f) | 0x80;
+                return value <= static_cast<std::make_unsigned_t<T>>(std::numeric_limits<T>::max());
             }
-
-            return std::string(value);
         }
 
-        std::string ConvertToEscapedString(const std::string& value)
+        template<typename T>
+        std::string dataToString() const
         {
-            std::string resultValue;
+            // Note: Shortest form that reads back to the same value, independent of the locale
+            char buffer[32];
 
-            unsigned int codePoint = 0;
-            int numOfBytes = 0;
-            bool writeAsHex = false;
+            std::to_chars_result conversionResult = std::to_chars(buffer, buffer + sizeof(buffer), std::get<T>(mValue));
 
-            for (std::string::size_type index = 0; index < value.size(); ++index)
-            {
-                switch (value[index])
-                {
-                case '"':
-                    resultValue += "\\\"";
-                    break;
+            return std::string(buffer, conversionResult.ptr);
+        }
 
-                case '\\':
-                    resultValue += "\\\\";
-                    break;
+        // Note: The type is derived from the active alternative, so a node is just the variant
+        havJSONVariant mValue;
+    };
 
-                case '\b':
-                    resultValue += "\\b";
-                    break;
+    // Monotonic arena: memory is handed out from large blocks and released all at once.
+    class havJSONArena
+    {
+    public:
+        explicit havJSONArena(std::size_t blockSize = 64 * 1024) : mBlockSize(blockSize) {}
+        ~havJSONArena() { Release(); }
 
-                case '\f':
-                    resultValue += "\\f";
-                    break;
+        havJSONArena(const havJSONArena&) = delete;
+        havJSONArena& operator=(const havJSONArena&) = delete;
 
-                case '\n':
-                    resultValue += "\\n";
-                    break;
+        void* Allocate(std::size_t size, std::size_t alignment)
+        {
+            std::size_t alignedOffset = (mOffset + alignment - 1) & ~(alignment - 1);
 
-                case '\r':
-                    resultValue += "\\r";
-                    break;
+            if (mBlocks == nullptr || alignedOffset + size > mBlocks->mSize)
+            {
+                // Oversized requests get a block of their own
+                AddBlock(std::max(mBlockSize, size + alignment));
 
-                case '\t':
-                    resultValue += "\\t";
-                    break;
+                alignedOffset = (mOffset + alignment - 1) & ~(alignment - 1);
+            }
 
-                case '\v':
-                    resultValue += "\\v";
-                    break;
+            mOffset = alignedOffset + size;
 
-                default:
-                    {
-                        writeAsHex = false;
-                        codePoint = 0;
+            mAllocatedBytes += size;
 
-                        if ((value[index] & 0x80) == 0x00)
-                        {
-                            numOfBytes = 1;
+            return reinterpret_cast<char*>(mBlocks) + alignedOffset;
+        }
 
-                            if (value[index] < 0x1f)
-                            {
-                                writeAsHex = true;
+        void Release()
+        {
+            Reset();
 
-                                codePoint = (value[index] & 0x7f);
-                            }
-                        }
-                        else if ((value[index] & 0xe0) == 0xc0)
-                        {
-                            numOfBytes = 2;
+            while (mFreeBlocks != nullptr)
+            {
+                havJSONArenaBlock* nextBlock = mFreeBlocks->mNext;
 
-                            writeAsHex = true;
+                ::operator delete(mFreeBlocks);
 
-                            codePoint = (value[index] & 0x1f);
-                        }
-                        else if ((value[index] & 0xf0) == 0xe0)
-                        {
-                            numOfBytes = 3;
+                mFreeBlocks = nextBlock;
+            }
 
-                            writeAsHex = true;
+            mReservedBytes = 0;
+        }
 
-                            codePoint = (value[index] & 0x0f);
-                        }
-                        else if ((value[index] & 0xf8) == 0xf0)
-                        {
-                            numOfBytes = 4;
+        // Discards all allocations, but keeps the blocks of the default size for the next allocations. Oversized blocks are released.
+        void Reset()
+        {
+            while (mBlocks != nullptr)
+            {
+                havJSONArenaBlock* nextBlock = mBlocks->mNext;
 
-                            writeAsHex = true;
+                if (mBlocks->mSize == mBlockSize + sizeof(havJSONArenaBlock))
+                {
+                    mBlocks->mNext = mFreeBlocks;
+                    mFreeBlocks = mBlocks;
+                }
+                else
+                {
+                    mReservedBytes -= mBlocks->mSize;
 
-                            codePoint = (value[index] & 0x07);
-                        }
-                        else
-                        {
-                            throw std::runtime_error("Invalid UTF-8 sequence!");
-                        }
+                    ::operator delete(mBlocks);
+                }
 
-                        for (int byteCount = 1; byteCount < numOfBytes; ++byteCount)
-                        {
-                            if ((value[++index] & 0xc0) != 0x80)
-                            {
-                                throw std::runtime_error("Invalid UTF-8 sequence!");
-                            }
+                mBlocks = nextBlock;
+            }
 
-                            codePoint = (codePoint << 6) | (value[index] & 0x3f);
-                        }
+            mOffset = 0;
+            mAllocatedBytes = 0;
+        }
 
-                        if (writeAsHex == true)
-                        {
-                            std::ostringstream outputStringStream;
+        std::size_t GetAllocatedBytes() const { return mAllocatedBytes; }
 
-                            // Code point is UTF-16 surrogate pair
-                            if (codePoint >= 0x10000 && codePoint <= 0x10ffff)
-                            {
-                                codePoint -= 0x10000;
+        std::size_t GetReservedBytes() const { return mReservedBytes; }
 
-                                unsigned int highSurrogate = (codePoint / 0x400) + 0xd800;
-                                unsigned int lowSurrogate = (codePoint % 0x400) + 0xdc00;
+    private:
+        struct havJSONArenaBlock
+        {
+            havJSONArenaBlock* mNext;
+            std::size_t mSize;
+        };
 
-                                outputStringStream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << highSurrogate;
-                                outputStringStream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << lowSurrogate;
+        void AddBlock(std::size_t size)
+        {
+            size += sizeof(havJSONArenaBlock);
 
-                                resultValue += outputStringStream.str();
-                            }
-                            else
-                            {
-                                outputStringStream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << codePoint;
+            // Reuse a block kept by Reset
+            if (mFreeBlocks != nullptr && size == mFreeBlocks->mSize)
+            {
+                havJSONArenaBlock* freeBlock = mFreeBlocks;
 
-                                resultValue += outputStringStream.str();
-                            }
-                        }
-                        else
-                        {
-                            resultValue += static_cast<unsigned int>(value[index]);
-                        }
-                    }
-                }
+                mFreeBlocks = freeBlock->mNext;
+
+                freeBlock->mNext = mBlocks;
+
+                mBlocks = freeBlock;
+
+                mOffset = sizeof(havJSONArenaBlock);
+
+                return;
             }
 
-            return resultValue;
-        }
+            havJSONArenaBlock* newBlock = static_cast<havJSONArenaBlock*>(::operator new(size));
 
-        havJSONTokenValue CheckForString(std::string::size_type& index, const std::string& jsonStringStream)
-        {
-            std::optional<std::string> value;
+            newBlock->mNext = mBlocks;
+            newBlock->mSize = size;
 
-            std::string tempValue;
+            mBlocks = newBlock;
 
-            ++index;
+            mOffset = sizeof(havJSONArenaBlock);
 
-            for (; index < jsonStringStream.size(); ++index)
-            {
-                char currentChar = jsonStringStream[index];
+            mReservedBytes += size;
+        }
 
-                switch (currentChar)
-                {
-                case '"':
-                    {
-                        value = tempValue;
+        havJSONArenaBlock* mBlocks = nullptr;
+        // Blocks kept by Reset
+        havJSONArenaBlock* mFreeBlocks = nullptr;
+        std::size_t mBlockSize;
+        std::size_t mOffset = 0;
+        std::size_t mAllocatedBytes = 0;
+        std::size_t mReservedBytes = 0;
+    };
 
-                        return havJSONTokenValue { havJSONToken::Value, value };
-                    }
-                    break;
+    // Standard allocator that takes its memory from a havJSONArena. Deallocation is a no-op, the memory is released together with the arena.
+    template<typename T>
+    class havJSONArenaAllocator
+    {
+    public:
+        typedef T value_type;
 
-                case '\\':
-                    {
-                        if (++index >= jsonStringStream.size())
-                        {
-                            throw std::runtime_error("Read beyond end of file!");
-                        }
+        explicit havJSONArenaAllocator(havJSONArena* arena) : mArena(arena) {}
 
-                        currentChar = jsonStringStream[index];
+        template<typename U>
+        havJSONArenaAllocator(const havJSONArenaAllocator<U>& other) : mArena(other.getArena()) {}
 
-                        switch (currentChar)
-                        {
-                        case '"':
-                        case '\\':
-                        case '/':
-                            tempValue += currentChar;
-                            break;
+        T* allocate(std::size_t count) { return static_cast<T*>(mArena->Allocate(count * sizeof(T), alignof(T))); }
 
-                        case 'b':
-                            tempValue += '\b';
-                            break;
+        void deallocate(T*, std::size_t) {}
 
-                        case 'f':
-                            tempValue += '\f';
-                            break;
+        havJSONArena* getArena() const { return mArena; }
 
-                        case 'n':
-                            tempValue += '\n';
-                            break;
+        template<typename U>
+        bool operator==(const havJSONArenaAllocator<U>& other) const { return mArena == other.getArena(); }
 
-                        case 'r':
-                            tempValue += '\r';
-                            break;
+        template<typename U>
+        bool operator!=(const havJSONArenaAllocator<U>& other) const { return mArena != other.getArena(); }
 
-                        case 't':
-                            tempValue += '\t';
-                            break;
+    private:
+        havJSONArena* mArena;
+    };
 
-                        case 'u':
-                            {
-                                std::locale loc;
+    // Phases of the work a havJSONStream does, as recorded in havJSONStats
+    enum class havJSONPhase : std::uint8_t
+    {
+        // Opening and mapping a file. Note: The pages of a mapped file are read later, while the contents are parsed.
+        FileRead,
+        // Skipping the BOM and converting UTF-16 and UTF-32 files to UTF-8
+        Conversion,
+        Tokenization,
+        // Building the tree from the tokens of the tokenizer
+        TreeBuilding,
+        // Recursive descent, SAX and struct parsing
+        Parsing,
+        BSONParsing,
+        Serialization,
+        BSONSerialization
+    };
 
-                                std::string hexString;
+    constexpr std::size_t havJSONNumOfPhases = 8;
 
-                                bool isUnicodeEscapeSequence = false;
+    struct havJSONPhaseStats
+    {
+        std::uint64_t mNumOfCalls = 0;
+        std::uint64_t mNanoseconds = 0;
+        // Bytes read by parse phases, written by serialization phases
+        std::uint64_t mNumOfBytes = 0;
+    };
 
-                                for (int valueIndex = 0; valueIndex < 4; ++valueIndex)
-                                {
-                                    if (++index >= jsonStringStream.size())
-                                    {
-                                        throw std::runtime_error("Read beyond end of file!");
-                                    }
+    // Statistics a havJSONStream collects with HAVJSON_STATS defined. They add up over all calls until reset.
+    struct havJSONStats
+    {
+        std::array<havJSONPhaseStats, havJSONNumOfPhases> mPhases;
 
-                                    char currentCharInLoop = jsonStringStream[index];
+        std::uint64_t mNumOfTokens = 0;
+        std::uint64_t mNumOfNodes = 0;
+        // Node allocations, on the heap or in an arena. Strings and container buffers inside the nodes aren't counted.
+        std::uint64_t mNumOfAllocations = 0;
+        std::uint64_t mNumOfAllocatedBytes = 0;
 
-                                    if (std::isxdigit(currentCharInLoop, loc) == false)
-                                    {
-                                        isUnicodeEscapeSequence = false;
+        const havJSONPhaseStats& phase(havJSONPhase phase) const { return mPhases[static_cast<std::size_t>(phase)]; }
 
-                                        break;
-                                    }
-                                    else
-                                    {
-                                        isUnicodeEscapeSequence = true;
-                                    }
+        void reset() { *this = havJSONStats(); }
+    };
 
-                                    hexString += currentCharInLoop;
-                                }
+    // Adds the duration of a scope to a phase of the statistics. Without HAVJSON_STATS, it's empty and compiles away.
+    class havJSONPhaseScope
+    {
+    public:
+#ifdef HAVJSON_STATS
+        havJSONPhaseScope(havJSONStats& stats, havJSONPhase phase, std::size_t numOfBytes) :
+            mPhaseStats(stats.mPhases[static_cast<std::size_t>(phase)]), mNumOfBytes(numOfBytes), mStart(std::chrono::steady_clock::now())
+        {
+        }
 
-                                if (isUnicodeEscapeSequence == true)
-                                {
-                                    unsigned int codePoint = std::strtol(hexString.c_str(), nullptr, 16);
+        ~havJSONPhaseScope()
+        {
+            ++mPhaseStats.mNumOfCalls;
+            mPhaseStats.mNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - mStart).count();
+            mPhaseStats.mNumOfBytes += mNumOfBytes;
+        }
 
-                                    if (++index >= jsonStringStream.size())
-                                    {
-                                        throw std::runtime_error("Read beyond end of file!");
-                                    }
+        // For phases that only know their size at the end, e.g. serialization
+        void SetNumOfBytes(std::size_t numOfBytes) { mNumOfBytes = numOfBytes; }
+#else
+        havJSONPhaseScope() {}
+        ~havJSONPhaseScope() {}
 
-                                    if (jsonStringStream[index] == '\\')
-                                    {
-                                        if (++index >= jsonStringStream.size())
-                                        {
-                                            throw std::runtime_error("Read beyond end of file!");
-                                        }
+        void SetNumOfBytes(std::size_t /* numOfBytes */) {}
+#endif
 
-                                        if (jsonStringStream[index] == 'u')
-                                        {
-                                            bool surrogatePair = false;
+        havJSONPhaseScope(const havJSONPhaseScope&) = delete;
+        havJSONPhaseScope& operator=(const havJSONPhaseScope&) = delete;
 
-                                            hexString = "";
+#ifdef HAVJSON_STATS
+    private:
+        havJSONPhaseStats& mPhaseStats;
+        std::size_t mNumOfBytes;
+        std::chrono::steady_clock::time_point mStart;
+#endif
+    };
 
-                                            for (int valueIndex = 0; valueIndex < 4; ++valueIndex)
-                                            {
-                                                if (++index >= jsonStringStream.size())
-                                                {
-                                                    throw std::runtime_error("Read beyond end of file!");
-                                                }
+#ifdef HAVJSON_STATS
+    // Counts the node allocations of a havJSONStream into its statistics. Nodes come from the arena if one is set, otherwise from
+    // the heap.
+    template<typename T>
+    class havJSONStatsAllocator
+    {
+    public:
+        typedef T value_type;
 
-                                                char currentCharInLoop = jsonStringStream[index];
+        havJSONStatsAllocator(havJSONArena* arena, havJSONStats* stats) : mArena(arena), mStats(stats) {}
 
-                                                if (std::isxdigit(currentCharInLoop, loc) == false)
-                                                {
-                                                    surrogatePair = false;
+        template<typename U>
+        havJSONStatsAllocator(const havJSONStatsAllocator<U>& other) : mArena(other.getArena()), mStats(other.getStats()) {}
 
-                                                    break;
-                                                }
-                                                else
-                                                {
-                                                    surrogatePair = true;
-                                                }
+        T* allocate(std::size_t count)
+        {
+            ++mStats->mNumOfAllocations;
+            mStats->mNumOfAllocatedBytes += count * sizeof(T);
 
-                                                hexString += currentCharInLoop;
-                                            }
+            if (mArena != nullptr)
+            {
+                return static_cast<T*>(mArena->Allocate(count * sizeof(T), alignof(T)));
+            }
 
-                                            if (surrogatePair == true)
-                                            {
-                                                if (codePoint >= 0xd800 && codePoint <= 0xdbff)
-                                                {
-                                                    unsigned int secondCodePoint = std::strtol(hexString.c_str(), nullptr, 16);
+            return std::allocator<T>().allocate(count);
+        }
 
-                                                    if (secondCodePoint >= 0xdc00 && secondCodePoint <= 0xdfff)
-                                                    {
-                                                        // codePoint = high surrogate, secondCodePoint = low surrogate
-                                                        unsigned int surrogatePairValue = 0x10000 + ((codePoint - 0xd800) * 0x400) + (secondCodePoint - 0xdc00);
+        // Note: Nodes may outlive the stream, so the statistics aren't touched here
+        void deallocate(T* memory, std::size_t count)
+        {
+            if (mArena == nullptr)
+            {
+                std::allocator<T>().deallocate(memory, count);
+            }
+        }
 
-                                                        tempValue += CodePointToString(surrogatePairValue);
-                                                    }
-                                                    else
-                                                    {
-                                                        throw std::runtime_error("Invalid code point range for UTF-16 low surrogate pair!");
-                                                    }
-                                                }
-                                                else
-                                                {
-                                                    // Set the index back by six characters, otherwise the possible next UTF-8 sequence isn't processed!
-                                                    index -= 6;
+        havJSONArena* getArena() const { return mArena; }
+        havJSONStats* getStats() const { return mStats; }
 
-                                                    tempValue += CodePointToString(codePoint);
-                                                }
-                                            }
-                                            else
-                                            {
-                                                throw std::runtime_error("Invalid code point for UTF-16 low surrogate pair!");
-                                            }
-                                        }
-                                        else
-                                        {
-                                            // Set the index back by two characters, otherwise the next characters aren't processed!
-                                            index -= 2;
+        template<typename U>
+        bool operator==(const havJSONStatsAllocator<U>& other) const { return mArena == other.getArena(); }
 
-                                            tempValue += CodePointToString(codePoint);
-                                        }
-                                    }
-                                    else
-                                    {
-                                        // Set the index back by one character, otherwise the next character isn't processed!
-                                        --index;
+        template<typename U>
+        bool operator!=(const havJSONStatsAllocator<U>& other) const { return mArena != other.getArena(); }
 
-                                        tempValue += CodePointToString(codePoint);
-                                    }
-                                }
-                                else
-                                {
-                                    // Set the index back by one character, otherwise the next character isn't processed!
-                                    --index;
+    private:
+        havJSONArena* mArena;
+        havJSONStats* mStats;
+    };
+#endif
 
-                                    // Don't eat the u character
-                                    tempValue += currentChar;
+    // Owns the root node of a parsed document and the arena all of its nodes are allocated from.
+    // Note: Nodes must not be used after the document has been destroyed or cleared, even if a std::shared_ptr to them is still held.
+    class havJSONDocument
+    {
+    public:
+        explicit havJSONDocument(std::size_t blockSize = 64 * 1024) : mArena(blockSize) {}
 
-                                    if (hexString.size() > 0)
-                                    {
-                                        tempValue += hexString;
-                                    }
-                                }
-                            }
-                            break;
+        havJSONDocument(const havJSONDocument&) = delete;
+        havJSONDocument& operator=(const havJSONDocument&) = delete;
 
-                        case 'v':
-                            tempValue += '\v';
-                            break;
+        havJSONData& root() { return mRoot; }
 
-                        default:
-                            throw std::runtime_error("Invalid escape character!");
-                        }
-                    }
-                    break;
+        havJSONArena& arena() { return mArena; }
 
-                default:
-                    tempValue += currentChar;
-                }
-            }
+        // Creates a node inside the document's arena, e.g. to pass it to push_back or insert
+        template<typename... Args>
+        std::shared_ptr<havJSONData> create(Args&&... args)
+        {
+            return std::allocate_shared<havJSONData>(havJSONArenaAllocator<havJSONData>(&mArena), std::forward<Args>(args)...);
+        }
 
-            throw std::runtime_error("Invalid string value!");
+        // Note: The arena keeps its blocks, so parsing into the same document again doesn't have to allocate them anew
+        void clear()
+        {
+            mRoot = havJSONData();
+
+            mArena.Reset();
         }
 
-        havJSONTokenValue CheckForNumber(std::string::size_type& index, const std::string& jsonStringStream, const char value)
+        // Like clear, but also returns the arena's memory
+        void release()
         {
-            std::string tempValue(1, value);
+            mRoot = havJSONData();
 
-            for (; index < jsonStringStream.size(); ++index)
-            {
-                char currentChar = jsonStringStream[index];
+            mArena.Release();
+        }
 
-                if (currentChar == ',' || SkipWhitespaces(currentChar, false) == true)
-                {
-                    break;
-                }
+    private:
+        // Note: The arena must be declared before the root node, so the nodes are destroyed before their memory is released
+        havJSONArena mArena;
+        havJSONData mRoot;
+    };
 
-                tempValue += currentChar;
-            }
+    // Read-only view of a file's contents. The file is memory-mapped where possible, otherwise it is read with a single bulk read into a pre-sized buffer.
+    class havJSONFileMapping
+    {
+    public:
+        havJSONFileMapping() {}
+        ~havJSONFileMapping() { Close(); }
 
-            --index;
+        havJSONFileMapping(const havJSONFileMapping&) = delete;
+        havJSONFileMapping& operator=(const havJSONFileMapping&) = delete;
 
-            // Check if we're dealing with a floating point value
-            auto foundDecimalPoint = tempValue.find(".");
+#ifdef _WIN32
+        bool Open(const std::wstring& fileName)
+        {
+            Close();
 
-            // Check if the value contains an exponent
-            auto foundExponent = tempValue.find("e");
+            HANDLE fileHandle = CreateFileW(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
 
-            if (foundExponent == std::string::npos)
+            if (fileHandle == INVALID_HANDLE_VALUE)
             {
-                foundExponent = tempValue.find("E");
+                return false;
             }
 
-            std::string::size_type idx;
+            LARGE_INTEGER fileSize;
 
-            // We're dealing with a signed value
-            if (tempValue[0] == '-')
+            if (GetFileSizeEx(fileHandle, &fileSize) == FALSE)
             {
-                // We're dealing with a floating point value
-                if (foundDecimalPoint != std::string::npos ||
-                    foundExponent != std::string::npos)
-                {
-                    try
-                    {
-                        // We try to convert the value to double
-                        double result = std::stod(tempValue, &idx);
+                CloseHandle(fileHandle);
 
-                        std::stringstream tempStringStream;
+                return false;
+            }
 
-                        tempStringStream << std::fixed << std::setprecision(15) << result;
+            mSize = static_cast<std::size_t>(fileSize.QuadPart);
 
-                        return havJSONTokenValue { havJSONToken::Double, tempStringStream.str() };
-                    }
-                    catch (const std::invalid_argument& e)
-                    {
-                        throw;
-                    }
-                    catch (const std::out_of_range& e)
-                    {
-                        throw;
-                    }
+            if (mSize > 0)
+            {
+                HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+                if (mappingHandle != nullptr)
+                {
+                    mMappedData = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+
+                    CloseHandle(mappingHandle);
                 }
-                // We're dealing with an integer value
-                else
+
+                // Fall back to a single bulk read
+                if (mMappedData == nullptr)
                 {
-                    try
-                    {
-                        // We try to convert the value to int
-                        int result = std::stoi(tempValue, &idx);
+                    mBuffer.resize(mSize);
 
-                        return havJSONTokenValue { havJSONToken::Int, std::to_string(result) };
-                    }
-                    catch (const std::invalid_argument& e)
-                    {
-                        throw;
-                    }
-                    catch (const std::out_of_range& ex2)
+                    DWORD bytesRead = 0;
+                    std::size_t totalBytesRead = 0;
+
+                    while (totalBytesRead < mSize)
                     {
-                        try
-                        {
-                            // We try to convert the value to long
-                            long result = std::stol(tempValue, &idx);
+                        DWORD bytesToRead = static_cast<DWORD>(std::min<std::size_t>(mSize - totalBytesRead, 0x40000000));
 
-                            return havJSONTokenValue { havJSONToken::Long, std::to_string(result) };
-                        }
-                        catch (const std::invalid_argument& e)
+                        if (ReadFile(fileHandle, mBuffer.data() + totalBytesRead, bytesToRead, &bytesRead, nullptr) == FALSE || bytesRead == 0)
                         {
-                            throw;
+                            break;
                         }
-                        catch (const std::out_of_range& ex3)
-                        {
-                            try
-                            {
-                                // We try to convert the value to long long
-                                long long result = std::stoll(tempValue, &idx);
 
-                                return havJSONTokenValue { havJSONToken::Int64, std::to_string(result) };
-                            }
-                            catch (const std::invalid_argument& e)
-                            {
-                                throw;
-                            }
-                            catch (const std::out_of_range& e)
-                            {
-                                throw;
-                            }
-                        }
+                        totalBytesRead += bytesRead;
                     }
+
+                    mSize = totalBytesRead;
                 }
             }
-            // We're dealing with an unsigned value
-            else
+
+            CloseHandle(fileHandle);
+
+            return true;
+        }
+#else
+        bool Open(const std::string& fileName)
+        {
+            Close();
+
+            int fileDescriptor = ::open(fileName.c_str(), O_RDONLY);
+
+            if (fileDescriptor < 0)
             {
-                // We're dealing with a floating point value
-                if (foundDecimalPoint != std::string::npos ||
-                    foundExponent != std::string::npos)
-                {
-                    try
-                    {
-                        // We try to convert the value to double
-                        double result = std::stod(tempValue, &idx);
+                return false;
+            }
 
-                        std::stringstream tempStringStream;
+            struct stat fileStatus;
 
-                        tempStringStream << std::fixed << std::setprecision(15) << result;
+            if (::fstat(fileDescriptor, &fileStatus) != 0)
+            {
+                ::close(fileDescriptor);
 
-                        return havJSONTokenValue { havJSONToken::Double, tempStringStream.str() };
-                    }
-                    catch (const std::invalid_argument& e)
-                    {
-                        throw;
-                    }
-                    catch (const std::out_of_range& e)
-                    {
-                        throw;
-                    }
+                return false;
+            }
+
+            mSize = static_cast<std::size_t>(fileStatus.st_size);
+
+            if (mSize > 0)
+            {
+                void* mappedData = ::mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+                if (mappedData != MAP_FAILED)
+                {
+                    mMappedData = static_cast<const char*>(mappedData);
+
+#ifdef MADV_SEQUENTIAL
+                    ::madvise(mappedData, mSize, MADV_SEQUENTIAL);
+#endif
                 }
-                // We're dealing with an integer value
+                // Fall back to a single bulk read (e.g. for pipes or file systems without mmap support)
                 else
                 {
-                    try
-                    {
-                        // We try to convert the value to unsigned int
-                        unsigned long testResult = std::stoul(tempValue, &idx);
-
-                        // Check if value is in unsigned int range
-                        if (testResult > std::numeric_limits<unsigned int>::max())
-                        {
-                            throw std::out_of_range(tempValue);
-                        }
+                    mBuffer.resize(mSize);
 
-                        unsigned int result = testResult;
+                    std::size_t totalBytesRead = 0;
 
-                        return havJSONTokenValue { havJSONToken::UInt, std::to_string(result) };
-                    }
-                    catch (const std::invalid_argument& e)
-                    {
-                        throw;
-                    }
-                    catch (const std::out_of_range& ex2)
+                    while (totalBytesRead < mSize)
                     {
-                        try
-                        {
-                            // We try to convert the value to unsigned long
-                            unsigned long result = std::stoul(tempValue, &idx);
+                        ssize_t bytesRead = ::read(fileDescriptor, mBuffer.data() + totalBytesRead, mSize - totalBytesRead);
 
-                            return havJSONTokenValue { havJSONToken::ULong, std::to_string(result) };
-                        }
-                        catch (const std::invalid_argument& e)
+                        if (bytesRead <= 0)
                         {
-                            throw;
+                            break;
                         }
-                        catch (const std::out_of_range& ex3)
-                        {
-                            try
-                            {
-                                // We try to convert the value to long long
-                                unsigned long long result = std::stoull(tempValue, &idx);
 
-                                return havJSONTokenValue { havJSONToken::UInt64, std::to_string(result) };
-                            }
-                            catch (const std::invalid_argument& e)
-                            {
-                                throw;
-                            }
-                            catch (const std::out_of_range& e)
-                            {
-                                throw;
-                            }
-                        }
+                        totalBytesRead += static_cast<std::size_t>(bytesRead);
                     }
+
+                    mSize = totalBytesRead;
                 }
             }
 
-            throw std::runtime_error("Unable to read number value!");
+            ::close(fileDescriptor);
+
+            return true;
         }
+#endif
 
-        std::string CheckForLiteral(std::string::size_type& index, const std::string& jsonStringStream, const std::string& literalValue)
+        void Close()
         {
-            std::string tempValue(1, literalValue[0]);
+            if (mMappedData != nullptr)
+            {
+#ifdef _WIN32
+                UnmapViewOfFile(mMappedData);
+#else
+                ::munmap(const_cast<char*>(mMappedData), mSize);
+#endif
+                mMappedData = nullptr;
+            }
 
-            std::string::size_type stringIndex = 1;
+            mBuffer.clear();
 
-            for (; index < jsonStringStream.size(); ++index)
+            mSize = 0;
+        }
+
+        const char* data() const { return (mMappedData != nullptr) ? mMappedData : mBuffer.data(); }
+
+        std::size_t size() const { return mSize; }
+
+        bool isMapped() const { return mMappedData != nullptr; }
+
+        std::string_view view() const { return std::string_view(data(), mSize); }
+
+        // Touches every page of a mapped file, so it's read from disk on the calling thread instead of during the parse
+        void Prefetch() const
+        {
+            if (mMappedData == nullptr)
             {
-                char currentChar = jsonStringStream[index];
+                return;
+            }
 
-                if (currentChar != literalValue[stringIndex++])
+#if !defined(_WIN32) && defined(MADV_WILLNEED)
+            // Note: Lets the kernel read ahead in large requests instead of one page per fault
+            ::madvise(const_cast<char*>(mMappedData), mSize, MADV_WILLNEED);
+#endif
+
+            const volatile char* pageData = mMappedData;
+
+            for (std::size_t index = 0; index < mSize; index += PageSize)
+            {
+                static_cast<void>(pageData[index]);
+            }
+        }
+
+    private:
+        // Smallest page size in use, larger pages are just touched more than once
+        static constexpr std::size_t PageSize = 4096;
+
+        const char* mMappedData = nullptr;
+        std::vector<char> mBuffer;
+        std::size_t mSize = 0;
+    };
+
+    // Finds whitespace runs, string ends and brackets 16 or 32 bytes at a time. The instruction set is chosen at compile time, with a scalar fallback.
+    class havJSONScanner
+    {
+    public:
+        // Returns the position of the first character at or after index that isn't JSON whitespace, or size
+        static std::size_t SkipWhitespaces(const char* data, std::size_t index, std::size_t size)
+        {
+            // Note: Most whitespace runs are short, so check the first character before loading a whole block
+            if (index >= size || IsWhitespace(data[index]) == false)
+            {
+                return index;
+            }
+
+#if defined(HAVJSON_SIMD_AVX2)
+            const __m256i space = _mm256_set1_epi8(' ');
+            const __m256i lineFeed = _mm256_set1_epi8('\n');
+            const __m256i carriageReturn = _mm256_set1_epi8('\r');
+            const __m256i tab = _mm256_set1_epi8('\t');
+
+            for (; index + 32 <= size; index += 32)
+            {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + index));
+
+                __m256i whitespaceMask = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, space), _mm256_cmpeq_epi8(block, lineFeed)),
+                                                         _mm256_or_si256(_mm256_cmpeq_epi8(block, carriageReturn), _mm256_cmpeq_epi8(block, tab)));
+
+                std::uint32_t mask = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(whitespaceMask));
+
+                if (mask != 0)
                 {
-                    throw std::runtime_error("Literal value invalid: " + literalValue);
+                    return index + CountTrailingZeros(mask);
                 }
+            }
+#elif defined(HAVJSON_SIMD_SSE2)
+            const __m128i space = _mm_set1_epi8(' ');
+            const __m128i lineFeed = _mm_set1_epi8('\n');
+            const __m128i carriageReturn = _mm_set1_epi8('\r');
+            const __m128i tab = _mm_set1_epi8('\t');
 
-                tempValue += currentChar;
+            for (; index + 16 <= size; index += 16)
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index));
 
-                if (tempValue == literalValue)
+                __m128i whitespaceMask = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, space), _mm_cmpeq_epi8(block, lineFeed)),
+                                                      _mm_or_si128(_mm_cmpeq_epi8(block, carriageReturn), _mm_cmpeq_epi8(block, tab)));
+
+                std::uint32_t mask = ~static_cast<std::uint32_t>(_mm_movemask_epi8(whitespaceMask)) & 0xffff;
+
+                if (mask != 0)
                 {
-                    break;
+                    return index + CountTrailingZeros(mask);
                 }
             }
+#elif defined(HAVJSON_SIMD_NEON)
+            const uint8x16_t space = vdupq_n_u8(' ');
+            const uint8x16_t lineFeed = vdupq_n_u8('\n');
+            const uint8x16_t carriageReturn = vdupq_n_u8('\r');
+            const uint8x16_t tab = vdupq_n_u8('\t');
 
-            if (tempValue.size() != literalValue.size())
+            for (; index + 16 <= size; index += 16)
             {
-                throw std::runtime_error("Invalid literal value!");
+                uint8x16_t block = vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + index));
+
+                uint8x16_t whitespaceMask = vorrq_u8(vorrq_u8(vceqq_u8(block, space), vceqq_u8(block, lineFeed)),
+                                                     vorrq_u8(vceqq_u8(block, carriageReturn), vceqq_u8(block, tab)));
+
+                std::uint64_t mask = ~ToNibbleMask(whitespaceMask);
+
+                if (mask != 0)
+                {
+                    return index + CountTrailingZeros(mask) / 4;
+                }
             }
+#endif
 
-            return tempValue;
+            for (; index < size; ++index)
+            {
+                if (IsWhitespace(data[index]) == false)
+                {
+                    break;
+                }
+            }
+
+            return index;
         }
 
-        havJSONTokenValue CheckTypeToken(havJSONToken structuralToken, std::string::size_type& index, const std::string& jsonStringStream)
+        // Returns the position of the first quotation mark or backslash at or after index, or size
+        static std::size_t FindStringSpecial(const char* data, std::size_t index, std::size_t size)
         {
-            // Object
-            if (structuralToken == havJSONToken::LeftCurlyBracket)
+#if defined(HAVJSON_SIMD_AVX2)
+            const __m256i quotationMark = _mm256_set1_epi8('"');
+            const __m256i backslash = _mm256_set1_epi8('\\');
+
+            for (; index + 32 <= size; index += 32)
             {
-                for (; index < jsonStringStream.size(); ++index)
-                {
-                    char currentChar = jsonStringStream[index];
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + index));
 
-                    if (SkipWhitespaces(currentChar, false) == true)
-                    {
-                        continue;
-                    }
+                std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(block, quotationMark), _mm256_cmpeq_epi8(block, backslash))));
 
-                    havJSONToken token = CheckToken(currentChar);
+                if (mask != 0)
+                {
+                    return index + CountTrailingZeros(mask);
+                }
+            }
+#elif defined(HAVJSON_SIMD_SSE2)
+            const __m128i quotationMark = _mm_set1_epi8('"');
+            const __m128i backslash = _mm_set1_epi8('\\');
 
-                    if (token != havJSONToken::None)
-                    {
-                        mTokens.push_back(havJSONTokenValue { token, std::nullopt });
+            for (; index + 16 <= size; index += 16)
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index));
 
-                        continue;
-                    }
+                std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, quotationMark), _mm_cmpeq_epi8(block, backslash))));
 
-                    switch (currentChar)
-                    {
-                    case '"':
-                        {
-                            havJSONTokenValue result = CheckForString(index, jsonStringStream);
+                if (mask != 0)
+                {
+                    return index + CountTrailingZeros(mask);
+                }
+            }
+#elif defined(HAVJSON_SIMD_NEON)
+            const uint8x16_t quotationMark = vdupq_n_u8('"');
+            const uint8x16_t backslash = vdupq_n_u8('\\');
 
-                            result.mToken = havJSONToken::String;
+            for (; index + 16 <= size; index += 16)
+            {
+                uint8x16_t block = vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + index));
 
-                            return result;
-                        }
-                        break;
+                std::uint64_t mask = ToNibbleMask(vorrq_u8(vceqq_u8(block, quotationMark), vceqq_u8(block, backslash)));
 
-                    default:
-                        return havJSONTokenValue { havJSONToken::None, std::nullopt };
-                    }
+                if (mask != 0)
+                {
+                    return index + CountTrailingZeros(mask) / 4;
                 }
             }
-            // Array
-            else if (structuralToken == havJSONToken::LeftSquareBracket)
+#endif
+
+            for (; index < size; ++index)
             {
-                for (; index < jsonStringStream.size(); ++index)
+                if (data[index] == '"' || data[index] == '\\')
                 {
-                    char currentChar = jsonStringStream[index];
+                    break;
+                }
+            }
 
-                    if (SkipWhitespaces(currentChar, false) == true)
-                    {
-                        continue;
-                    }
+            return index;
+        }
 
-                    switch (currentChar)
-                    {
-                    case '"':
-                    case 't':
-                    case 'f':
-                    case 'n':
-                    case 'u':
-                    case '-':
-                    case '+':
-                    case '.':
-                    case ':':
-                    case '0':
-                    case '1':
-                    case '2':
-                    case '3':
-                    case '4':
-                    case '5':
-                    case '6':
-                    case '7':
-                    case '8':
-                    case '9':
-                    case 'e':
-                    case 'E':
-                        {
-                            if (currentChar == '"')
-                            {
-                                return CheckForString(index, jsonStringStream);
-                            }
-                            else
-                            {
-                                havJSONToken tempToken = havJSONToken::Value;
+        // Returns the position of the first character at or after index that has to be escaped when writing a string (quotation mark,
+        // backslash, control characters and non-ASCII bytes), or size
+        static std::size_t FindEscapeSpecial(const char* data, std::size_t index, std::size_t size)
+        {
+            // Note: Compared as signed bytes, "less than 0x20" also matches all bytes from 0x80 upwards
+#if defined(HAVJSON_SIMD_AVX2)
+            const __m256i quotationMark = _mm256_set1_epi8('"');
+            const __m256i backslash = _mm256_set1_epi8('\\');
+            const __m256i firstPrintable = _mm256_set1_epi8(0x20);
 
-                                std::optional<std::string> value;
+            for (; index + 32 <= size; index += 32)
+            {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + index));
 
-                                std::string tempValue;
+                __m256i specialMask = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, quotationMark), _mm256_cmpeq_epi8(block, backslash)), _mm256_cmpgt_epi8(firstPrintable, block));
 
-                                ++index;
+                std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(specialMask));
 
-                                if (currentChar == 't')
-                                {
-                                    tempValue = CheckForLiteral(index, jsonStringStream, "true");
+                if (mask != 0)
+                {
+                    return index + CountTrailingZeros(mask);
+                }
+            }
+#elif defined(HAVJSON_SIMD_SSE2)
+            const __m128i quotationMark = _mm_set1_epi8('"');
+            const __m128i backslash = _mm_set1_epi8('\\');
+            const __m128i firstPrintable = _mm_set1_epi8(0x20);
 
-                                    tempToken = havJSONToken::Boolean;
-                                }
+            for (; index + 16 <= size; index += 16)
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index));
 
-                                if (currentChar == 'f')
-                                {
-                                    tempValue = CheckForLiteral(index, jsonStringStream, "false");
+                __m128i specialMask = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, quotationMark), _mm_cmpeq_epi8(block, backslash)), _mm_cmplt_epi8(block, firstPrintable));
 
-                                    tempToken = havJSONToken::Boolean;
-                                }
+                std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(specialMask));
 
-                                if (currentChar == 'n')
-                                {
-                                    tempValue = CheckForLiteral(index, jsonStringStream, "null");
+                if (mask != 0)
+                {
+                    return index + CountTrailingZeros(mask);
+                }
+            }
+#elif defined(HAVJSON_SIMD_NEON)
+            const uint8x16_t quotationMark = vdupq_n_u8('"');
+            const uint8x16_t backslash = vdupq_n_u8('\\');
+            const int8x16_t firstPrintable = vdupq_n_s8(0x20);
 
-                                    tempToken = havJSONToken::Null;
-                                }
+            for (; index + 16 <= size; index += 16)
+            {
+                uint8x16_t block = vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + index));
 
-                                if (currentChar == '-' ||
-                                    currentChar == '+' ||
-                                    currentChar == '.' ||
-                                    currentChar == ':' ||
-                                    currentChar == '0' ||
-                                    currentChar == '1' ||
-                                    currentChar == '2' ||
-                                    currentChar == '3' ||
-                                    currentChar == '4' ||
-                                    currentChar == '5' ||
-                                    currentChar == '6' ||
-                                    currentChar == '7' ||
-                                    currentChar == '8' ||
-                                    currentChar == '9' ||
-                                    currentChar == 'e' ||
-                                    currentChar == 'E')
-                                {
-                                    return CheckForNumber(index, jsonStringStream, currentChar);
-                                }
-
-                                if (tempValue.empty() == false)
-                                {
-                                    value = tempValue;
-                                }
-
-                                return havJSONTokenValue { tempToken, ((value.has_value() == false) ? std::nullopt : value) };
-                            }
-                        }
-                        break;
+                uint8x16_t specialMask = vorrq_u8(vorrq_u8(vceqq_u8(block, quotationMark), vceqq_u8(block, backslash)), vcltq_s8(vreinterpretq_s8_u8(block), firstPrintable));
 
-                    case '{':
-                        mTokens.push_back(havJSONTokenValue { havJSONToken::LeftCurlyBracket, std::nullopt });
-                        return havJSONTokenValue { havJSONToken::LeftCurlyBracket, std::nullopt };
-
-                    case '[':
-                        mTokens.push_back(havJSONTokenValue { havJSONToken::LeftSquareBracket, std::nullopt });
-                        return havJSONTokenValue { havJSONToken::LeftSquareBracket, std::nullopt };
+                std::uint64_t mask = ToNibbleMask(specialMask);
 
-                    default:
-                        return havJSONTokenValue { havJSONToken::None, std::nullopt };
-                    }
+                if (mask != 0)
+                {
+                    return index + CountTrailingZeros(mask) / 4;
                 }
             }
-            // Other types (e.g. Value)
-            else
+#endif
+
+            for (; index < size; ++index)
             {
-                for (; index < jsonStringStream.size(); ++index)
+                if (data[index] == '"' || data[index] == '\\' || static_cast<signed char>(data[index]) < 0x20)
                 {
-                    char currentChar = jsonStringStream[index];
-
-                    if (SkipWhitespaces(currentChar, false) == true)
-                    {
-                        continue;
-                    }
-
-                    havJSONToken token = CheckToken(currentChar);
+                    break;
+                }
+            }
 
-                    if (token != havJSONToken::None)
-                    {
-                        mTokens.push_back(havJSONTokenValue { token, std::nullopt });
-                    }
+            return index;
+        }
 
-                    if (token == havJSONToken::None)
-                    {
-                        switch (currentChar)
-                        {
-                        case '"':
-                        case 't':
-                        case 'f':
-                        case 'n':
-                        case 'u':
-                        case '-':
-                        case '+':
-                        case '.':
-                        case ':':
-                        case '0':
-                        case '1':
-                        case '2':
-                        case '3':
-                        case '4':
-                        case '5':
-                        case '6':
-                        case '7':
-                        case '8':
-                        case '9':
-                        case 'e':
-                        case 'E':
-                            {
-                                if (currentChar == '"')
-                                {
-                                    return CheckForString(index, jsonStringStream);
-                                }
-                                else
-                                {
-                                    havJSONToken tempToken = havJSONToken::Value;
+        // Returns the position of the first quotation mark or bracket at or after index, or size
+        static std::size_t FindSkipSpecial(const char* data, std::size_t index, std::size_t size)
+        {
+            // Note: Setting bit 5 maps '[' to '{' and ']' to '}', and no other character to either
+#if defined(HAVJSON_SIMD_AVX2)
+            const __m256i quotationMark = _mm256_set1_epi8('"');
+            const __m256i leftBracket = _mm256_set1_epi8('{');
+            const __m256i rightBracket = _mm256_set1_epi8('}');
+            const __m256i caseBit = _mm256_set1_epi8(0x20);
+
+            for (; index + 32 <= size; index += 32)
+            {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + index));
+                __m256i foldedBlock = _mm256_or_si256(block, caseBit);
 
-                                    std::optional<std::string> value;
+                __m256i specialMask = _mm256_or_si256(_mm256_cmpeq_epi8(block, quotationMark),
+                                                      _mm256_or_si256(_mm256_cmpeq_epi8(foldedBlock, leftBracket), _mm256_cmpeq_epi8(foldedBlock, rightBracket)));
 
-                                    std::string tempValue;
+                std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(specialMask));
 
-                                    ++index;
+                if (mask != 0)
+                {
+                    return index + CountTrailingZeros(mask);
+                }
+            }
+#elif defined(HAVJSON_SIMD_SSE2)
+            const __m128i quotationMark = _mm_set1_epi8('"');
+            const __m128i leftBracket = _mm_set1_epi8('{');
+            const __m128i rightBracket = _mm_set1_epi8('}');
+            const __m128i caseBit = _mm_set1_epi8(0x20);
 
-                                    if (currentChar == 't')
-                                    {
-                                        tempValue = CheckForLiteral(index, jsonStringStream, "true");
+            for (; index + 16 <= size; index += 16)
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index));
+                __m128i foldedBlock = _mm_or_si128(block, caseBit);
 
-                                        tempToken = havJSONToken::Boolean;
-                                    }
+                __m128i specialMask = _mm_or_si128(_mm_cmpeq_epi8(block, quotationMark),
+                                                   _mm_or_si128(_mm_cmpeq_epi8(foldedBlock, leftBracket), _mm_cmpeq_epi8(foldedBlock, rightBracket)));
 
-                                    if (currentChar == 'f')
-                                    {
-                                        tempValue = CheckForLiteral(index, jsonStringStream, "false");
+                std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(specialMask));
 
-                                        tempToken = havJSONToken::Boolean;
-                                    }
+                if (mask != 0)
+                {
+                    return index + CountTrailingZeros(mask);
+                }
+            }
+#elif defined(HAVJSON_SIMD_NEON)
+            const uint8x16_t quotationMark = vdupq_n_u8('"');
+            const uint8x16_t leftBracket = vdupq_n_u8('{');
+            const uint8x16_t rightBracket = vdupq_n_u8('}');
+            const uint8x16_t caseBit = vdupq_n_u8(0x20);
 
-                                    if (currentChar == 'n')
-                                    {
-                                        tempValue = CheckForLiteral(index, jsonStringStream, "null");
+            for (; index + 16 <= size; index += 16)
+            {
+                uint8x16_t block = vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + index));
+                uint8x16_t foldedBlock = vorrq_u8(block, caseBit);
 
-                                        tempToken = havJSONToken::Null;
-                                    }
+                uint8x16_t specialMask = vorrq_u8(vceqq_u8(block, quotationMark), vorrq_u8(vceqq_u8(foldedBlock, leftBracket), vceqq_u8(foldedBlock, rightBracket)));
 
-                                    if (currentChar == '-' ||
-                                        currentChar == '+' ||
-                                        currentChar == '.' ||
-                                        currentChar == ':' ||
-                                        currentChar == '0' ||
-                                        currentChar == '1' ||
-                                        currentChar == '2' ||
-                                        currentChar == '3' ||
-                                        currentChar == '4' ||
-                                        currentChar == '5' ||
-                                        currentChar == '6' ||
-                                        currentChar == '7' ||
-                                        currentChar == '8' ||
-                                        currentChar == '9' ||
-                                        currentChar == 'e' ||
-                                        currentChar == 'E')
-                                    {
-                                        return CheckForNumber(index, jsonStringStream, currentChar);
-                                    }
+                std::uint64_t mask = ToNibbleMask(specialMask);
 
-                                    if (tempValue.empty() == false)
-                                    {
-                                        value = tempValue;
-                                    }
+                if (mask != 0)
+                {
+                    return index + CountTrailingZeros(mask) / 4;
+                }
+            }
+#endif
 
-                                    return havJSONTokenValue { tempToken, ((value.has_value() == false) ? std::nullopt : value) };
-                                }
-                            }
-                            break;
+            for (; index < size; ++index)
+            {
+                char foldedChar = static_cast<char>(data[index] | 0x20);
 
-                        default:
-                            return havJSONTokenValue { havJSONToken::None, std::nullopt };
-                        }
-                    }
-                    else
-                    {
-                        return havJSONTokenValue { token, std::nullopt };
-                    }
+                if (data[index] == '"' || foldedChar == '{' || foldedChar == '}')
+                {
+                    break;
                 }
             }
 
-            return havJSONTokenValue { structuralToken, std::nullopt };
+            return index;
         }
 
-        std::string GetBSONKey(const std::string& jsonStringStream, int& index)
+        // Returns the index past the end of the value starting at index, or size if the value isn't closed. Only quotation marks and
+        // brackets are looked at, so the value itself isn't validated. Returns index if there's no value at index.
+        static std::size_t SkipValue(const char* data, std::size_t index, std::size_t size)
         {
-            char newChar = jsonStringStream[++index];
+            if (index >= size)
+            {
+                return index;
+            }
 
-            std::string stringValue;
+            if (data[index] == '"')
+            {
+                return SkipString(data, index, size);
+            }
 
-            while (newChar != 0x00)
+            if (data[index] != '{' && data[index] != '[')
             {
-                stringValue += newChar;
+                // Numbers and literals end at the next delimiter
+                while (index < size && data[index] != ',' && data[index] != ']' && data[index] != '}' && IsWhitespace(data[index]) == false)
+                {
+                    ++index;
+                }
 
-                newChar = jsonStringStream[++index];
+                return index;
             }
 
-            // Skip null terminator
-            ++index;
-
-            // Convert to escaped string
-            stringValue = ConvertToEscapedString(stringValue);
+            std::size_t depthLevel = 0;
 
-            std::string keyValue("\"");
-            keyValue += stringValue;
-            keyValue += "\": ";
+            while (true)
+            {
+                index = FindSkipSpecial(data, index, size);
 
-            return keyValue;
-        }
+                if (index >= size)
+                {
+                    return size;
+                }
 
-        std::int32_t GetBSONValueSize(const std::string& jsonStringStream, int& index)
-        {
-            std::int32_t valueSize = (jsonStringStream[index + 3] << 24) | ((jsonStringStream[index + 2] & 0xff) << 16) | ((jsonStringStream[index + 1] & 0xff) << 8) | (jsonStringStream[index + 0] & 0xff);
+                if (data[index] == '"')
+                {
+                    index = SkipString(data, index, size);
 
-            if (valueSize < 0)
-            {
-                throw std::runtime_error("Value size can't be negative!");
-            }
+                    continue;
+                }
 
-            index += 4;
+                if (data[index] == '{' || data[index] == '[')
+                {
+                    ++depthLevel;
+                }
+                else if (--depthLevel == 0)
+                {
+                    return index + 1;
+                }
 
-            return valueSize;
+                ++index;
+            }
         }
 
-        std::string ConvertBSONToJSON(const std::string& jsonStringStream)
+    private:
+        // Returns the index past the closing quotation mark of the string starting at index, or size
+        static std::size_t SkipString(const char* data, std::size_t index, std::size_t size)
         {
-            int index = 0;
-
-            std::int32_t totalDocumentSize = GetBSONValueSize(jsonStringStream, index);
-
-            // Keeps track of the depth level
-            std::deque<havJSONBSONTypeValue> typeMemory;
-
-            // Note: We assume that BSON documents are always objects, and never arrays. Is that correct, though?
-            std::string jsonContent("{");
-
-            for (; index < totalDocumentSize; ++index)
+            // Note: A backslash escapes the character after it, so both are stepped over
+            for (++index; index < size; index += 2)
             {
-                // Check if we reached the end of the BSON document
-                if (index + 1 == totalDocumentSize)
+                index = FindStringSpecial(data, index, size);
+
+                if (index >= size)
                 {
-                    // Advance to next byte ("end of object")
-                    ++index;
-                    break;
+                    return size;
                 }
 
-                if (typeMemory.empty() == false)
+                if (data[index] == '"')
                 {
-                    const havJSONBSONTypeValue& typeValue = typeMemory.back();
-
-                    if (typeValue.mCurrentIndex > typeValue.mTotalLength)
-                    {
-                        throw std::runtime_error("BSON type value index is greater than total length!");
-                    }
+                    return index + 1;
                 }
+            }
 
-                char currentChar = jsonStringStream[index];
+            return size;
+        }
 
-                // Type
-                switch (static_cast<havJSON::havJSONBSONType>(currentChar))
-                {
-                    case havJSON::havJSONBSONType::NullValue:
-                        {
-                            // Key
-                            if (typeMemory.empty() == false)
-                            {
-                                // Integer key
-                                havJSONBSONTypeValue& typeValue = typeMemory.back();
+        static bool IsWhitespace(char currentChar)
+        {
+            return currentChar == ' ' || currentChar == '\n' || currentChar == '\r' || currentChar == '\t';
+        }
 
-                                if (typeValue.mType == havJSON::havJSONBSONType::Array)
-                                {
-                                    // Advance to next byte
-                                    ++index;
+        static unsigned int CountTrailingZeros(std::uint64_t value)
+        {
+#ifdef _MSC_VER
+            unsigned long bitIndex = 0;
+#ifdef _WIN64
+            _BitScanForward64(&bitIndex, value);
+#else
+            if (static_cast<std::uint32_t>(value) != 0)
+            {
+                _BitScanForward(&bitIndex, static_cast<std::uint32_t>(value));
+            }
+            else
+            {
+                _BitScanForward(&bitIndex, static_cast<std::uint32_t>(value >> 32));
 
-#if 0
-                                    // Parse integer key
-                                    std::uint16_t tempCodepoint = ((jsonStringStream[index + 1] & 0xff) << 8) | (jsonStringStream[index + 0] & 0xff);
-                                    std::string tempKey = CodePointToString(tempCodepoint);
-                                    std::cout << "Key: " << tempKey << std::endl;
+                bitIndex += 32;
+            }
+#endif
+            return static_cast<unsigned int>(bitIndex);
+#else
+            return static_cast<unsigned int>(__builtin_ctzll(value));
 #endif
+        }
 
-                                    // Advance index by 2
-                                    index += 2;
+#ifdef HAVJSON_SIMD_NEON
+        // NEON has no movemask, so narrow each byte of the comparison result to four bits
+        static std::uint64_t ToNibbleMask(uint8x16_t comparisonResult)
+        {
+            return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(comparisonResult), 4)), 0);
+        }
+#endif
+    };
 
-                                    // data type (1 byte) + integer key (2 byte)
-                                    typeValue.mCurrentIndex += 3;
-                                }
-                                else
-                                {
-                                    throw std::runtime_error("Other types are not supported!");
-                                }
-                            }
-                            else
-                            {
-                                // String key
-                                jsonContent += GetBSONKey(jsonStringStream, index);
-                            }
+    // Locale-free number scanning and conversion based on std::from_chars / std::to_chars.
+    class havJSONNumberConverter
+    {
+    public:
+        // Large enough for the shortest round-trip form of a double and for any 64-bit integer
+        static constexpr std::size_t BufferSize = 32;
 
-                            // Value
-                            jsonContent += "null";
+        // Returns true for the characters a number can consist of, whether or not they're in a valid order
+        static bool IsNumberCharacter(char currentChar)
+        {
+            return (currentChar >= '0' && currentChar <= '9') || currentChar == '-' || currentChar == '+' || currentChar == '.' || currentChar == 'e' || currentChar == 'E';
+        }
 
-                            if (typeMemory.empty() == false)
-                            {
-                                const havJSONBSONTypeValue& typeValue = typeMemory.back();
+        // Scans a number following the JSON grammar, starting at index. On return, index points past the last character of the number.
+        static bool Scan(std::string_view::size_type& index, std::string_view jsonStringStream, bool& isFloatingPoint)
+        {
+            isFloatingPoint = false;
 
-                                if (typeValue.mType == havJSON::havJSONBSONType::Array)
-                                {
-                                    if (typeValue.mCurrentIndex + 1 < typeValue.mTotalLength)
-                                    {
-                                        // The current index doesn't need to be increased here
+            if (index < jsonStringStream.size() && jsonStringStream[index] == '-')
+            {
+                ++index;
+            }
 
-                                        // The off-by-one error preventation is unnecessary here
+            // Integer part
+            if (index < jsonStringStream.size() && jsonStringStream[index] == '0')
+            {
+                ++index;
+            }
+            else if (index < jsonStringStream.size() && jsonStringStream[index] >= '1' && jsonStringStream[index] <= '9')
+            {
+                SkipDigits(index, jsonStringStream);
+            }
+            else
+            {
+                return false;
+            }
 
-                                        jsonContent += ", ";
-                                    }
-                                }
-                            }
-                        }
-                        break;
+            // Fraction part
+            if (index < jsonStringStream.size() && jsonStringStream[index] == '.')
+            {
+                isFloatingPoint = true;
 
-                    case havJSON::havJSONBSONType::Boolean:
-                        {
-                            // Key
-                            if (typeMemory.empty() == false)
-                            {
-                                // Integer key
-                                havJSONBSONTypeValue& typeValue = typeMemory.back();
+                ++index;
 
-                                if (typeValue.mType == havJSON::havJSONBSONType::Array)
-                                {
-                                    // Advance to next byte
-                                    ++index;
+                if (SkipDigits(index, jsonStringStream) == false)
+                {
+                    return false;
+                }
+            }
 
-#if 0
-                                    // Parse integer key
-                                    std::uint16_t tempCodepoint = ((jsonStringStream[index + 1] & 0xff) << 8) | (jsonStringStream[index + 0] & 0xff);
-                                    std::string tempKey = CodePointToString(tempCodepoint);
-                                    std::cout << "Key: " << tempKey << std::endl;
-#endif
+            // Exponent part
+            if (index < jsonStringStream.size() && (jsonStringStream[index] == 'e' || jsonStringStream[index] == 'E'))
+            {
+                isFloatingPoint = true;
 
-                                    // Advance index by 2
-                                    index += 2;
+                ++index;
 
-                                    // data type (1 byte) + integer key (2 byte)
-                                    typeValue.mCurrentIndex += 3;
-                                }
-                                else
-                                {
-                                    throw std::runtime_error("Other types are not supported!");
-                                }
-                            }
-                            else
-                            {
-                                // String key
-                                jsonContent += GetBSONKey(jsonStringStream, index);
-                            }
-
-                            // Value
-                            bool value = jsonStringStream[index];
-
-                            if (value == true)
-                            {
-                                jsonContent += "true";
-                            }
-                            else
-                            {
-                                jsonContent += "false";
-                            }
-
-                            if (typeMemory.empty() == false)
-                            {
-                                havJSONBSONTypeValue& typeValue = typeMemory.back();
+                if (index < jsonStringStream.size() && (jsonStringStream[index] == '+' || jsonStringStream[index] == '-'))
+                {
+                    ++index;
+                }
 
-                                if (typeValue.mType == havJSON::havJSONBSONType::Array)
-                                {
-                                    typeValue.mCurrentIndex += 1;
+                if (SkipDigits(index, jsonStringStream) == false)
+                {
+                    return false;
+                }
+            }
 
-                                    if (typeValue.mCurrentIndex + 1 < typeValue.mTotalLength)
-                                    {
-                                        jsonContent += ", ";
-                                    }
-                                }
-                            }
-                        }
-                        break;
+            return true;
+        }
 
-                    case havJSON::havJSONBSONType::Int:
-                        {
-                            // Key
-                            if (typeMemory.empty() == false)
-                            {
-                                // Integer key
-                                havJSONBSONTypeValue& typeValue = typeMemory.back();
+        template<typename T>
+        static T FromChars(std::string_view value)
+        {
+            T result {};
 
-                                if (typeValue.mType == havJSON::havJSONBSONType::Array)
-                                {
-                                    // Advance to next byte
-                                    ++index;
+            // Note: std::from_chars does not accept a leading plus sign, which JSON does not allow either
+            std::from_chars_result conversionResult = std::from_chars(value.data(), value.data() + value.size(), result);
 
-#if 0
-                                    // Parse integer key
-                                    std::uint16_t tempCodepoint = ((jsonStringStream[index + 1] & 0xff) << 8) | (jsonStringStream[index + 0] & 0xff);
-                                    std::string tempKey = CodePointToString(tempCodepoint);
-                                    std::cout << "Key: " << tempKey << std::endl;
-#endif
+            if (conversionResult.ec != std::errc() || conversionResult.ptr != value.data() + value.size())
+            {
+                throw std::runtime_error("Unable to read number value!");
+            }
 
-                                    // Advance index by 2
-                                    index += 2;
+            return result;
+        }
 
-                                    // data type (1 byte) + integer key (2 byte)
-                                    typeValue.mCurrentIndex += 3;
-                                }
-                                else
-                                {
-                                    throw std::runtime_error("Other types are not supported!");
-                                }
-                            }
-                            else
-                            {
-                                // String key
-                                jsonContent += GetBSONKey(jsonStringStream, index);
-                            }
+        // Converts a scanned number to the narrowest matching type and passes the typed value to function.
+        template<typename Function>
+        static auto Convert(std::string_view numberValue, bool isFloatingPoint, Function&& function)
+        {
+            if (isFloatingPoint == false)
+            {
+                // We're dealing with a signed value, so pick the narrowest signed type
+                if (numberValue[0] == '-')
+                {
+                    long long result = 0;
 
-                            // Value
-                            std::int32_t value = (jsonStringStream[index + 3] << 24) | ((jsonStringStream[index + 2] & 0xff) << 16) | ((jsonStringStream[index + 1] & 0xff) << 8) | (jsonStringStream[index + 0] & 0xff);
+                    std::from_chars_result conversionResult = std::from_chars(numberValue.data(), numberValue.data() + numberValue.size(), result);
 
-                            index += 3;
+                    if (conversionResult.ec == std::errc())
+                    {
+                        if (result >= std::numeric_limits<int>::min())
+                        {
+                            return function(static_cast<int>(result));
+                        }
 
-                            jsonContent += std::to_string(value);
+                        if (result >= std::numeric_limits<long>::min())
+                        {
+                            return function(static_cast<long>(result));
+                        }
 
-                            if (typeMemory.empty() == false)
-                            {
-                                havJSONBSONTypeValue& typeValue = typeMemory.back();
+                        return function(static_cast<long long>(result));
+                    }
+                }
+                // We're dealing with an unsigned value, so pick the narrowest unsigned type
+                else
+                {
+                    unsigned long long result = 0;
 
-                                if (typeValue.mType == havJSON::havJSONBSONType::Array)
-                                {
-                                    typeValue.mCurrentIndex += 4;
+                    std::from_chars_result conversionResult = std::from_chars(numberValue.data(), numberValue.data() + numberValue.size(), result);
 
-                                    if (typeValue.mCurrentIndex + 1 < typeValue.mTotalLength)
-                                    {
-                                        jsonContent += ", ";
-                                    }
-                                }
-                            }
+                    if (conversionResult.ec == std::errc())
+                    {
+                        if (result <= std::numeric_limits<unsigned int>::max())
+                        {
+                            return function(static_cast<unsigned int>(result));
                         }
-                        break;
 
-                    case havJSON::havJSONBSONType::Timestamp:
+                        if (result <= std::numeric_limits<unsigned long>::max())
                         {
-                            // Key
-                            if (typeMemory.empty() == false)
-                            {
-                                // Integer key
-                                havJSONBSONTypeValue& typeValue = typeMemory.back();
+                            return function(static_cast<unsigned long>(result));
+                        }
 
-                                if (typeValue.mType == havJSON::havJSONBSONType::Array)
-                                {
-                                    // Advance to next byte
-                                    ++index;
+                        return function(static_cast<unsigned long long>(result));
+                    }
+                }
 
-#if 0
-                                    // Parse integer key
-                                    std::uint16_t tempCodepoint = ((jsonStringStream[index + 1] & 0xff) << 8) | (jsonStringStream[index + 0] & 0xff);
-                                    std::string tempKey = CodePointToString(tempCodepoint);
-                                    std::cout << "Key: " << tempKey << std::endl;
-#endif
+                // Note: Integers outside of the 64-bit range fall back to double
+            }
 
-                                    // Advance index by 2
-                                    index += 2;
+            return function(FromChars<double>(numberValue));
+        }
 
-                                    // data type (1 byte) + integer key (2 byte)
-                                    typeValue.mCurrentIndex += 3;
-                                }
-                                else
-                                {
-                                    throw std::runtime_error("Other types are not supported!");
-                                }
-                            }
-                            else
-                            {
-                                // String key
-                                jsonContent += GetBSONKey(jsonStringStream, index);
-                            }
+        // Writes the value to buffer and returns the number of characters written. Doubles use the shortest round-trip representation.
+        template<typename T>
+        static std::size_t ToChars(T value, char (&buffer)[BufferSize])
+        {
+            if constexpr (std::is_floating_point_v<T> == true)
+            {
+                // Note: NaN and infinity have no JSON representation
+                if (std::isfinite(value) == false)
+                {
+                    std::memcpy(buffer, "null", 4);
 
-                            // Value
-                            char uint64String[8] = { jsonStringStream[index + 0], jsonStringStream[index + 1], jsonStringStream[index + 2], jsonStringStream[index + 3], jsonStringStream[index + 4], jsonStringStream[index + 5], jsonStringStream[index + 6], jsonStringStream[index + 7] };
-                            std::uint64_t value;
-                            std::memcpy(&value, uint64String, sizeof(std::uint64_t));
+                    return 4;
+                }
+            }
 
-                            index += 7;
+            std::to_chars_result conversionResult = std::to_chars(buffer, buffer + BufferSize, value);
 
-                            jsonContent += std::to_string(value);
+            std::size_t size = static_cast<std::size_t>(conversionResult.ptr - buffer);
 
-                            if (typeMemory.empty() == false)
-                            {
-                                havJSONBSONTypeValue& typeValue = typeMemory.back();
+            if constexpr (std::is_floating_point_v<T> == true)
+            {
+                // Keep integral doubles recognizable as floating point values when they are read back
+                if (std::find_if(buffer, buffer + size, [](char currentChar) { return currentChar == '.' || currentChar == 'e'; }) == buffer + size)
+                {
+                    buffer[size++] = '.';
+                    buffer[size++] = '0';
+                }
+            }
 
-                                if (typeValue.mType == havJSON::havJSONBSONType::Array)
-                                {
-                                    typeValue.mCurrentIndex += 8;
+            return size;
+        }
 
-                                    if (typeValue.mCurrentIndex + 1 < typeValue.mTotalLength)
-                                    {
-                                        jsonContent += ", ";
-                                    }
-                                }
-                            }
-                        }
-                        break;
+        template<typename T>
+        static std::string ToString(T value)
+        {
+            char buffer[BufferSize];
 
-                    case havJSON::havJSONBSONType::UTCDateTime:
-                    case havJSON::havJSONBSONType::Int64:
-                        {
-                            // Key
-                            if (typeMemory.empty() == false)
-                            {
-                                // Integer key
-                                havJSONBSONTypeValue& typeValue = typeMemory.back();
+            return std::string(buffer, ToChars(value, buffer));
+        }
 
-                                if (typeValue.mType == havJSON::havJSONBSONType::Array)
-                                {
-                                    // Advance to next byte
-                                    ++index;
+    private:
+        static bool SkipDigits(std::string_view::size_type& index, std::string_view jsonStringStream)
+        {
+            std::string_view::size_type startIndex = index;
 
-#if 0
-                                    // Parse integer key
-                                    std::uint16_t tempCodepoint = ((jsonStringStream[index + 1] & 0xff) << 8) | (jsonStringStream[index + 0] & 0xff);
-                                    std::string tempKey = CodePointToString(tempCodepoint);
-                                    std::cout << "Key: " << tempKey << std::endl;
-#endif
+            while (index < jsonStringStream.size() && jsonStringStream[index] >= '0' && jsonStringStream[index] <= '9')
+            {
+                ++index;
+            }
 
-                                    // Advance index by 2
-                                    index += 2;
+            return index > startIndex;
+        }
+    };
 
-                                    // data type (1 byte) + integer key (2 byte)
-                                    typeValue.mCurrentIndex += 3;
-                                }
-                                else
-                                {
-                                    throw std::runtime_error("Other types are not supported!");
-                                }
-                            }
-                            else
-                            {
-                                // String key
-                                jsonContent += GetBSONKey(jsonStringStream, index);
-                            }
+    // Collects output and hands it to the sink in large chunks. A std::string sink is appended to directly.
+    class havJSONOutputBuffer
+    {
+    public:
+        typedef std::function<bool(const char* data, std::size_t size)> havJSONFlushFunction;
 
-                            // Value
-                            char int64String[8] = { jsonStringStream[index + 0], jsonStringStream[index + 1], jsonStringStream[index + 2], jsonStringStream[index + 3], jsonStringStream[index + 4], jsonStringStream[index + 5], jsonStringStream[index + 6], jsonStringStream[index + 7] };
-                            std::int64_t value;
-                            std::memcpy(&value, int64String, sizeof(std::int64_t));
+        explicit havJSONOutputBuffer(std::string& outputString) : mOutputString(&outputString) {}
 
-                            index += 7;
+        explicit havJSONOutputBuffer(std::FILE* fileStream, std::size_t bufferSize = 64 * 1024) :
+            mFlushFunction([fileStream](const char* data, std::size_t size) { return std::fwrite(data, sizeof(char), size, fileStream) == size; }),
+            mBuffer(std::max<std::size_t>(bufferSize, 1))
+        {
+        }
 
-                            jsonContent += std::to_string(value);
+        explicit havJSONOutputBuffer(havJSONFlushFunction flushFunction, std::size_t bufferSize = 64 * 1024) :
+            mFlushFunction(std::move(flushFunction)),
+            mBuffer(std::max<std::size_t>(bufferSize, 1))
+        {
+        }
 
-                            if (typeMemory.empty() == false)
-                            {
-                                havJSONBSONTypeValue& typeValue = typeMemory.back();
+        ~havJSONOutputBuffer() { Flush(); }
 
-                                if (typeValue.mType == havJSON::havJSONBSONType::Array)
-                                {
-                                    typeValue.mCurrentIndex += 8;
+        havJSONOutputBuffer(const havJSONOutputBuffer&) = delete;
+        havJSONOutputBuffer& operator=(const havJSONOutputBuffer&) = delete;
 
-                                    if (typeValue.mCurrentIndex + 1 < typeValue.mTotalLength)
-                                    {
-                                        jsonContent += ", ";
-                                    }
-                                }
-                            }
-                        }
-                        break;
+        void Write(char value)
+        {
+            if (mOutputString != nullptr)
+            {
+                mOutputString->push_back(value);
 
-                    case havJSON::havJSONBSONType::Double:
-                        {
-                            // Key
-                            if (typeMemory.empty() == false)
-                            {
-                                // Integer key
-                                havJSONBSONTypeValue& typeValue = typeMemory.back();
+                return;
+            }
 
-                                if (typeValue.mType == havJSON::havJSONBSONType::Array)
-                                {
-                                    // Advance to next byte
-                                    ++index;
+            if (mBufferUsed == mBuffer.size())
+            {
+                Flush();
+            }
 
-#if 0
-                                    // Parse integer key
-                                    std::uint16_t tempCodepoint = ((jsonStringStream[index + 1] & 0xff) << 8) | (jsonStringStream[index + 0] & 0xff);
-                                    std::string tempKey = CodePointToString(tempCodepoint);
-                                    std::cout << "Key: " << tempKey << std::endl;
-#endif
+            mBuffer[mBufferUsed++] = value;
+        }
 
-                                    // Advance index by 2
-                                    index += 2;
+        void Write(const char* data, std::size_t size)
+        {
+            if (mOutputString != nullptr)
+            {
+                mOutputString->append(data, size);
 
-                                    // data type (1 byte) + integer key (2 byte)
-                                    typeValue.mCurrentIndex += 3;
-                                }
-                                else
-                                {
-                                    throw std::runtime_error("Other types are not supported!");
-                                }
-                            }
-                            else
-                            {
-                                // String key
-                                jsonContent += GetBSONKey(jsonStringStream, index);
-                            }
+                return;
+            }
 
-                            // Value
-                            char doubleByteArray[8] = { jsonStringStream[index + 0], jsonStringStream[index + 1], jsonStringStream[index + 2], jsonStringStream[index + 3], jsonStringStream[index + 4], jsonStringStream[index + 5], jsonStringStream[index + 6], jsonStringStream[index + 7] };
-                            double value;
-                            std::memcpy(&value, doubleByteArray, sizeof(double));
+            if (mBufferUsed + size > mBuffer.size())
+            {
+                Flush();
 
-                            index += 7;
+                // Large chunks bypass the buffer
+                if (size >= mBuffer.size())
+                {
+                    if (mGood == true)
+                    {
+                        mGood = mFlushFunction(data, size);
+                    }
 
-                            std::stringstream tempStringStream;
+                    mNumOfFlushedBytes += size;
 
-                            tempStringStream << std::fixed << std::setprecision(15) << value;
+                    return;
+                }
+            }
 
-                            jsonContent += tempStringStream.str();
+            std::memcpy(mBuffer.data() + mBufferUsed, data, size);
 
-                            if (typeMemory.empty() == false)
-                            {
-                                havJSONBSONTypeValue& typeValue = typeMemory.back();
+            mBufferUsed += size;
+        }
 
-                                if (typeValue.mType == havJSON::havJSONBSONType::Array)
-                                {
-                                    typeValue.mCurrentIndex += 8;
+        void Write(std::string_view value) { Write(value.data(), value.size()); }
 
-                                    if (typeValue.mCurrentIndex + 1 < typeValue.mTotalLength)
-                                    {
-                                        jsonContent += ", ";
-                                    }
-                                }
-                            }
-                        }
-                        break;
+        void WriteRepeated(char value, std::size_t count)
+        {
+            if (mOutputString != nullptr)
+            {
+                mOutputString->append(count, value);
 
-                    case havJSON::havJSONBSONType::JSCode:
-                    case havJSON::havJSONBSONType::String:
-                        {
-                            // Key
-                            if (typeMemory.empty() == false)
-                            {
-                                // Integer key
-                                havJSONBSONTypeValue& typeValue = typeMemory.back();
+                return;
+            }
 
-                                if (typeValue.mType == havJSON::havJSONBSONType::Array)
-                                {
-                                    // Advance to next byte
-                                    ++index;
+            while (count > 0)
+            {
+                if (mBufferUsed == mBuffer.size())
+                {
+                    Flush();
+                }
 
-#if 0
-                                    // Parse integer key
-                                    std::uint16_t tempCodepoint = ((jsonStringStream[index + 1] & 0xff) << 8) | (jsonStringStream[index + 0] & 0xff);
-                                    std::string tempKey = CodePointToString(tempCodepoint);
-                                    std::cout << "Key: " << tempKey << std::endl;
-#endif
+                std::size_t chunkSize = std::min(count, mBuffer.size() - mBufferUsed);
 
-                                    // Advance index by 2
-                                    index += 2;
+                std::memset(mBuffer.data() + mBufferUsed, value, chunkSize);
 
-                                    // data type (1 byte) + integer key (2 byte)
-                                    typeValue.mCurrentIndex += 3;
-                                }
-                                else
-                                {
-                                    throw std::runtime_error("Other types are not supported!");
-                                }
-                            }
-                            else
-                            {
-                                // String key
-                                jsonContent += GetBSONKey(jsonStringStream, index);
-                            }
+                mBufferUsed += chunkSize;
 
-                            // Value size
-                            std::string::size_type valueSize = GetBSONValueSize(jsonStringStream, index);
+                count -= chunkSize;
+            }
+        }
 
-                            // Value
-                            jsonContent += "\"";
+        bool Flush()
+        {
+            if (mBufferUsed > 0 && mGood == true)
+            {
+                mGood = mFlushFunction(mBuffer.data(), mBufferUsed);
+            }
 
-                            std::string stringValue;
+            mNumOfFlushedBytes += mBufferUsed;
+            mBufferUsed = 0;
 
-                            char newChar = jsonStringStream[index];
+            return mGood;
+        }
 
-                            while (newChar != 0x00 && stringValue.size() < valueSize)
-                            {
-                                stringValue += newChar;
+        bool IsGood() const { return mGood; }
 
-                                newChar = jsonStringStream[++index];
-                            }
+        // Bytes written so far. For a std::string sink, this is the size of the string.
+        std::size_t GetNumOfBytes() const { return (mOutputString != nullptr) ? mOutputString->size() : mNumOfFlushedBytes + mBufferUsed; }
 
-                            // Convert to escaped string
-                            stringValue = ConvertToEscapedString(stringValue);
+    private:
+        std::string* mOutputString = nullptr;
+        havJSONFlushFunction mFlushFunction;
+        std::vector<char> mBuffer;
+        std::size_t mBufferUsed = 0;
+        std::size_t mNumOfFlushedBytes = 0;
+        bool mGood = true;
+    };
 
-                            jsonContent += stringValue;
+    // Binds a struct member to an object member with the given name
+    template<typename Class, typename Member>
+    struct havJSONField
+    {
+        constexpr havJSONField(std::string_view name, Member Class::* member) : mName(name), mMember(member) {}
 
-                            jsonContent += "\"";
+        std::string_view mName;
+        Member Class::* mMember;
+    };
 
-                            if (typeMemory.empty() == false)
-                            {
-                                havJSONBSONTypeValue& typeValue = typeMemory.back();
+    // Specialize for a struct, so havJSONStream can parse it from a JSON object and write it back without building a tree. The
+    // specialization needs a static constexpr fields() function that returns a std::tuple of havJSONField values (see HAVJSON_BINDING).
+    template<typename T>
+    struct havJSONBinding
+    {
+    };
 
-                                if (typeValue.mType == havJSON::havJSONBSONType::Array)
-                                {
-                                    // Value size
-                                    typeValue.mCurrentIndex += 4;
+    template<typename T, typename = void>
+    struct havJSONIsBound : std::false_type {};
 
-                                    // String size (+ 1 = null terminator)
-                                    typeValue.mCurrentIndex += (stringValue.size() + 1);
+    template<typename T>
+    struct havJSONIsBound<T, std::void_t<decltype(havJSONBinding<T>::fields())>> : std::true_type {};
 
-                                    if (typeValue.mCurrentIndex + 1 < typeValue.mTotalLength)
-                                    {
-                                        jsonContent += ", ";
-                                    }
-                                }
-                            }
-                        }
-                        break;
+    // Member types supported by bound structs: bool, numbers, std::string, havJSONData (any value), bound structs and
+    // std::optional or std::vector of those
+    template<typename T>
+    struct havJSONIsBindable : std::bool_constant<std::is_arithmetic_v<T> || std::is_same_v<T, std::string> || std::is_same_v<T, havJSONData> || havJSONIsBound<T>::value> {};
 
-                    case havJSON::havJSONBSONType::Array:
-                        {
-                            // Key
-                            if (typeMemory.empty() == false)
-                            {
-                                // Integer key
-                                havJSONBSONTypeValue& typeValue = typeMemory.back();
+    template<typename T>
+    struct havJSONIsBindable<std::optional<T>> : havJSONIsBindable<T> {};
 
-                                if (typeValue.mType == havJSON::havJSONBSONType::Array)
-                                {
-                                    // Advance to next byte
-                                    ++index;
+    template<typename T>
+    struct havJSONIsBindable<std::vector<T>> : havJSONIsBindable<T> {};
 
-#if 0
-                                    // Parse integer key
-                                    std::uint16_t tempCodepoint = ((jsonStringStream[index + 1] & 0xff) << 8) | (jsonStringStream[index + 0] & 0xff);
-                                    std::string tempKey = CodePointToString(tempCodepoint);
-                                    std::cout << "Key: " << tempKey << std::endl;
-#endif
+    // Types that can be parsed from and written as a whole JSON text (the root node is an object or an array)
+    template<typename T>
+    struct havJSONIsBindableRoot : havJSONIsBound<T> {};
 
-                                    // Advance index by 2
-                                    index += 2;
+    template<typename T>
+    struct havJSONIsBindableRoot<std::vector<T>> : havJSONIsBindable<T> {};
 
-                                    // data type (1 byte) + integer key (2 byte)
-                                    typeValue.mCurrentIndex += 3;
-                                }
-                                else
-                                {
-                                    throw std::runtime_error("Other types are not supported!");
-                                }
-                            }
-                            else
-                            {
-                                // String key
-                                jsonContent += GetBSONKey(jsonStringStream, index);
-                            }
+// Field for a member that has the same name in C++ and JSON
+#define HAVJSON_FIELD(Type, member) havJSON::havJSONField<Type, decltype(Type::member)>(#member, &Type::member)
 
-                            // Value size
-                            std::int32_t valueSize = GetBSONValueSize(jsonStringStream, index);
+// Binds the fields to Type, e.g. HAVJSON_BINDING(Point, HAVJSON_FIELD(Point, x), HAVJSON_FIELD(Point, y)). Use it outside of any namespace.
+#define HAVJSON_BINDING(Type, ...) template<> struct havJSON::havJSONBinding<Type> { static constexpr auto fields() { return std::make_tuple(__VA_ARGS__); } }
 
-                            // Prevent off-by-one error
-                            --index;
+    // Keeps the last output of a cached ConvertJSONToString or WriteJSONFile, along with where every array and object of the tree
+    // ended up in it. The next call with the same cache copies the bytes of all containers that weren't marked as changed, and only
+    // regenerates the others. After changing the members or elements of a container (or a value in it), pass the container to
+    // markDirty; havJSONPatch does that on its own. A node that appears in the tree more than once must not be changed.
+    // Note: The cache refers to the nodes without owning them. Clear it before the havJSONDocument it was used with is cleared.
+    class havJSONSerializationCache
+    {
+    public:
+        // Marks the array or object and all containers above it as changed
+        void markDirty(const havJSONData& valueNode)
+        {
+            std::unordered_map<const havJSONData*, havJSONCacheEntry>::iterator itr = mEntries.find(&valueNode);
 
-                            // Value (4 = size of valueSize)
-                            typeMemory.push_back({ havJSON::havJSONBSONType::Array, 4, valueSize });
+            for (; itr != mEntries.end(); itr = mEntries.find(itr->second.mParent))
+            {
+                itr->second.mDirty = true;
+            }
+        }
 
-                            jsonContent += "[";
-                        }
-                        break;
+        void clear()
+        {
+            mEntries.clear();
+            mContent.clear();
+            mRootNode = nullptr;
+            mGeneration = 0;
+            mNumOfEntries = 0;
+        }
 
-                    case havJSON::havJSONBSONType::BinaryData:
-                        {
-                            // Key
-                            if (typeMemory.empty() == false)
-                            {
-                                // Integer key
-                                havJSONBSONTypeValue& typeValue = typeMemory.back();
+        // Output of the last call
+        const std::string& content() const { return mContent; }
 
-                                if (typeValue.mType == havJSON::havJSONBSONType::Array)
-                                {
-                                    // Advance to next byte
-                                    ++index;
+    private:
+        friend class havJSONWriter;
 
-#if 0
-                                    // Parse integer key
-                                    std::uint16_t tempCodepoint = ((jsonStringStream[index + 1] & 0xff) << 8) | (jsonStringStream[index + 0] & 0xff);
-                                    std::string tempKey = CodePointToString(tempCodepoint);
-                                    std::cout << "Key: " << tempKey << std::endl;
-#endif
+        struct havJSONCacheEntry
+        {
+            // Note: Expires once the node is destroyed, so a new node at the same address isn't mistaken for it
+            std::weak_ptr<havJSONData> mNode;
+            const havJSONData* mParent = nullptr;
+            // Pass in which the parent was written when the offset was taken, and pass that produced the bytes of the node
+            std::size_t mParentGeneration = 0;
+            std::size_t mGeneration = 0;
+            // Start relative to the start of the parent, so the entries below a copied container stay valid
+            std::size_t mOffset = 0;
+            std::size_t mSize = 0;
+            int mDepthLevel = 0;
+            bool mDirty = false;
+        };
 
-                                    // Advance index by 2
-                                    index += 2;
+        // Drops the previous output if it was written for another tree or with other settings
+        void Prepare(const havJSONData& rootNode, bool formatted, int indentSize)
+        {
+            if (mRootNode != &rootNode || mFormatted != formatted || mIndentSize != indentSize)
+            {
+                clear();
 
-                                    // data type (1 byte) + integer key (2 byte)
-                                    typeValue.mCurrentIndex += 3;
-                                }
-                                else
-                                {
-                                    throw std::runtime_error("Other types are not supported!");
-                                }
-                            }
-                            else
-                            {
-                                // String key
-                                jsonContent += GetBSONKey(jsonStringStream, index);
-                            }
+                mRootNode = &rootNode;
+                mFormatted = formatted;
+                mIndentSize = indentSize;
+            }
+        }
 
-                            // Value size
-                            std::int32_t valueSize = GetBSONValueSize(jsonStringStream, index);
+        // Removes the entries of destroyed nodes once the table has doubled in size since the last time
+        void RemoveExpiredEntries()
+        {
+            if (mEntries.size() <= std::max<std::size_t>(mNumOfEntries * 2, 1024))
+            {
+                return;
+            }
 
-                            // Value
-                            jsonContent += "[";
+            for (std::unordered_map<const havJSONData*, havJSONCacheEntry>::iterator itr = mEntries.begin(); itr != mEntries.end();)
+            {
+                itr = (itr->second.mNode.expired() == true) ? mEntries.erase(itr) : std::next(itr);
+            }
 
-                            std::uint8_t subtypeValue = jsonStringStream[index];
+            mNumOfEntries = mEntries.size();
+        }
 
-                            // Advance to next byte
-                            ++index;
+        std::unordered_map<const havJSONData*, havJSONCacheEntry> mEntries;
+        std::string mContent;
+        const havJSONData* mRootNode = nullptr;
+        bool mFormatted = false;
+        int mIndentSize = 0;
+        // Number of the current (or last) pass
+        std::size_t mGeneration = 0;
+        std::size_t mNumOfEntries = 0;
+    };
 
-                            // Calculate end of binary data
-                            int binaryDataEnd = index + valueSize;
+    // Writes a havJSONData tree straight to a havJSONOutputBuffer, either compact or formatted.
+    class havJSONWriter
+    {
+    public:
+        explicit havJSONWriter(bool formatted = false, int indentSize = 4) : mFormatted(formatted), mIndentSize(indentSize) {}
 
-                            // Note: We only support the generic binary subtype
-                            switch (subtypeValue)
-                            {
-                                case 0x00:
-                                case 0x02:
-                                    for (int binaryDataIndex = index; binaryDataIndex < binaryDataEnd; ++binaryDataIndex)
-                                    {
-                                        jsonContent += CodePointToString(jsonStringStream[binaryDataIndex]);
+        bool Write(const havJSONData& valueNode, havJSONOutputBuffer& output)
+        {
+            if (valueNode.isArray() == false && valueNode.isObject() == false)
+            {
+                throw std::runtime_error("Invalid token: Expected array or object as root node!");
+            }
 
-                                        if (binaryDataIndex + 1 < binaryDataEnd)
-                                        {
-                                            jsonContent += ", ";
-                                        }
-                                    }
-                                    break;
+            WriteValue(valueNode, output, 0);
 
-                                default:
-                                    if (subtypeValue >= 0x80)
-                                    {
-                                        // User defined subtype
-                                        throw std::runtime_error("User defined subtypes are unsupported!");
-                                    }
-                                    else
-                                    {
-                                        throw std::runtime_error("Unsupported subtype!");
-                                    }
-                            }
+            return output.Flush();
+        }
 
-                            jsonContent += "]";
+        // Writes any value (scalars too) without flushing the output, e.g. one NDJSON record
+        void WriteRecord(const havJSONData& valueNode, havJSONOutputBuffer& output) { WriteValue(valueNode, output, 0); }
 
-                            if (typeMemory.empty() == false)
-                            {
-                                havJSONBSONTypeValue& typeValue = typeMemory.back();
+        // Writes the tree into the output of the cache. Arrays and objects that didn't change since the last call are copied from
+        // the previous output.
+        void WriteCached(const havJSONData& valueNode, havJSONSerializationCache& cache)
+        {
+            if (valueNode.isArray() == false && valueNode.isObject() == false)
+            {
+                throw std::runtime_error("Invalid token: Expected array or object as root node!");
+            }
 
-                                if (typeValue.mType == havJSON::havJSONBSONType::Array)
-                                {
-                                    // Value size
-                                    typeValue.mCurrentIndex += 4;
+            cache.Prepare(valueNode, mFormatted, mIndentSize);
 
-                                    // Binary data size
-                                    typeValue.mCurrentIndex += valueSize;
+            std::string jsonContent;
+            jsonContent.reserve(cache.mContent.size());
 
-                                    if (typeValue.mCurrentIndex + 1 < typeValue.mTotalLength)
-                                    {
-                                        jsonContent += ", ";
-                                    }
-                                }
-                            }
-                        }
-                        break;
+            // Note: The root node is always written again, as it isn't referred to by a std::shared_ptr
+            mCache = &cache;
+            mOldIndex = (cache.mContent.empty() == true) ? NoIndex : 0;
+            mOldGeneration = cache.mGeneration++;
+            mNewIndex = 0;
 
-                    default:
-                        throw std::runtime_error("Unsupported type!");
-                }
+            try
+            {
+                havJSONOutputBuffer output(jsonContent);
 
-                if (typeMemory.empty() == false)
-                {
-                    const havJSONBSONTypeValue& typeValue = typeMemory.back();
+                WriteValue(valueNode, output, 0);
+            }
+            catch (...)
+            {
+                // Some entries refer to the incomplete output already
+                mCache = nullptr;
 
-                    if (typeValue.mCurrentIndex + 1 == typeValue.mTotalLength)
-                    {
-                        switch (typeValue.mType)
-                        {
-                            case havJSON::havJSONBSONType::Array:
-                                jsonContent += "]";
-                                break;
+                cache.clear();
 
-                            default:
-                                throw std::runtime_error("Unsupported type!");
-                        }
+                throw;
+            }
 
-                        // Skip "array end" byte, and proceed with next byte
-                        index += 2;
+            mCache = nullptr;
 
-                        typeMemory.pop_back();
+            cache.mContent = std::move(jsonContent);
 
-                        if (typeMemory.empty() == false)
-                        {
-                            havJSONBSONTypeValue& nextTypeValue = typeMemory.back();
+            cache.RemoveExpiredEntries();
+        }
 
-                            if (nextTypeValue.mType == havJSON::havJSONBSONType::Array)
-                            {
-                                // Value size
-                                nextTypeValue.mCurrentIndex += 1;
+        // Writes a bound struct (see havJSONBinding) or a std::vector of bindable values
+        template<typename T>
+        bool WriteBound(const T& value, havJSONOutputBuffer& output)
+        {
+            static_assert(havJSONIsBindableRoot<T>::value == true, "Root value must be a bound struct or a std::vector!");
 
-                                // The off-by-one error preventation is unnecessary here
+            WriteBoundValue(value, output, 0);
 
-                                if (nextTypeValue.mCurrentIndex + 1 < nextTypeValue.mTotalLength)
-                                {
-                                    jsonContent += ", ";
-                                }
-                            }
-                        }
-                    }
-                }
-                else
-                {
-                    jsonContent += ", ";
-                }
-            }
+            return output.Flush();
+        }
 
-            if (jsonStringStream[index] != 0x00)
+        static void WriteEscapedString(std::string_view value, havJSONOutputBuffer& output)
+        {
+            for (std::string_view::size_type index = 0; index < value.size(); ++index)
             {
-                throw std::runtime_error("EOO not found!");
-            }
+                // Write the run of characters that don't need escaping in one go
+                std::string_view::size_type specialIndex = havJSONScanner::FindEscapeSpecial(value.data(), index, value.size());
 
-            if (jsonContent.size() >= 2 && jsonContent.substr(jsonContent.size() - 2) == ", ")
-            {
-                jsonContent.erase(jsonContent.size() - 2);
-            }
+                if (specialIndex > index)
+                {
+                    output.Write(value.data() + index, specialIndex - index);
 
-            jsonContent += "}";
+                    index = specialIndex;
 
-            return jsonContent;
-        }
+                    if (index >= value.size())
+                    {
+                        break;
+                    }
+                }
 
-        bool Tokenization(const std::string& jsonStringStream)
-        {
-            mTokens.clear();
+                switch (value[index])
+                {
+                case '"':
+                    output.Write("\\\"", 2);
+                    break;
 
-            havJSONToken currentTypeToken = havJSONToken::None;
+                case '\\':
+                    output.Write("\\\\", 2);
+                    break;
 
-            std::deque<havJSONToken> typeTokens;
-            std::deque<int> typeTokenDepthLevels;
+                case '\b':
+                    output.Write("\\b", 2);
+                    break;
 
-            int depthLevel = 0;
+                case '\f':
+                    output.Write("\\f", 2);
+                    break;
 
-            for (std::string::size_type index = 0; index < jsonStringStream.size(); ++index)
-            {
-                char currentChar = jsonStringStream[index];
+                case '\n':
+                    output.Write("\\n", 2);
+                    break;
 
-                if (SkipWhitespaces(currentChar, false) == true)
-                {
-                    continue;
-                }
+                case '\r':
+                    output.Write("\\r", 2);
+                    break;
 
-                havJSONToken token = CheckToken(currentChar);
+                case '\t':
+                    output.Write("\\t", 2);
+                    break;
 
-                if (token != havJSONToken::None)
-                {
-                    if (token == havJSONToken::LeftCurlyBracket ||
-                        token == havJSONToken::LeftSquareBracket)
-                    {
-                        currentTypeToken = token;
+                case '\v':
+                    output.Write("\\v", 2);
+                    break;
 
-                        typeTokens.push_back(token);
+                default:
+                    {
+                        unsigned int codePoint = 0;
+                        int numOfBytes = 0;
 
-                        if (depthLevel > 0)
+                        if ((value[index] & 0x80) == 0x00)
                         {
-                            typeTokenDepthLevels.push_back(depthLevel++);
+                            // Note: Other control characters are written as code points
+                            if (value[index] < 0x20)
+                            {
+                                WriteCodeUnit(value[index] & 0x7f, output);
+                            }
+                            else
+                            {
+                                output.Write(value[index]);
+                            }
+
+                            break;
                         }
-                    }
+                        else if ((value[index] & 0xe0) == 0xc0)
+                        {
+                            numOfBytes = 2;
 
-                    mTokens.push_back(havJSONTokenValue { token, std::nullopt });
-                }
+                            codePoint = (value[index] & 0x1f);
+                        }
+                        else if ((value[index] & 0xf0) == 0xe0)
+                        {
+                            numOfBytes = 3;
 
-                if (token == havJSONToken::RightCurlyBracket ||
-                    token == havJSONToken::RightSquareBracket)
-                {
-                    if (typeTokens.empty() == false)
-                    {
-                        if (typeTokenDepthLevels.empty() == false)
+                            codePoint = (value[index] & 0x0f);
+                        }
+                        else if ((value[index] & 0xf8) == 0xf0)
                         {
-                            depthLevel = typeTokenDepthLevels.back();
-                            typeTokenDepthLevels.pop_back();
+                            numOfBytes = 4;
+
+                            codePoint = (value[index] & 0x07);
                         }
                         else
                         {
-                            depthLevel = 0;
+                            throw std::runtime_error("Invalid UTF-8 sequence!");
                         }
 
-                        currentTypeToken = typeTokens[depthLevel];
-                        typeTokens.pop_back();
-                    }
+                        for (int byteCount = 1; byteCount < numOfBytes; ++byteCount)
+                        {
+                            if (++index >= value.size() || (value[index] & 0xc0) != 0x80)
+                            {
+                                throw std::runtime_error("Invalid UTF-8 sequence!");
+                            }
 
-                    continue;
-                }
+                            codePoint = (codePoint << 6) | (value[index] & 0x3f);
+                        }
 
-                if (token == havJSONToken::Comma)
-                {
-                    token = currentTypeToken;
-                }
+                        // Code point is UTF-16 surrogate pair
+                        if (codePoint >= 0x10000 && codePoint <= 0x10ffff)
+                        {
+                            codePoint -= 0x10000;
 
-                if (token == havJSONToken::None)
-                {
-                    token = currentTypeToken;
-                    --index;
+                            WriteCodeUnit((codePoint / 0x400) + 0xd800, output);
+                            WriteCodeUnit((codePoint % 0x400) + 0xdc00, output);
+                        }
+                        else
+                        {
+                            WriteCodeUnit(codePoint, output);
+                        }
+                    }
                 }
+            }
+        }
 
-                havJSONTokenValue typeToken = CheckTypeToken(token, ++index, jsonStringStream);
+    private:
+        // Writes a \uXXXX escape sequence (lowercase hex digits, like the former std::hex output)
+        static void WriteCodeUnit(unsigned int codeUnit, havJSONOutputBuffer& output)
+        {
+            static const char hexDigits[] = "0123456789abcdef";
 
-                if (typeToken.mToken != havJSONToken::None)
-                {
-                    if (typeToken.mToken == havJSONToken::LeftCurlyBracket ||
-                        typeToken.mToken == havJSONToken::LeftSquareBracket)
-                    {
-                        currentTypeToken = typeToken.mToken;
+            const char escapeSequence[6] = { '\\', 'u', hexDigits[(codeUnit >> 12) & 0x0f], hexDigits[(codeUnit >> 8) & 0x0f], hexDigits[(codeUnit >> 4) & 0x0f], hexDigits[codeUnit & 0x0f] };
 
-                        typeTokens.push_back(currentTypeToken);
+            output.Write(escapeSequence, 6);
+        }
 
-                        typeTokenDepthLevels.push_back(depthLevel++);
+        template<typename T>
+        static void WriteNumber(T value, havJSONOutputBuffer& output)
+        {
+            char buffer[havJSONNumberConverter::BufferSize];
+
+            output.Write(buffer, havJSONNumberConverter::ToChars(value, buffer));
+        }
+
+        void WriteNewLine(havJSONOutputBuffer& output, int depthLevel)
+        {
+            output.Write('\n');
+
+            output.WriteRepeated(' ', static_cast<std::size_t>(depthLevel * mIndentSize));
+        }
+
+        void WriteValue(const havJSONData& valueNode, havJSONOutputBuffer& output, int depthLevel)
+        {
+            const havJSONData::havJSONVariant& value = valueNode.getValueRef();
+
+            switch (valueNode.getType())
+            {
+                case havJSONDataType::Null:
+                    output.Write("null", 4);
+                    break;
+
+                case havJSONDataType::Boolean:
+                    if (std::get<bool>(value) == true)
+                    {
+                        output.Write("true", 4);
                     }
                     else
                     {
-                        mTokens.push_back(typeToken);
+                        output.Write("false", 5);
                     }
-                }
-            }
+                    break;
 
-#if 0
-            int leftSquareCount = 0;
-            int rightSquareCount = 0;
-            int leftCurlyCount = 0;
-            int rightCurlyCount = 0;
+                case havJSONDataType::Int:
+                    WriteNumber(std::get<int>(value), output);
+                    break;
 
-            for (std::deque<havJSONTokenValue>::size_type index = 0; index < mTokens.size(); ++index)
-            {
-                std::string type;
+                case havJSONDataType::UInt:
+                    WriteNumber(std::get<unsigned int>(value), output);
+                    break;
 
-                switch (mTokens[index].mToken)
-                {
-                case havJSONToken::None:
-                    type = "None";
+                case havJSONDataType::Long:
+                    WriteNumber(std::get<long>(value), output);
                     break;
 
-                // Structural tokens
-                case havJSONToken::LeftSquareBracket:
-                    ++leftSquareCount;
-                    type = "LeftSquareBracket";
+                case havJSONDataType::ULong:
+                    WriteNumber(std::get<unsigned long>(value), output);
                     break;
 
-                case havJSONToken::LeftCurlyBracket:
-                    ++leftCurlyCount;
-                    type = "LeftCurlyBracket";
+                case havJSONDataType::Int64:
+                    WriteNumber(std::get<long long>(value), output);
                     break;
 
-                case havJSONToken::RightSquareBracket:
-                    ++rightSquareCount;
-                    type = "RightSquareBracket";
+                case havJSONDataType::UInt64:
+                    WriteNumber(std::get<unsigned long long>(value), output);
                     break;
 
-                case havJSONToken::RightCurlyBracket:
-                    ++rightCurlyCount;
-                    type = "RightCurlyBracket";
+                case havJSONDataType::Double:
+                    WriteNumber(std::get<double>(value), output);
                     break;
 
-                case havJSONToken::Colon:
-                    type = "Colon";
+                case havJSONDataType::String:
+                    output.Write('"');
+                    WriteEscapedString(std::get<std::string>(value), output);
+                    output.Write('"');
                     break;
 
-                case havJSONToken::Comma:
-                    type = "Comma";
-                    break;
+                case havJSONDataType::Array:
+                    {
+                        const std::vector<std::shared_ptr<havJSONData>>& arrayValue = std::get<std::vector<std::shared_ptr<havJSONData>>>(value);
 
-                // Generic type tokens
-                case havJSONToken::Null:
-                    type = "Null";
-                    break;
+                        output.Write('[');
 
-                case havJSONToken::Boolean:
-                    type = "Boolean";
-                    break;
+                        for (std::vector<std::shared_ptr<havJSONData>>::size_type index = 0; index < arrayValue.size(); ++index)
+                        {
+                            if (index > 0)
+                            {
+                                output.Write(',');
+                            }
 
-                case havJSONToken::Int:
-                    type = "Int";
-                    break;
+                            if (mFormatted == true)
+                            {
+                                WriteNewLine(output, depthLevel + 1);
+                            }
 
-                case havJSONToken::UInt:
-                    type = "UInt";
-                    break;
+                            WriteElement(arrayValue[index], valueNode, output, depthLevel + 1);
+                        }
 
-                case havJSONToken::Long:
-                    type = "Long";
-                    break;
+                        if (mFormatted == true && arrayValue.empty() == false)
+                        {
+                            WriteNewLine(output, depthLevel);
+                        }
 
-                case havJSONToken::ULong:
-                    type = "ULong";
+                        output.Write(']');
+                    }
                     break;
 
-                case havJSONToken::Int64:
-                    type = "Int64";
-                    break;
+                case havJSONDataType::Object:
+                    {
+                        const havJSONObject& objectValue = std::get<havJSONObject>(value);
 
-                case havJSONToken::UInt64:
-                    type = "UInt64";
-                    break;
+                        output.Write('{');
 
-                case havJSONToken::Double:
-                    type = "Double";
-                    break;
+                        for (havJSONObject::const_iterator itr = objectValue.begin(); itr != objectValue.end(); ++itr)
+                        {
+                            if (itr != objectValue.begin())
+                            {
+                                output.Write(',');
+                            }
 
-                case havJSONToken::String:
-                    type = "String";
-                    break;
+                            if (mFormatted == true)
+                            {
+                                WriteNewLine(output, depthLevel + 1);
+                            }
 
-                case havJSONToken::Value:
-                    type = "Value";
+                            output.Write('"');
+                            WriteEscapedString((*itr).first, output);
+                            output.Write('"');
+
+                            if (mFormatted == true)
+                            {
+                                output.Write(": ", 2);
+                            }
+                            else
+                            {
+                                output.Write(':');
+                            }
+
+                            WriteElement((*itr).second, valueNode, output, depthLevel + 1);
+                        }
+
+                        if (mFormatted == true && objectValue.empty() == false)
+                        {
+                            WriteNewLine(output, depthLevel);
+                        }
+
+                        output.Write('}');
+                    }
                     break;
+            }
+        }
 
-                default:
-                    type = "Unsupported token type!";
-                }
+        // Writes a member or element of parentNode. With a cache, arrays and objects that didn't change are copied from the previous output.
+        void WriteElement(const std::shared_ptr<havJSONData>& elementNode, const havJSONData& parentNode, havJSONOutputBuffer& output, int depthLevel)
+        {
+            if (mCache == nullptr || (elementNode->isArray() == false && elementNode->isObject() == false))
+            {
+                WriteValue(*elementNode, output, depthLevel);
 
-                if (mTokens[index].mValue.has_value() == true)
+                return;
+            }
+
+            std::size_t parentOldIndex = mOldIndex;
+            std::size_t parentOldGeneration = mOldGeneration;
+            std::size_t parentNewIndex = mNewIndex;
+            std::size_t newIndex = output.GetNumOfBytes();
+
+            // Note: References to the entries stay valid when the table grows
+            havJSONSerializationCache::havJSONCacheEntry& entry = mCache->mEntries[elementNode.get()];
+
+            // The node is part of the previous output of the parent if it was written below the same parent, in the pass that
+            // produced the parent's previous bytes
+            bool isKnown = parentOldIndex != NoIndex && entry.mParent == &parentNode && entry.mParentGeneration == parentOldGeneration && entry.mNode.expired() == false;
+
+            // Note: Formatted output depends on the depth, so a container that moved up or down is written again
+            if (isKnown == true && entry.mDirty == false && (mFormatted == false || entry.mDepthLevel == depthLevel))
+            {
+                output.Write(mCache->mContent.data() + parentOldIndex + entry.mOffset, entry.mSize);
+            }
+            else
+            {
+                mOldIndex = (isKnown == true) ? parentOldIndex + entry.mOffset : NoIndex;
+                mOldGeneration = entry.mGeneration;
+                mNewIndex = newIndex;
+
+                WriteValue(*elementNode, output, depthLevel);
+
+                mOldIndex = parentOldIndex;
+                mOldGeneration = parentOldGeneration;
+                mNewIndex = parentNewIndex;
+
+                entry.mGeneration = mCache->mGeneration;
+                entry.mDirty = false;
+            }
+
+            entry.mNode = elementNode;
+            entry.mParent = &parentNode;
+            entry.mParentGeneration = mCache->mGeneration;
+            entry.mOffset = newIndex - parentNewIndex;
+            entry.mSize = output.GetNumOfBytes() - newIndex;
+            entry.mDepthLevel = depthLevel;
+        }
+
+        template<typename T>
+        void WriteBoundValue(const T& value, havJSONOutputBuffer& output, int depthLevel)
+        {
+            static_assert(havJSONIsBindable<T>::value == true, "Unsupported member type!");
+
+            if constexpr (std::is_same_v<T, bool> == true)
+            {
+                if (value == true)
                 {
-                    std::cout << std::setfill('0') << std::setw(5) << index << ": " << type << " -> " << mTokens[index].mValue.value() << "\n";
+                    output.Write("true", 4);
                 }
                 else
                 {
-                    std::cout << std::setfill('0') << std::setw(5) << index << ": " << type << "\n";
+                    output.Write("false", 5);
                 }
             }
+            else if constexpr (std::is_arithmetic_v<T> == true)
+            {
+                WriteNumber(value, output);
+            }
+            else if constexpr (std::is_same_v<T, std::string> == true)
+            {
+                output.Write('"');
+                WriteEscapedString(value, output);
+                output.Write('"');
+            }
+            else if constexpr (std::is_same_v<T, havJSONData> == true)
+            {
+                WriteValue(value, output, depthLevel);
+            }
+            else
+            {
+                output.Write('{');
 
-            std::cout << "left square count: " << leftSquareCount << "\n";
-            std::cout << "right square count: " << rightSquareCount << "\n";
-            std::cout << "left curly count: " << leftCurlyCount << "\n";
-            std::cout << "right curly count: " << rightCurlyCount << "\n";
-#endif
+                WriteBoundMembers(value, output, depthLevel, std::make_index_sequence<std::tuple_size_v<decltype(havJSONBinding<T>::fields())>>());
 
-            return mTokens.size() > 0;
+                output.Write('}');
+            }
         }
 
-        bool ParseJSONContents(havJSONData& valueNode)
+        template<typename T>
+        void WriteBoundValue(const std::optional<T>& value, havJSONOutputBuffer& output, int depthLevel)
         {
-            if (mTokens.empty() == true)
+            if (value.has_value() == false)
             {
-                return false;
+                output.Write("null", 4);
             }
-
-            // Check if the root node is an object or array
-            if (mTokens[0].mToken != havJSONToken::LeftCurlyBracket &&
-                mTokens[0].mToken != havJSONToken::LeftSquareBracket)
+            else
             {
-                return false;
+                WriteBoundValue(*value, output, depthLevel);
             }
+        }
 
-            std::deque<havJSONData*> tokenTypeReferences;
-            std::unique_ptr<havJSONData> rootNode = nullptr;
+        template<typename T>
+        void WriteBoundValue(const std::vector<T>& value, havJSONOutputBuffer& output, int depthLevel)
+        {
+            output.Write('[');
 
-            while (mTokens.empty() == false)
+            for (typename std::vector<T>::size_type index = 0; index < value.size(); ++index)
             {
-                havJSONTokenValue token = mTokens.front();
-
-                if (token.mToken == havJSONToken::Comma)
+                if (index > 0)
                 {
-                    mTokens.pop_front();
-
-                    continue;
+                    output.Write(',');
                 }
 
-                // Check if we're dealing with an object
-                if (token.mToken == havJSONToken::LeftCurlyBracket)
+                if (mFormatted == true)
                 {
-                    if (rootNode != nullptr)
-                    {
-                        if (tokenTypeReferences.back()->getType() == havJSONDataType::Array)
-                        {
-                            std::vector<std::shared_ptr<havJSONData>>* item = std::get_if<std::vector<std::shared_ptr<havJSONData>>>(tokenTypeReferences.back()->getAddress());
+                    WriteNewLine(output, depthLevel + 1);
+                }
 
-                            std::map<std::string, std::shared_ptr<havJSONData>> tmpObject;
-                            item->push_back(std::make_shared<havJSONData>(std::move(tmpObject), havJSONDataType::Object));
+                // Note: Binding the element to const T& works for std::vector<bool> too
+                const T& element = value[index];
 
-                            tokenTypeReferences.push_back(item->back().get());
-                        }
-                    }
+                WriteBoundValue(element, output, depthLevel + 1);
+            }
 
-                    if (rootNode == nullptr)
-                    {
-                        std::map<std::string, std::shared_ptr<havJSONData>> tmpObject;
-                        rootNode = std::make_unique<havJSONData>(std::move(tmpObject), havJSONDataType::Object);
+            if (mFormatted == true && value.empty() == false)
+            {
+                WriteNewLine(output, depthLevel);
+            }
 
-                        tokenTypeReferences.push_back(rootNode.get());
-                    }
+            output.Write(']');
+        }
 
-                    mTokens.pop_front();
-                    token = mTokens.front();
+        template<typename T, std::size_t... Indices>
+        void WriteBoundMembers(const T& value, havJSONOutputBuffer& output, int depthLevel, std::index_sequence<Indices...>)
+        {
+            // Note: Unused for structs without fields
+            [[maybe_unused]] constexpr auto fields = havJSONBinding<T>::fields();
 
-                    // Check if the next token is valid
-                    if (token.mToken != havJSONToken::String &&
-                        token.mToken != havJSONToken::Value &&
-                        token.mToken != havJSONToken::Null &&
-                        token.mToken != havJSONToken::Boolean &&
-                        token.mToken != havJSONToken::Int &&
-                        token.mToken != havJSONToken::UInt &&
-                        token.mToken != havJSONToken::Long &&
-                        token.mToken != havJSONToken::ULong &&
-                        token.mToken != havJSONToken::Int64 &&
-                        token.mToken != havJSONToken::UInt64 &&
-                        token.mToken != havJSONToken::Double &&
-                        token.mToken != havJSONToken::Colon &&
-                        token.mToken != havJSONToken::Comma &&
-                        token.mToken != havJSONToken::RightCurlyBracket &&
-                        token.mToken != havJSONToken::LeftCurlyBracket &&
-                        token.mToken != havJSONToken::LeftSquareBracket)
-                    {
-                        return false;
-                    }
+            // Note: Expands to one write per field, each specialized for the type of its member
+            (WriteBoundMember(std::get<Indices>(fields).mName, value.*(std::get<Indices>(fields).mMember), output, depthLevel, Indices == 0), ...);
 
-                    if (token.mToken == havJSONToken::LeftCurlyBracket ||
-                        token.mToken == havJSONToken::LeftSquareBracket)
-                    {
-                        continue;
-                    }
-                }
+            if (mFormatted == true && sizeof...(Indices) > 0)
+            {
+                WriteNewLine(output, depthLevel);
+            }
+        }
 
-                // Check if we're dealing with an array
-                if (token.mToken == havJSONToken::LeftSquareBracket)
-                {
-                    if (rootNode != nullptr)
-                    {
-                        if (tokenTypeReferences.back()->getType() == havJSONDataType::Array)
-                        {
-                            std::vector<std::shared_ptr<havJSONData>>* item = std::get_if<std::vector<std::shared_ptr<havJSONData>>>(tokenTypeReferences.back()->getAddress());
+        template<typename T>
+        void WriteBoundMember(std::string_view name, const T& value, havJSONOutputBuffer& output, int depthLevel, bool isFirst)
+        {
+            if (isFirst == false)
+            {
+                output.Write(',');
+            }
 
-                            std::vector<std::shared_ptr<havJSONData>> tmpArray;
-                            item->push_back(std::make_shared<havJSONData>(std::move(tmpArray), havJSONDataType::Array));
+            if (mFormatted == true)
+            {
+                WriteNewLine(output, depthLevel + 1);
+            }
 
-                            tokenTypeReferences.push_back(item->back().get());
-                        }
-                    }
+            output.Write('"');
+            WriteEscapedString(name, output);
+            output.Write('"');
 
-                    if (rootNode == nullptr)
-                    {
-                        std::vector<std::shared_ptr<havJSONData>> tmpArray;
-                        rootNode = std::make_unique<havJSONData>(std::move(tmpArray), havJSONDataType::Array);
+            if (mFormatted == true)
+            {
+                output.Write(": ", 2);
+            }
+            else
+            {
+                output.Write(':');
+            }
 
-                        tokenTypeReferences.push_back(rootNode.get());
-                    }
+            WriteBoundValue(value, output, depthLevel + 1);
+        }
 
-                    mTokens.pop_front();
-                    token = mTokens.front();
+        static constexpr std::size_t NoIndex = std::numeric_limits<std::size_t>::max();
 
-                    // Check if the next token is valid
-                    if (token.mToken != havJSONToken::Value &&
-                        token.mToken != havJSONToken::Null &&
-                        token.mToken != havJSONToken::Boolean &&
-                        token.mToken != havJSONToken::Int &&
-                        token.mToken != havJSONToken::UInt &&
-                        token.mToken != havJSONToken::Long &&
-                        token.mToken != havJSONToken::ULong &&
-                        token.mToken != havJSONToken::Int64 &&
-                        token.mToken != havJSONToken::UInt64 &&
-                        token.mToken != havJSONToken::Double &&
-                        token.mToken != havJSONToken::Comma &&
-                        token.mToken != havJSONToken::RightSquareBracket &&
-                        token.mToken != havJSONToken::LeftSquareBracket &&
-                        token.mToken != havJSONToken::LeftCurlyBracket)
-                    {
-                        return false;
-                    }
+        bool mFormatted;
+        int mIndentSize;
 
-                    if (token.mToken == havJSONToken::LeftSquareBracket ||
-                        token.mToken == havJSONToken::LeftCurlyBracket)
-                    {
+        // Set while WriteCached runs, along with where the container that's being written starts in the previous and the new output
+        havJSONSerializationCache* mCache = nullptr;
+        std::size_t mOldIndex = NoIndex;
+        std::size_t mOldGeneration = 0;
+        std::size_t mNewIndex = 0;
+    };
+
+    // Encodes a havJSONData tree as BSON in a single pass. Document and array lengths are reserved up front and back-patched
+    // once their elements have been written, so the output never has to be shifted.
+    class havJSONBSONWriter
+    {
+    public:
+        // Appends the BSON document to output. Reuse the same vector across calls to keep its capacity.
+        void Write(const havJSONData& valueNode, std::vector<char>& output)
+        {
+            if (valueNode.isObject() == false)
+            {
+                throw std::runtime_error("BSON document must be an object!");
+            }
+
+            mOutput = &output;
+
+            if (mOutput->capacity() - mOutput->size() < InitialCapacity)
+            {
+                mOutput->reserve(mOutput->size() + InitialCapacity);
+            }
+
+            WriteDocument(valueNode);
+
+            mOutput = nullptr;
+        }
+
+    private:
+        static constexpr std::size_t InitialCapacity = 4096;
+
+        template<typename T>
+        static void StoreLittleEndian(T value, char* destination)
+        {
+            typedef std::conditional_t<sizeof(T) == 8, std::uint64_t, std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint8_t>> havJSONBSONRawType;
+
+            havJSONBSONRawType rawValue;
+            std::memcpy(&rawValue, &value, sizeof(T));
+
+            for (std::size_t byteIndex = 0; byteIndex < sizeof(T); ++byteIndex)
+            {
+                destination[byteIndex] = static_cast<char>(static_cast<std::uint8_t>(rawValue >> (byteIndex * 8)));
+            }
+        }
+
+        template<typename T>
+        void WriteValue(T value)
+        {
+            char buffer[sizeof(T)];
+
+            StoreLittleEndian(value, buffer);
+
+            mOutput->insert(mOutput->end(), buffer, buffer + sizeof(T));
+        }
+
+        // Writes a null-terminated string (element names)
+        void WriteCString(std::string_view value)
+        {
+            if (value.find('\0') != std::string_view::npos)
+            {
+                throw std::runtime_error("BSON keys can't contain null characters!");
+            }
+
+            mOutput->insert(mOutput->end(), value.begin(), value.end());
+            mOutput->push_back(0x00);
+        }
+
+        void WriteElement(std::string_view key, const havJSONData& valueNode)
+        {
+            const havJSONData::havJSONVariant& value = valueNode.getValueRef();
+
+            // Type byte position, the actual type is only known for some values after looking at them
+            std::size_t typeIndex = mOutput->size();
+
+            mOutput->push_back(0x00);
+
+            WriteCString(key);
+
+            havJSONBSONType bsonType;
+
+            switch (valueNode.getType())
+            {
+                case havJSONDataType::Null:
+                    bsonType = havJSONBSONType::NullValue;
+                    break;
+
+                case havJSONDataType::Boolean:
+                    bsonType = havJSONBSONType::Boolean;
+                    mOutput->push_back(std::get<bool>(value) == true ? 0x01 : 0x00);
+                    break;
+
+                case havJSONDataType::Int:
+                    bsonType = havJSONBSONType::Int;
+                    WriteValue(static_cast<std::int32_t>(std::get<int>(value)));
+                    break;
+
+                case havJSONDataType::UInt:
+                    // Note: BSON has no unsigned 32-bit integer, so large values are widened
+                    if (std::get<unsigned int>(value) <= static_cast<unsigned int>(std::numeric_limits<std::int32_t>::max()))
+                    {
+                        bsonType = havJSONBSONType::Int;
+                        WriteValue(static_cast<std::int32_t>(std::get<unsigned int>(value)));
+                    }
+                    else
+                    {
+                        bsonType = havJSONBSONType::Int64;
+                        WriteValue(static_cast<std::int64_t>(std::get<unsigned int>(value)));
+                    }
+                    break;
+
+                case havJSONDataType::Long:
+                    bsonType = havJSONBSONType::Int64;
+                    WriteValue(static_cast<std::int64_t>(std::get<long>(value)));
+                    break;
+
+                case havJSONDataType::Int64:
+                    bsonType = havJSONBSONType::Int64;
+                    WriteValue(std::get<long long>(value));
+                    break;
+
+                case havJSONDataType::ULong:
+                    // Note: Unsigned 64-bit integers are stored as timestamps, the only unsigned 64-bit BSON type
+                    bsonType = havJSONBSONType::Timestamp;
+                    WriteValue(static_cast<std::uint64_t>(std::get<unsigned long>(value)));
+                    break;
+
+                case havJSONDataType::UInt64:
+                    bsonType = havJSONBSONType::Timestamp;
+                    WriteValue(std::get<unsigned long long>(value));
+                    break;
+
+                case havJSONDataType::Double:
+                    bsonType = havJSONBSONType::Double;
+                    WriteValue(std::get<double>(value));
+                    break;
+
+                case havJSONDataType::String:
+                    {
+                        const std::string& stringValue = std::get<std::string>(value);
+
+                        if (stringValue.size() >= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()))
+                        {
+                            throw std::runtime_error("BSON string exceeds maximum size!");
+                        }
+
+                        bsonType = havJSONBSONType::String;
+
+                        // String size includes the null terminator
+                        WriteValue(static_cast<std::int32_t>(stringValue.size() + 1));
+
+                        mOutput->insert(mOutput->end(), stringValue.begin(), stringValue.end());
+                        mOutput->push_back(0x00);
+                    }
+                    break;
+
+                case havJSONDataType::Array:
+                    bsonType = havJSONBSONType::Array;
+                    WriteDocument(valueNode);
+                    break;
+
+                case havJSONDataType::Object:
+                    bsonType = havJSONBSONType::Document;
+                    WriteDocument(valueNode);
+                    break;
+
+                default:
+                    throw std::runtime_error("Unsupported type!");
+            }
+
+            (*mOutput)[typeIndex] = static_cast<char>(bsonType);
+        }
+
+        // Writes an object, or an array with its indices as keys, as a length-prefixed document
+        void WriteDocument(const havJSONData& valueNode)
+        {
+            std::size_t documentIndex = mOutput->size();
+
+            // Placeholder for the document size
+            mOutput->insert(mOutput->end(), 4, 0x00);
+
+            if (valueNode.isArray() == true)
+            {
+                const std::vector<std::shared_ptr<havJSONData>>& arrayValue = std::get<std::vector<std::shared_ptr<havJSONData>>>(valueNode.getValueRef());
+
+                char keyBuffer[havJSONNumberConverter::BufferSize];
+
+                for (std::vector<std::shared_ptr<havJSONData>>::size_type index = 0; index < arrayValue.size(); ++index)
+                {
+                    std::to_chars_result result = std::to_chars(keyBuffer, keyBuffer + sizeof(keyBuffer), index);
+
+                    WriteElement(std::string_view(keyBuffer, result.ptr - keyBuffer), *arrayValue[index]);
+                }
+            }
+            else
+            {
+                const havJSONObject& objectValue = std::get<havJSONObject>(valueNode.getValueRef());
+
+                for (havJSONObject::const_iterator itr = objectValue.begin(); itr != objectValue.end(); ++itr)
+                {
+                    WriteElement((*itr).first, *(*itr).second);
+                }
+            }
+
+            // Null terminator
+            mOutput->push_back(0x00);
+
+            std::size_t documentSize = mOutput->size() - documentIndex;
+
+            if (documentSize > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()))
+            {
+                throw std::runtime_error("BSON document exceeds maximum size!");
+            }
+
+            StoreLittleEndian(static_cast<std::int32_t>(documentSize), mOutput->data() + documentIndex);
+        }
+
+        std::vector<char>* mOutput = nullptr;
+    };
+
+    // Receives the events of havJSONStream::ParseContent(..., havJSONSAXHandler&) without building a tree. Override the events
+    // you're interested in; returning false stops parsing. Strings and names are only valid for the duration of the call.
+    class havJSONSAXHandler
+    {
+    public:
+        virtual ~havJSONSAXHandler() = default;
+
+        virtual bool onObjectBegin() { return true; }
+        virtual bool onObjectEnd() { return true; }
+        virtual bool onArrayBegin() { return true; }
+        virtual bool onArrayEnd() { return true; }
+        virtual bool onKey(std::string_view /* key */) { return true; }
+        virtual bool onNull() { return true; }
+        virtual bool onBoolean(bool /* value */) { return true; }
+        virtual bool onInt64(long long /* value */) { return true; }
+        // Only called for integers above the range of long long
+        virtual bool onUInt64(unsigned long long /* value */) { return true; }
+        virtual bool onDouble(double /* value */) { return true; }
+        virtual bool onString(std::string_view /* value */) { return true; }
+    };
+
+    // Limits for untrusted input. A parse fails at the first limit that's exceeded, before the rest of the input is read. Only the
+    // nesting depth is limited by default, the other limits are off.
+    struct havJSONParseOptions
+    {
+        // Nesting depth of arrays and objects, the root node is at depth 1. The recursive parsers never go deeper than
+        // HAVJSON_MAX_RECURSION_DEPTH, whatever this is set to.
+        std::size_t mMaxDepth = 1024;
+        // Size of the input
+        std::size_t mMaxBytes = std::numeric_limits<std::size_t>::max();
+        // Size of a decoded string or name in bytes
+        std::size_t mMaxStringLength = std::numeric_limits<std::size_t>::max();
+        // Number of nodes in the tree (SAX handlers and bound structs don't create nodes)
+        std::size_t mMaxNodes = std::numeric_limits<std::size_t>::max();
+    };
+
+    enum class havJSONErrorCode : std::uint8_t
+    {
+        None,
+        // The file couldn't be opened
+        FileNotOpened,
+        // The input contains nothing but whitespace
+        EmptyInput,
+        // The input ends inside a value, e.g. because it was truncated
+        UnexpectedEnd,
+        SyntaxError,
+        // A havJSONParseOptions limit was exceeded
+        LimitExceeded,
+        InvalidBSON,
+        // The output file couldn't be encoded or written (only reported by havJSONBatchConverter)
+        FileNotWritten
+    };
+
+    inline const char* GetErrorMessage(havJSONErrorCode errorCode)
+    {
+        switch (errorCode)
+        {
+            case havJSONErrorCode::None: return "No error";
+            case havJSONErrorCode::FileNotOpened: return "Unable to open file";
+            case havJSONErrorCode::EmptyInput: return "Input is empty";
+            case havJSONErrorCode::UnexpectedEnd: return "Unexpected end of input";
+            case havJSONErrorCode::SyntaxError: return "Syntax error";
+            case havJSONErrorCode::LimitExceeded: return "Parse limit exceeded";
+            case havJSONErrorCode::InvalidBSON: return "Invalid BSON document";
+            case havJSONErrorCode::FileNotWritten: return "Unable to write file";
+            default: return "Unknown error";
+        }
+    }
+
+    // Outcome of a parse. Line and column start at 1 and are 0 where they don't apply (BSON input, or a file that was rejected
+    // before its contents were read).
+    struct havJSONResult
+    {
+        havJSONErrorCode mCode = havJSONErrorCode::None;
+        // Byte offset into the input at which the error was detected
+        std::size_t mOffset = 0;
+        std::size_t mLine = 0;
+        std::size_t mColumn = 0;
+
+        bool failed() const { return mCode != havJSONErrorCode::None; }
+
+        const char* message() const { return GetErrorMessage(mCode); }
+    };
+
+    // Thrown inside the parsers when a havJSONParseOptions limit is exceeded. The parse functions catch it and return false.
+    class havJSONLimitError : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    // Splits a JSON Pointer (RFC 6901) into its decoded reference tokens. The empty pointer refers to the whole document and has none.
+    inline std::vector<std::string> SplitJSONPointer(std::string_view pointer)
+    {
+        std::vector<std::string> tokens;
+
+        if (pointer.empty() == true)
+        {
+            return tokens;
+        }
+
+        if (pointer[0] != '/')
+        {
+            throw std::runtime_error("Invalid JSON pointer!");
+        }
+
+        std::size_t index = 1;
+
+        while (true)
+        {
+            std::size_t endIndex = std::min(pointer.find('/', index), pointer.size());
+
+            std::string token;
+
+            for (std::size_t tokenIndex = index; tokenIndex < endIndex; ++tokenIndex)
+            {
+                if (pointer[tokenIndex] == '~')
+                {
+                    if (tokenIndex + 1 >= endIndex || (pointer[tokenIndex + 1] != '0' && pointer[tokenIndex + 1] != '1'))
+                    {
+                        throw std::runtime_error("Invalid escape sequence in JSON pointer!");
+                    }
+
+                    token += (pointer[++tokenIndex] == '0') ? '~' : '/';
+                }
+                else
+                {
+                    token += pointer[tokenIndex];
+                }
+            }
+
+            tokens.push_back(std::move(token));
+
+            if (endIndex >= pointer.size())
+            {
+                break;
+            }
+
+            index = endIndex + 1;
+        }
+
+        return tokens;
+    }
+
+    // Set of JSON Pointers (RFC 6901, e.g. "/statuses/0/text") that selects the parts of a document to parse. A "*" segment
+    // matches every member or element. Values that aren't selected are skipped by matching quotation marks and brackets only.
+    class havJSONFilter
+    {
+    public:
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        havJSONFilter() = default;
+
+        havJSONFilter(std::initializer_list<std::string_view> paths)
+        {
+            for (std::string_view path : paths)
+            {
+                addPath(path);
+            }
+        }
+
+        // Selects the value at the path and everything below it. The empty path selects the whole document.
+        void addPath(std::string_view path)
+        {
+            AddSegments(0, SplitJSONPointer(path), 0);
+        }
+
+        // Selects the member of the root object with the given name. Unlike addPath, the name isn't decoded.
+        void addKey(std::string_view key)
+        {
+            AddSegments(0, { std::string(key) }, 0);
+        }
+
+        // The root node of the filter is 0. Returns the node of the member or element below nodeIndex, or npos if it isn't selected.
+        std::size_t findChild(std::size_t nodeIndex, std::string_view key) const
+        {
+            const havJSONFilterNode& node = mNodes[nodeIndex];
+
+            for (const std::pair<std::string, std::size_t>& child : node.mChildren)
+            {
+                if (child.first == key)
+                {
+                    return child.second;
+                }
+            }
+
+            return node.mWildcardChild;
+        }
+
+        std::size_t findChild(std::size_t nodeIndex, std::size_t elementIndex) const
+        {
+            char buffer[24];
+
+            std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), elementIndex);
+
+            return findChild(nodeIndex, std::string_view(buffer, result.ptr - buffer));
+        }
+
+        // True if the whole value at nodeIndex is selected
+        bool isSelected(std::size_t nodeIndex) const { return mNodes[nodeIndex].mSelected; }
+
+    private:
+        struct havJSONFilterNode
+        {
+            std::vector<std::pair<std::string, std::size_t>> mChildren;
+            std::size_t mWildcardChild = npos;
+            bool mSelected = false;
+        };
+
+        // Note: Named children start out as a copy of the wildcard child, so a lookup only has to follow a single node
+        void AddSegments(std::size_t nodeIndex, const std::vector<std::string>& segments, std::size_t segmentIndex)
+        {
+            if (mNodes[nodeIndex].mSelected == true)
+            {
+                return;
+            }
+
+            if (segmentIndex == segments.size())
+            {
+                // Everything below is selected already, so paths below this node don't matter anymore
+                mNodes[nodeIndex] = havJSONFilterNode();
+                mNodes[nodeIndex].mSelected = true;
+
+                return;
+            }
+
+            const std::string& key = segments[segmentIndex];
+
+            if (key == "*")
+            {
+                if (mNodes[nodeIndex].mWildcardChild == npos)
+                {
+                    std::size_t childIndex = mNodes.size();
+
+                    mNodes.emplace_back();
+                    mNodes[nodeIndex].mWildcardChild = childIndex;
+                }
+
+                AddSegments(mNodes[nodeIndex].mWildcardChild, segments, segmentIndex + 1);
+
+                // Note: Adding segments may grow mNodes, so it's indexed again every time
+                for (std::size_t index = 0; index < mNodes[nodeIndex].mChildren.size(); ++index)
+                {
+                    AddSegments(mNodes[nodeIndex].mChildren[index].second, segments, segmentIndex + 1);
+                }
+
+                return;
+            }
+
+            std::size_t childIndex = npos;
+
+            for (const std::pair<std::string, std::size_t>& child : mNodes[nodeIndex].mChildren)
+            {
+                if (child.first == key)
+                {
+                    childIndex = child.second;
+                }
+            }
+
+            if (childIndex == npos)
+            {
+                childIndex = (mNodes[nodeIndex].mWildcardChild != npos) ? CopyNode(mNodes[nodeIndex].mWildcardChild) : AddNode();
+
+                mNodes[nodeIndex].mChildren.emplace_back(key, childIndex);
+            }
+
+            AddSegments(childIndex, segments, segmentIndex + 1);
+        }
+
+        std::size_t AddNode()
+        {
+            mNodes.emplace_back();
+
+            return mNodes.size() - 1;
+        }
+
+        std::size_t CopyNode(std::size_t nodeIndex)
+        {
+            std::size_t copyIndex = AddNode();
+
+            mNodes[copyIndex].mSelected = mNodes[nodeIndex].mSelected;
+
+            if (mNodes[nodeIndex].mWildcardChild != npos)
+            {
+                std::size_t childIndex = CopyNode(mNodes[nodeIndex].mWildcardChild);
+
+                mNodes[copyIndex].mWildcardChild = childIndex;
+            }
+
+            for (std::size_t index = 0; index < mNodes[nodeIndex].mChildren.size(); ++index)
+            {
+                std::size_t childIndex = CopyNode(mNodes[nodeIndex].mChildren[index].second);
+
+                mNodes[copyIndex].mChildren.emplace_back(mNodes[nodeIndex].mChildren[index].first, childIndex);
+            }
+
+            return copyIndex;
+        }
+
+        std::vector<havJSONFilterNode> mNodes = std::vector<havJSONFilterNode>(1);
+    };
+
+    // Applies JSON Patch (RFC 6902) and JSON Merge Patch (RFC 7386) documents to a tree in place. With a serialization cache, the
+    // arrays and objects that change are marked in it, so the next cached ConvertJSONToString only writes those again.
+    class havJSONPatch
+    {
+    public:
+        havJSONPatch() = default;
+
+        explicit havJSONPatch(havJSONSerializationCache& cache) : mCache(&cache) {}
+
+        // Applies the operations of the patch (an array) in order. Returns false if an operation is malformed, refers to a value
+        // that doesn't exist or fails its test. The operations before it stay applied.
+        bool apply(havJSONData& rootNode, const havJSONData& patchNode)
+        {
+            if (patchNode.isArray() == false)
+            {
+                return false;
+            }
+
+            for (const std::shared_ptr<havJSONData>& operationNode : std::get<std::vector<std::shared_ptr<havJSONData>>>(patchNode.getValueRef()))
+            {
+                if (ApplyOperation(rootNode, *operationNode) == false)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // Merges the patch into the tree: Members of the patch replace the members of the tree, null members remove them and
+        // objects are merged recursively. A patch that isn't an object replaces the whole tree.
+        void applyMerge(havJSONData& rootNode, const havJSONData& patchNode)
+        {
+            if (patchNode.isObject() == false)
+            {
+                rootNode = std::move(*CopyValue(patchNode));
+
+                return;
+            }
+
+            // Note: The root node is always written again by the cache, so it doesn't matter that it's replaced here
+            if (rootNode.isObject() == false)
+            {
+                rootNode = havJSONData(havJSONDataType::Object);
+            }
+
+            MergeObject(rootNode, patchNode);
+        }
+
+        // Compares two values the way JSON Patch tests them: Numbers by value, objects independent of the member order
+        static bool isEqual(const havJSONData& valueNode, const havJSONData& otherValueNode)
+        {
+            bool isNumber = IsNumber(valueNode);
+
+            if (isNumber == true || IsNumber(otherValueNode) == true)
+            {
+                return isNumber == true && IsNumber(otherValueNode) == true && IsEqualNumber(valueNode.getValueRef(), otherValueNode.getValueRef());
+            }
+
+            if (valueNode.getType() != otherValueNode.getType())
+            {
+                return false;
+            }
+
+            switch (valueNode.getType())
+            {
+                case havJSONDataType::Null:
+                    return true;
+
+                case havJSONDataType::Boolean:
+                    return std::get<bool>(valueNode.getValueRef()) == std::get<bool>(otherValueNode.getValueRef());
+
+                case havJSONDataType::String:
+                    return std::get<std::string>(valueNode.getValueRef()) == std::get<std::string>(otherValueNode.getValueRef());
+
+                case havJSONDataType::Array:
+                    {
+                        const std::vector<std::shared_ptr<havJSONData>>& arrayValue = std::get<std::vector<std::shared_ptr<havJSONData>>>(valueNode.getValueRef());
+                        const std::vector<std::shared_ptr<havJSONData>>& otherArrayValue = std::get<std::vector<std::shared_ptr<havJSONData>>>(otherValueNode.getValueRef());
+
+                        return std::equal(arrayValue.begin(), arrayValue.end(), otherArrayValue.begin(), otherArrayValue.end(),
+                                          [](const std::shared_ptr<havJSONData>& item, const std::shared_ptr<havJSONData>& otherItem) { return isEqual(*item, *otherItem); });
+                    }
+
+                case havJSONDataType::Object:
+                    {
+                        const havJSONObject& objectValue = std::get<havJSONObject>(valueNode.getValueRef());
+                        const havJSONObject& otherObjectValue = std::get<havJSONObject>(otherValueNode.getValueRef());
+
+                        if (objectValue.size() != otherObjectValue.size())
+                        {
+                            return false;
+                        }
+
+                        for (const auto& member : objectValue)
+                        {
+                            havJSONObject::const_iterator itr = otherObjectValue.find(member.first);
+
+                            if (itr == otherObjectValue.end() || isEqual(*member.second, *itr->second) == false)
+                            {
+                                return false;
+                            }
+                        }
+
+                        return true;
+                    }
+
+                default:
+                    return false;
+            }
+        }
+
+    private:
+        bool ApplyOperation(havJSONData& rootNode, const havJSONData& operationNode)
+        {
+            if (operationNode.isObject() == false)
+            {
+                return false;
+            }
+
+            const havJSONObject& operationObject = std::get<havJSONObject>(operationNode.getValueRef());
+
+            const std::string* operation = FindString(operationObject, "op");
+            const std::string* path = FindString(operationObject, "path");
+
+            std::vector<std::string> pathTokens;
+
+            if (operation == nullptr || path == nullptr || SplitPointer(*path, pathTokens) == false)
+            {
+                return false;
+            }
+
+            havJSONObject::const_iterator valueItr = operationObject.find("value");
+
+            const havJSONData* value = (valueItr != operationObject.end()) ? valueItr->second.get() : nullptr;
+
+            if (*operation == "add")
+            {
+                return value != nullptr && AddValue(rootNode, pathTokens, CopyValue(*value));
+            }
+
+            if (*operation == "remove")
+            {
+                return RemoveValue(rootNode, pathTokens) != nullptr;
+            }
+
+            if (*operation == "replace")
+            {
+                // Note: Unlike add, replace requires the value to exist
+                return value != nullptr && FindValue(rootNode, pathTokens) != nullptr && AddValue(rootNode, pathTokens, CopyValue(*value), true);
+            }
+
+            if (*operation == "test")
+            {
+                const havJSONData* targetNode = FindValue(rootNode, pathTokens);
+
+                return value != nullptr && targetNode != nullptr && isEqual(*targetNode, *value);
+            }
+
+            if (*operation == "move" || *operation == "copy")
+            {
+                const std::string* from = FindString(operationObject, "from");
+
+                std::vector<std::string> fromTokens;
+
+                if (from == nullptr || SplitPointer(*from, fromTokens) == false)
+                {
+                    return false;
+                }
+
+                if (*operation == "copy")
+                {
+                    const havJSONData* sourceNode = FindValue(rootNode, fromTokens);
+
+                    return sourceNode != nullptr && AddValue(rootNode, pathTokens, CopyValue(*sourceNode));
+                }
+
+                if (fromTokens == pathTokens)
+                {
+                    return FindValue(rootNode, fromTokens) != nullptr;
+                }
+
+                // A value can't be moved into one of its own children
+                if (fromTokens.size() < pathTokens.size() && std::equal(fromTokens.begin(), fromTokens.end(), pathTokens.begin()) == true)
+                {
+                    return false;
+                }
+
+                // Note: The node itself is moved, so the cache can still copy its bytes if it stays below the same parent
+                std::shared_ptr<havJSONData> sourceNode = RemoveValue(rootNode, fromTokens);
+
+                return sourceNode != nullptr && AddValue(rootNode, pathTokens, std::move(sourceNode));
+            }
+
+            return false;
+        }
+
+        static bool SplitPointer(const std::string& pointer, std::vector<std::string>& tokens)
+        {
+            try
+            {
+                tokens = SplitJSONPointer(pointer);
+            }
+            catch (const std::runtime_error&)
+            {
+                return false;
+            }
+
+            return true;
+        }
+
+        static const std::string* FindString(const havJSONObject& objectValue, const char* key)
+        {
+            havJSONObject::const_iterator itr = objectValue.find(key);
+
+            return (itr != objectValue.end()) ? std::get_if<std::string>(&itr->second->getValueRef()) : nullptr;
+        }
+
+        // Array indices can't have leading zeros. Returns false for "-" (past the last element) as well.
+        static bool ParseIndex(const std::string& token, std::size_t& index)
+        {
+            if (token.empty() == true || token.size() > 18 || (token.size() > 1 && token[0] == '0') ||
+                std::all_of(token.begin(), token.end(), [](char currentChar) { return currentChar >= '0' && currentChar <= '9'; }) == false)
+            {
+                return false;
+            }
+
+            std::from_chars(token.data(), token.data() + token.size(), index);
+
+            return true;
+        }
+
+        // Returns the member or element of the container named by token, or nullptr
+        static std::shared_ptr<havJSONData>* FindChild(havJSONData& containerNode, const std::string& token)
+        {
+            if (havJSONObject* objectValue = std::get_if<havJSONObject>(containerNode.getAddress()))
+            {
+                havJSONObject::iterator itr = objectValue->find(token);
+
+                return (itr != objectValue->end()) ? &itr->second : nullptr;
+            }
+
+            if (std::vector<std::shared_ptr<havJSONData>>* arrayValue = std::get_if<std::vector<std::shared_ptr<havJSONData>>>(containerNode.getAddress()))
+            {
+                std::size_t index = 0;
+
+                return (ParseIndex(token, index) == true && index < arrayValue->size()) ? &(*arrayValue)[index] : nullptr;
+            }
+
+            return nullptr;
+        }
+
+        // Returns the value at the first numOfTokens tokens of the path, or nullptr
+        static havJSONData* FindValue(havJSONData& rootNode, const std::vector<std::string>& tokens, std::size_t numOfTokens)
+        {
+            havJSONData* valueNode = &rootNode;
+
+            for (std::size_t index = 0; index < numOfTokens && valueNode != nullptr; ++index)
+            {
+                std::shared_ptr<havJSONData>* childNode = FindChild(*valueNode, tokens[index]);
+
+                valueNode = (childNode != nullptr) ? childNode->get() : nullptr;
+            }
+
+            return valueNode;
+        }
+
+        static havJSONData* FindValue(havJSONData& rootNode, const std::vector<std::string>& tokens) { return FindValue(rootNode, tokens, tokens.size()); }
+
+        // Adds the value at the path, or replaces the one that's there. Array elements are inserted, unless replaceElement is set.
+        bool AddValue(havJSONData& rootNode, const std::vector<std::string>& tokens, std::shared_ptr<havJSONData> valueNode, bool replaceElement = false)
+        {
+            if (tokens.empty() == true)
+            {
+                rootNode = std::move(*valueNode);
+
+                return true;
+            }
+
+            havJSONData* parentNode = FindValue(rootNode, tokens, tokens.size() - 1);
+
+            if (parentNode == nullptr)
+            {
+                return false;
+            }
+
+            const std::string& token = tokens.back();
+
+            if (havJSONObject* objectValue = std::get_if<havJSONObject>(parentNode->getAddress()))
+            {
+                havJSONObject::iterator itr = objectValue->find(token);
+
+                if (itr != objectValue->end())
+                {
+                    itr->second = std::move(valueNode);
+                }
+                else
+                {
+                    objectValue->insert({ token, std::move(valueNode) });
+                }
+            }
+            else if (std::vector<std::shared_ptr<havJSONData>>* arrayValue = std::get_if<std::vector<std::shared_ptr<havJSONData>>>(parentNode->getAddress()))
+            {
+                std::size_t index = arrayValue->size();
+
+                if ((token != "-" || replaceElement == true) && (ParseIndex(token, index) == false || index > arrayValue->size() || (replaceElement == true && index == arrayValue->size())))
+                {
+                    return false;
+                }
+
+                if (replaceElement == true)
+                {
+                    (*arrayValue)[index] = std::move(valueNode);
+                }
+                else
+                {
+                    arrayValue->insert(arrayValue->begin() + index, std::move(valueNode));
+                }
+            }
+            else
+            {
+                return false;
+            }
+
+            MarkDirty(*parentNode);
+
+            return true;
+        }
+
+        // Removes the value at the path and returns it, or nullptr if it doesn't exist. The root node can't be removed.
+        std::shared_ptr<havJSONData> RemoveValue(havJSONData& rootNode, const std::vector<std::string>& tokens)
+        {
+            havJSONData* parentNode = (tokens.empty() == false) ? FindValue(rootNode, tokens, tokens.size() - 1) : nullptr;
+
+            std::shared_ptr<havJSONData>* childNode = (parentNode != nullptr) ? FindChild(*parentNode, tokens.back()) : nullptr;
+
+            if (childNode == nullptr)
+            {
+                return nullptr;
+            }
+
+            std::shared_ptr<havJSONData> valueNode = std::move(*childNode);
+
+            if (havJSONObject* objectValue = std::get_if<havJSONObject>(parentNode->getAddress()))
+            {
+                objectValue->erase(tokens.back());
+            }
+            else
+            {
+                std::vector<std::shared_ptr<havJSONData>>& arrayValue = std::get<std::vector<std::shared_ptr<havJSONData>>>(*parentNode->getAddress());
+
+                arrayValue.erase(arrayValue.begin() + (childNode - arrayValue.data()));
+            }
+
+            MarkDirty(*parentNode);
+
+            return valueNode;
+        }
+
+        void MergeObject(havJSONData& objectNode, const havJSONData& patchNode)
+        {
+            havJSONObject& objectValue = std::get<havJSONObject>(*objectNode.getAddress());
+
+            bool isChanged = false;
+
+            for (const auto& member : std::get<havJSONObject>(patchNode.getValueRef()))
+            {
+                havJSONObject::iterator itr = objectValue.find(member.first);
+
+                if (member.second->isNull() == true)
+                {
+                    if (itr != objectValue.end())
+                    {
+                        objectValue.erase(itr);
+
+                        isChanged = true;
+                    }
+
+                    continue;
+                }
+
+                // Note: Objects are merged into the existing node, so only the members that change are written again
+                if (member.second->isObject() == true && itr != objectValue.end() && itr->second->isObject() == true)
+                {
+                    MergeObject(*itr->second, *member.second);
+
+                    continue;
+                }
+
+                std::shared_ptr<havJSONData> valueNode;
+
+                if (member.second->isObject() == true)
+                {
+                    // Note: Merging into an empty object drops the null members of the patch
+                    valueNode = std::make_shared<havJSONData>(havJSONDataType::Object);
+
+                    MergeObject(*valueNode, *member.second);
+                }
+                else
+                {
+                    valueNode = CopyValue(*member.second);
+                }
+
+                if (itr != objectValue.end())
+                {
+                    itr->second = std::move(valueNode);
+                }
+                else
+                {
+                    objectValue.insert({ member.first, std::move(valueNode) });
+                }
+
+                isChanged = true;
+            }
+
+            if (isChanged == true)
+            {
+                MarkDirty(objectNode);
+            }
+        }
+
+        void MarkDirty(const havJSONData& containerNode)
+        {
+            if (mCache != nullptr)
+            {
+                mCache->markDirty(containerNode);
+            }
+        }
+
+        // Copies the value and everything below it, so the tree doesn't share nodes with the patch
+        static std::shared_ptr<havJSONData> CopyValue(const havJSONData& valueNode)
+        {
+            if (const std::vector<std::shared_ptr<havJSONData>>* arrayValue = std::get_if<std::vector<std::shared_ptr<havJSONData>>>(&valueNode.getValueRef()))
+            {
+                std::vector<std::shared_ptr<havJSONData>> elements;
+                elements.reserve(arrayValue->size());
+
+                for (const std::shared_ptr<havJSONData>& item : *arrayValue)
+                {
+                    elements.push_back(CopyValue(*item));
+                }
+
+                return std::make_shared<havJSONData>(std::move(elements), havJSONDataType::Array);
+            }
+
+            if (const havJSONObject* objectValue = std::get_if<havJSONObject>(&valueNode.getValueRef()))
+            {
+                havJSONObject members;
+
+                for (const auto& member : *objectValue)
+                {
+                    members.insert({ member.first, CopyValue(*member.second) });
+                }
+
+                return std::make_shared<havJSONData>(std::move(members), havJSONDataType::Object);
+            }
+
+            return std::make_shared<havJSONData>(valueNode);
+        }
+
+        static bool IsNumber(const havJSONData& valueNode)
+        {
+            havJSONDataType valueType = valueNode.getType();
+
+            return valueType != havJSONDataType::Null && valueType != havJSONDataType::Boolean && valueType != havJSONDataType::String &&
+                   valueType != havJSONDataType::Array && valueType != havJSONDataType::Object;
+        }
+
+        // Integers are compared exactly, everything else as double
+        static bool IsEqualNumber(const havJSONData::havJSONVariant& value, const havJSONData::havJSONVariant& otherValue)
+        {
+            return std::visit([](const auto& number, const auto& otherNumber)
+            {
+                typedef std::decay_t<decltype(number)> NumberType;
+                typedef std::decay_t<decltype(otherNumber)> OtherNumberType;
+
+                if constexpr (std::is_arithmetic_v<NumberType> == false || std::is_arithmetic_v<OtherNumberType> == false ||
+                              std::is_same_v<NumberType, bool> == true || std::is_same_v<OtherNumberType, bool> == true)
+                {
+                    return false;
+                }
+                else if constexpr (std::is_floating_point_v<NumberType> == true || std::is_floating_point_v<OtherNumberType> == true)
+                {
+                    return static_cast<double>(number) == static_cast<double>(otherNumber);
+                }
+                else if constexpr (std::is_signed_v<NumberType> == std::is_signed_v<OtherNumberType>)
+                {
+                    return number == otherNumber;
+                }
+                else if constexpr (std::is_signed_v<NumberType> == true)
+                {
+                    return number >= 0 && static_cast<std::make_unsigned_t<NumberType>>(number) == otherNumber;
+                }
+                else
+                {
+                    return otherNumber >= 0 && number == static_cast<std::make_unsigned_t<OtherNumberType>>(otherNumber);
+                }
+            }, value, otherValue);
+        }
+
+        havJSONSerializationCache* mCache = nullptr;
+    };
+
+    class havJSONStream
+    {
+    public:
+        havJSONStream() {}
+        ~havJSONStream() {}
+
+        bool SkipWhitespaces(char currentChar, bool ignoreSpace)
+        {
+            if (ignoreSpace == false)
+            {
+                if (currentChar == ' ')
+                {
+                    return true;
+                }
+            }
+
+            if (currentChar == '\\' || currentChar == '/' || currentChar == '\b' || currentChar == '\f' ||
+                currentChar == '\n' || currentChar == '\r' || currentChar == '\t' || currentChar == '\v')
+            {
+                return true;
+            }
+
+            return false;
+        }
+
+        havJSONToken CheckToken(char currentChar)
+        {
+            switch (currentChar)
+            {
+                case '[': return havJSONToken::LeftSquareBracket;
+                case '{': return havJSONToken::LeftCurlyBracket;
+                case ']': return havJSONToken::RightSquareBracket;
+                case '}': return havJSONToken::RightCurlyBracket;
+                case ':': return havJSONToken::Colon;
+                case ',': return havJSONToken::Comma;
+                default: return havJSONToken::None;
+            }
+        }
+
+        char GetTokenAsCharacter(havJSONToken currentToken)
+        {
+            switch (currentToken)
+            {
+                case havJSONToken::LeftSquareBracket: return '[';
+                case havJSONToken::LeftCurlyBracket: return '{';
+                case havJSONToken::RightSquareBracket: return ']';
+                case havJSONToken::RightCurlyBracket: return '}';
+                case havJSONToken::Colon: return ':';
+                case havJSONToken::Comma: return ',';
+                default: return '\0';
+            }
+        }
+
+        std::string CodePointToString(const unsigned int codePoint)
+        {
+            // Note: null-terminated string
+            char value[5] = { '\0' };
+
+            if (codePoint < 0x80)
+            {
+                value[0] = codePoint;
+            }
+            else if (codePoint < 0x800)
+            {
+                value[0] = (codePoint >> 6) | 0xc0;
+                value[1] = (codePoint & 0x3f) | 0x80;
+            }
+            else if (codePoint < 0x10000)
+            {
+                value[0] = (codePoint >> 12) | 0xe0;
+                value[1] = ((codePoint >> 6) & 0x3f) | 0x80;
+                value[2] = (codePoint & 0x3f) | 0x80;
+            }
+            else if (codePoint < 0x110000)
+            {
+                value[0] = (codePoint >> 18) | 0xf0;
+                value[1] = ((codePoint >> 12) & 0x3f) | 0x80;
+                value[2] = ((codePoint >> 6) & 0x3f) | 0x80;
+                value[3] = (codePoint & 0x3f) | 0x80;
+            }
+
+            return std::string(value);
+        }
+
+        static bool IsHexDigit(char currentChar)
+        {
+            return (currentChar >= '0' && currentChar <= '9') || (currentChar >= 'a' && currentChar <= 'f') || (currentChar >= 'A' && currentChar <= 'F');
+        }
+
+        std::string ConvertToEscapedString(const std::string& value)
+        {
+            std::string resultValue;
+
+            // Note: Most strings need no or only a few escape sequences
+            resultValue.reserve(value.size());
+
+            havJSONOutputBuffer outputBuffer(resultValue);
+
+            havJSONWriter::WriteEscapedString(value, outputBuffer);
+
+            return resultValue;
+        }
+
+        havJSONTokenValue CheckForString(std::string_view::size_type& index, std::string_view jsonStringStream)
+        {
+            std::string tempValue;
+
+            ReadStringValue(index, jsonStringStream, tempValue);
+
+            return havJSONTokenValue { havJSONToken::Value, std::move(tempValue) };
+        }
+
+        // Reads the string starting at the quotation mark at index into tempValue. On return, index points to the closing quotation mark.
+        void ReadStringValue(std::string_view::size_type& index, std::string_view jsonStringStream, std::string& tempValue)
+        {
+            ++index;
+
+            for (; index < jsonStringStream.size(); ++index)
+            {
+                // Copy the run of plain characters up to the next quotation mark or backslash in one go
+                std::string_view::size_type specialIndex = havJSONScanner::FindStringSpecial(jsonStringStream.data(), index, jsonStringStream.size());
+
+                if (specialIndex > index)
+                {
+                    // Note: The length is checked before the run is copied
+                    CheckStringLength(tempValue.size() + (specialIndex - index));
+
+                    tempValue.append(jsonStringStream.data() + index, specialIndex - index);
+
+                    index = specialIndex;
+
+                    if (index >= jsonStringStream.size())
+                    {
+                        break;
+                    }
+                }
+
+                char currentChar = jsonStringStream[index];
+
+                switch (currentChar)
+                {
+                case '"':
+                    CheckStringLength(tempValue.size());
+                    return;
+
+                case '\\':
+                    {
+                        if (++index >= jsonStringStream.size())
+                        {
+                            throw std::runtime_error("Read beyond end of file!");
+                        }
+
+                        currentChar = jsonStringStream[index];
+
+                        switch (currentChar)
+                        {
+                        case '"':
+                        case '\\':
+                        case '/':
+                            tempValue += currentChar;
+                            break;
+
+                        case 'b':
+                            tempValue += '\b';
+                            break;
+
+                        case 'f':
+                            tempValue += '\f';
+                            break;
+
+                        case 'n':
+                            tempValue += '\n';
+                            break;
+
+                        case 'r':
+                            tempValue += '\r';
+                            break;
+
+                        case 't':
+                            tempValue += '\t';
+                            break;
+
+                        case 'u':
+                            {
+                                std::string hexString;
+
+                                bool isUnicodeEscapeSequence = false;
+
+                                for (int valueIndex = 0; valueIndex < 4; ++valueIndex)
+                                {
+                                    if (++index >= jsonStringStream.size())
+                                    {
+                                        throw std::runtime_error("Read beyond end of file!");
+                                    }
+
+                                    char currentCharInLoop = jsonStringStream[index];
+
+                                    if (IsHexDigit(currentCharInLoop) == false)
+                                    {
+                                        isUnicodeEscapeSequence = false;
+
+                                        break;
+                                    }
+                                    else
+                                    {
+                                        isUnicodeEscapeSequence = true;
+                                    }
+
+                                    hexString += currentCharInLoop;
+                                }
+
+                                if (isUnicodeEscapeSequence == true)
+                                {
+                                    unsigned int codePoint = std::strtol(hexString.c_str(), nullptr, 16);
+
+                                    if (++index >= jsonStringStream.size())
+                                    {
+                                        throw std::runtime_error("Read beyond end of file!");
+                                    }
+
+                                    if (jsonStringStream[index] == '\\')
+                                    {
+                                        if (++index >= jsonStringStream.size())
+                                        {
+                                            throw std::runtime_error("Read beyond end of file!");
+                                        }
+
+                                        if (jsonStringStream[index] == 'u')
+                                        {
+                                            bool surrogatePair = false;
+
+                                            hexString = "";
+
+                                            for (int valueIndex = 0; valueIndex < 4; ++valueIndex)
+                                            {
+                                                if (++index >= jsonStringStream.size())
+                                                {
+                                                    throw std::runtime_error("Read beyond end of file!");
+                                                }
+
+                                                char currentCharInLoop = jsonStringStream[index];
+
+                                                if (IsHexDigit(currentCharInLoop) == false)
+                                                {
+                                                    surrogatePair = false;
+
+                                                    break;
+                                                }
+                                                else
+                                                {
+                                                    surrogatePair = true;
+                                                }
+
+                                                hexString += currentCharInLoop;
+                                            }
+
+                                            if (surrogatePair == true)
+                                            {
+                                                if (codePoint >= 0xd800 && codePoint <= 0xdbff)
+                                                {
+                                                    unsigned int secondCodePoint = std::strtol(hexString.c_str(), nullptr, 16);
+
+                                                    if (secondCodePoint >= 0xdc00 && secondCodePoint <= 0xdfff)
+                                                    {
+                                                        // codePoint = high surrogate, secondCodePoint = low surrogate
+                                                        unsigned int surrogatePairValue = 0x10000 + ((codePoint - 0xd800) * 0x400) + (secondCodePoint - 0xdc00);
+
+                                                        tempValue += CodePointToString(surrogatePairValue);
+                                                    }
+                                                    else
+                                                    {
+                                                        throw std::runtime_error("Invalid code point range for UTF-16 low surrogate pair!");
+                                                    }
+                                                }
+                                                else
+                                                {
+                                                    // Set the index back by six characters, otherwise the possible next UTF-8 sequence isn't processed!
+                                                    index -= 6;
+
+                                                    tempValue += CodePointToString(codePoint);
+                                                }
+                                            }
+                                            else
+                                            {
+                                                throw std::runtime_error("Invalid code point for UTF-16 low surrogate pair!");
+                                            }
+                                        }
+                                        else
+                                        {
+                                            // Set the index back by two characters, otherwise the next characters aren't processed!
+                                            index -= 2;
+
+                                            tempValue += CodePointToString(codePoint);
+                                        }
+                                    }
+                                    else
+                                    {
+                                        // Set the index back by one character, otherwise the next character isn't processed!
+                                        --index;
+
+                                        tempValue += CodePointToString(codePoint);
+                                    }
+                                }
+                                else
+                                {
+                                    // Set the index back by one character, otherwise the next character isn't processed!
+                                    --index;
+
+                                    // Don't eat the u character
+                                    tempValue += currentChar;
+
+                                    if (hexString.size() > 0)
+                                    {
+                                        tempValue += hexString;
+                                    }
+                                }
+                            }
+                            break;
+
+                        case 'v':
+                            tempValue += '\v';
+                            break;
+
+                        default:
+                            throw std::runtime_error("Invalid escape character!");
+                        }
+                    }
+                    break;
+
+                default:
+                    tempValue += currentChar;
+                }
+            }
+
+            throw std::runtime_error("Invalid string value!");
+        }
+
+        havJSONTokenValue CheckForNumber(std::string_view::size_type& index, std::string_view jsonStringStream)
+        {
+            // Note: index points past the first character of the number
+            std::string_view::size_type startIndex = index - 1;
+
+            bool isFloatingPoint = false;
+
+            std::string_view::size_type endIndex = startIndex;
+
+            // Note: The tokenizer doesn't require separators, so without the check "01" would be read as two numbers
+            if (havJSONNumberConverter::Scan(endIndex, jsonStringStream, isFloatingPoint) == false ||
+                (endIndex < jsonStringStream.size() && havJSONNumberConverter::IsNumberCharacter(jsonStringStream[endIndex]) == true))
+            {
+                throw std::runtime_error("Unable to read number value!");
+            }
+
+            index = endIndex - 1;
+
+            std::string_view numberValue = jsonStringStream.substr(startIndex, endIndex - startIndex);
+
+            // The token keeps the original characters, so values are converted exactly once when the tree is built
+            return havJSONNumberConverter::Convert(numberValue, isFloatingPoint, [numberValue](auto result)
+            {
+                typedef decltype(result) ResultType;
+
+                havJSONToken token = havJSONToken::Double;
+
+                if constexpr (std::is_same_v<ResultType, int> == true) { token = havJSONToken::Int; }
+                else if constexpr (std::is_same_v<ResultType, unsigned int> == true) { token = havJSONToken::UInt; }
+                else if constexpr (std::is_same_v<ResultType, long> == true) { token = havJSONToken::Long; }
+                else if constexpr (std::is_same_v<ResultType, unsigned long> == true) { token = havJSONToken::ULong; }
+                else if constexpr (std::is_same_v<ResultType, long long> == true) { token = havJSONToken::Int64; }
+                else if constexpr (std::is_same_v<ResultType, unsigned long long> == true) { token = havJSONToken::UInt64; }
+
+                return havJSONTokenValue { token, std::string(numberValue) };
+            });
+        }
+
+        std::string CheckForLiteral(std::string_view::size_type& index, std::string_view jsonStringStream, const std::string& literalValue)
+        {
+            std::string tempValue(1, literalValue[0]);
+
+            std::string::size_type stringIndex = 1;
+
+            for (; index < jsonStringStream.size(); ++index)
+            {
+                char currentChar = jsonStringStream[index];
+
+                if (currentChar != literalValue[stringIndex++])
+                {
+                    throw std::runtime_error("Literal value invalid: " + literalValue);
+                }
+
+                tempValue += currentChar;
+
+                if (tempValue == literalValue)
+                {
+                    break;
+                }
+            }
+
+            if (tempValue.size() != literalValue.size())
+            {
+                throw std::runtime_error("Invalid literal value!");
+            }
+
+            return tempValue;
+        }
+
+        havJSONTokenValue CheckTypeToken(havJSONToken structuralToken, std::string_view::size_type& index, std::string_view jsonStringStream)
+        {
+            // Object
+            if (structuralToken == havJSONToken::LeftCurlyBracket)
+            {
+                for (; index < jsonStringStream.size(); ++index)
+                {
+                    char currentChar = jsonStringStream[index];
+
+                    if (SkipWhitespaces(currentChar, false) == true)
+                    {
+                        continue;
+                    }
+
+                    havJSONToken token = CheckToken(currentChar);
+
+                    if (token != havJSONToken::None)
+                    {
+                        AddToken(havJSONTokenValue { token, std::nullopt }, index + 1);
+
+                        continue;
+                    }
+
+                    switch (currentChar)
+                    {
+                    case '"':
+                        {
+                            havJSONTokenValue result = CheckForString(index, jsonStringStream);
+
+                            result.mToken = havJSONToken::String;
+
+                            return result;
+                        }
+                        break;
+
+                    default:
+                        return havJSONTokenValue { havJSONToken::None, std::nullopt };
+                    }
+                }
+            }
+            // Array
+            else if (structuralToken == havJSONToken::LeftSquareBracket)
+            {
+                for (; index < jsonStringStream.size(); ++index)
+                {
+                    char currentChar = jsonStringStream[index];
+
+                    if (SkipWhitespaces(currentChar, false) == true)
+                    {
+                        continue;
+                    }
+
+                    switch (currentChar)
+                    {
+                    case '"':
+                    case 't':
+                    case 'f':
+                    case 'n':
+                    case 'u':
+                    case '-':
+                    case '+':
+                    case '.':
+                    case ':':
+                    case '0':
+                    case '1':
+                    case '2':
+                    case '3':
+                    case '4':
+                    case '5':
+                    case '6':
+                    case '7':
+                    case '8':
+                    case '9':
+                    case 'e':
+                    case 'E':
+                        {
+                            if (currentChar == '"')
+                            {
+                                return CheckForString(index, jsonStringStream);
+                            }
+                            else
+                            {
+                                havJSONToken tempToken = havJSONToken::Value;
+
+                                std::optional<std::string> value;
+
+                                std::string tempValue;
+
+                                ++index;
+
+                                if (currentChar == 't')
+                                {
+                                    tempValue = CheckForLiteral(index, jsonStringStream, "true");
+
+                                    tempToken = havJSONToken::Boolean;
+                                }
+
+                                if (currentChar == 'f')
+                                {
+                                    tempValue = CheckForLiteral(index, jsonStringStream, "false");
+
+                                    tempToken = havJSONToken::Boolean;
+                                }
+
+                                if (currentChar == 'n')
+                                {
+                                    tempValue = CheckForLiteral(index, jsonStringStream, "null");
+
+                                    tempToken = havJSONToken::Null;
+                                }
+
+                                if (currentChar == '-' ||
+                                    currentChar == '+' ||
+                                    currentChar == '.' ||
+                                    currentChar == ':' ||
+                                    currentChar == '0' ||
+                                    currentChar == '1' ||
+                                    currentChar == '2' ||
+                                    currentChar == '3' ||
+                                    currentChar == '4' ||
+                                    currentChar == '5' ||
+                                    currentChar == '6' ||
+                                    currentChar == '7' ||
+                                    currentChar == '8' ||
+                                    currentChar == '9' ||
+                                    currentChar == 'e' ||
+                                    currentChar == 'E')
+                                {
+                                    return CheckForNumber(index, jsonStringStream);
+                                }
+
+                                // Note: E.g. a 'u' isn't the start of any literal
+                                if (tempValue.empty() == true)
+                                {
+                                    throw std::runtime_error("Invalid literal value!");
+                                }
+
+                                value = tempValue;
+
+                                return havJSONTokenValue { tempToken, ((value.has_value() == false) ? std::nullopt : value) };
+                            }
+                        }
+                        break;
+
+                    case '{':
+                        AddToken(havJSONTokenValue { havJSONToken::LeftCurlyBracket, std::nullopt }, index + 1);
+                        return havJSONTokenValue { havJSONToken::LeftCurlyBracket, std::nullopt };
+
+                    case '[':
+                        AddToken(havJSONTokenValue { havJSONToken::LeftSquareBracket, std::nullopt }, index + 1);
+                        return havJSONTokenValue { havJSONToken::LeftSquareBracket, std::nullopt };
+
+                    case ']':
+                        // Empty array: Step back, so the caller handles the closing bracket
+                        --index;
+                        return havJSONTokenValue { havJSONToken::None, std::nullopt };
+
+                    default:
+                        return havJSONTokenValue { havJSONToken::None, std::nullopt };
+                    }
+                }
+            }
+            // Other types (e.g. Value)
+            else
+            {
+                for (; index < jsonStringStream.size(); ++index)
+                {
+                    char currentChar = jsonStringStream[index];
+
+                    if (SkipWhitespaces(currentChar, false) == true)
+                    {
+                        continue;
+                    }
+
+                    havJSONToken token = CheckToken(currentChar);
+
+                    if (token != havJSONToken::None)
+                    {
+                        AddToken(havJSONTokenValue { token, std::nullopt }, index + 1);
+                    }
+
+                    if (token == havJSONToken::None)
+                    {
+                        switch (currentChar)
+                        {
+                        case '"':
+                        case 't':
+                        case 'f':
+                        case 'n':
+                        case 'u':
+                        case '-':
+                        case '+':
+                        case '.':
+                        case ':':
+                        case '0':
+                        case '1':
+                        case '2':
+                        case '3':
+                        case '4':
+                        case '5':
+                        case '6':
+                        case '7':
+                        case '8':
+                        case '9':
+                        case 'e':
+                        case 'E':
+                            {
+                                if (currentChar == '"')
+                                {
+                                    return CheckForString(index, jsonStringStream);
+                                }
+                                else
+                                {
+                                    havJSONToken tempToken = havJSONToken::Value;
+
+                                    std::optional<std::string> value;
+
+                                    std::string tempValue;
+
+                                    ++index;
+
+                                    if (currentChar == 't')
+                                    {
+                                        tempValue = CheckForLiteral(index, jsonStringStream, "true");
+
+                                        tempToken = havJSONToken::Boolean;
+                                    }
+
+                                    if (currentChar == 'f')
+                                    {
+                                        tempValue = CheckForLiteral(index, jsonStringStream, "false");
+
+                                        tempToken = havJSONToken::Boolean;
+                                    }
+
+                                    if (currentChar == 'n')
+                                    {
+                                        tempValue = CheckForLiteral(index, jsonStringStream, "null");
+
+                                        tempToken = havJSONToken::Null;
+                                    }
+
+                                    if (currentChar == '-' ||
+                                        currentChar == '+' ||
+                                        currentChar == '.' ||
+                                        currentChar == ':' ||
+                                        currentChar == '0' ||
+                                        currentChar == '1' ||
+                                        currentChar == '2' ||
+                                        currentChar == '3' ||
+                                        currentChar == '4' ||
+                                        currentChar == '5' ||
+                                        currentChar == '6' ||
+                                        currentChar == '7' ||
+                                        currentChar == '8' ||
+                                        currentChar == '9' ||
+                                        currentChar == 'e' ||
+                                        currentChar == 'E')
+                                    {
+                                        return CheckForNumber(index, jsonStringStream);
+                                    }
+
+                                    // Note: E.g. a 'u' isn't the start of any literal
+                                    if (tempValue.empty() == true)
+                                    {
+                                        throw std::runtime_error("Invalid literal value!");
+                                    }
+
+                                    value = tempValue;
+
+                                    return havJSONTokenValue { tempToken, ((value.has_value() == false) ? std::nullopt : value) };
+                                }
+                            }
+                            break;
+
+                        default:
+                            return havJSONTokenValue { havJSONToken::None, std::nullopt };
+                        }
+                    }
+                    else
+                    {
+                        return havJSONTokenValue { token, std::nullopt };
+                    }
+                }
+            }
+
+            return havJSONTokenValue { structuralToken, std::nullopt };
+        }
+
+        // Reads a little-endian value of type T at index and advances index past it
+        template<typename T>
+        T ReadBSONValue(std::string_view bsonStringStream, std::size_t& index, std::size_t endIndex)
+        {
+            if (index > endIndex || endIndex - index < sizeof(T))
+            {
+                throw std::runtime_error("Read beyond end of file!");
+            }
+
+            typedef std::conditional_t<sizeof(T) == 8, std::uint64_t, std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint8_t>> havJSONBSONRawType;
+
+            havJSONBSONRawType rawValue = 0;
+
+            for (std::size_t byteIndex = 0; byteIndex < sizeof(T); ++byteIndex)
+            {
+                rawValue |= static_cast<havJSONBSONRawType>(static_cast<havJSONBSONRawType>(static_cast<std::uint8_t>(bsonStringStream[index + byteIndex])) << (byteIndex * 8));
+            }
+
+            index += sizeof(T);
+
+            T value;
+            std::memcpy(&value, &rawValue, sizeof(T));
+
+            return value;
+        }
+
+        // Reads a null-terminated string (e.g. an element name) and advances index past the null terminator
+        std::string_view ReadBSONCString(std::string_view bsonStringStream, std::size_t& index, std::size_t endIndex)
+        {
+            std::string_view::size_type terminatorIndex = bsonStringStream.substr(0, endIndex).find('\0', index);
+
+            if (terminatorIndex == std::string_view::npos)
+            {
+                throw std::runtime_error("Read beyond end of file!");
+            }
+
+            CheckStringLength(terminatorIndex - index);
+
+            std::string_view value = bsonStringStream.substr(index, terminatorIndex - index);
+
+            index = terminatorIndex + 1;
+
+            return value;
+        }
+
+        // Reads a length-prefixed string and advances index past its null terminator
+        std::string_view ReadBSONString(std::string_view bsonStringStream, std::size_t& index, std::size_t endIndex)
+        {
+            std::int32_t valueSize = ReadBSONValue<std::int32_t>(bsonStringStream, index, endIndex);
+
+            // Note: The size includes the null terminator
+            if (valueSize < 1)
+            {
+                throw std::runtime_error("Value size can't be negative!");
+            }
+
+            if (static_cast<std::size_t>(valueSize) > endIndex - index || bsonStringStream[index + valueSize - 1] != 0x00)
+            {
+                throw std::runtime_error("Read beyond end of file!");
+            }
+
+            CheckStringLength(static_cast<std::size_t>(valueSize - 1));
+
+            std::string_view value = bsonStringStream.substr(index, valueSize - 1);
+
+            index += valueSize;
+
+            return value;
+        }
+
+        std::shared_ptr<havJSONData> ReadBSONElement(havJSONBSONType bsonType, std::string_view bsonStringStream, std::size_t& index, std::size_t endIndex)
+        {
+            switch (bsonType)
+            {
+                case havJSONBSONType::Double:
+                    return CreateNode(ReadBSONValue<double>(bsonStringStream, index, endIndex));
+
+                case havJSONBSONType::String:
+                case havJSONBSONType::JSCode:
+                    return CreateNode(std::string(ReadBSONString(bsonStringStream, index, endIndex)), havJSONDataType::String);
+
+                case havJSONBSONType::Document:
+                    {
+                        std::shared_ptr<havJSONData> valueNode = CreateNode(havJSONDataType::Object);
+
+                        ReadBSONDocument(bsonStringStream, index, endIndex, *valueNode);
+
+                        return valueNode;
+                    }
+
+                case havJSONBSONType::Array:
+                    {
+                        std::shared_ptr<havJSONData> valueNode = CreateNode(havJSONDataType::Array);
+
+                        ReadBSONDocument(bsonStringStream, index, endIndex, *valueNode);
+
+                        return valueNode;
+                    }
+
+                case havJSONBSONType::BinaryData:
+                    {
+                        std::int32_t valueSize = ReadBSONValue<std::int32_t>(bsonStringStream, index, endIndex);
+
+                        if (valueSize < 0)
+                        {
+                            throw std::runtime_error("Value size can't be negative!");
+                        }
+
+                        std::uint8_t subtypeValue = ReadBSONValue<std::uint8_t>(bsonStringStream, index, endIndex);
+
+                        if (static_cast<std::size_t>(valueSize) > endIndex - index)
+                        {
+                            throw std::runtime_error("Read beyond end of file!");
+                        }
+
+                        std::size_t binaryDataIndex = index;
+                        std::size_t binaryDataEnd = index + valueSize;
+
+                        index = binaryDataEnd;
+
+                        // Note: We only support the generic binary subtypes. The old one repeats the size in front of the data.
+                        if (subtypeValue == 0x02)
+                        {
+                            ReadBSONValue<std::int32_t>(bsonStringStream, binaryDataIndex, binaryDataEnd);
+                        }
+                        else if (subtypeValue != 0x00)
+                        {
+                            if (subtypeValue >= 0x80)
+                            {
+                                // User defined subtype
+                                throw std::runtime_error("User defined subtypes are unsupported!");
+                            }
+
+                            throw std::runtime_error("Unsupported subtype!");
+                        }
+
+                        // Binary data is represented as an array of byte values
+                        std::vector<std::shared_ptr<havJSONData>> byteValues;
+                        byteValues.reserve(binaryDataEnd - binaryDataIndex);
+
+                        for (; binaryDataIndex < binaryDataEnd; ++binaryDataIndex)
+                        {
+                            byteValues.push_back(CreateNode(static_cast<unsigned int>(static_cast<std::uint8_t>(bsonStringStream[binaryDataIndex]))));
+                        }
+
+                        return CreateNode(std::move(byteValues), havJSONDataType::Array);
+                    }
+
+                case havJSONBSONType::Boolean:
+                    return CreateNode(ReadBSONValue<std::uint8_t>(bsonStringStream, index, endIndex) != 0x00);
+
+                case havJSONBSONType::UTCDateTime:
+                case havJSONBSONType::Int64:
+                    return CreateNode(ReadBSONValue<long long>(bsonStringStream, index, endIndex));
+
+                case havJSONBSONType::NullValue:
+                    return CreateNode(havJSONDataType::Null);
+
+                case havJSONBSONType::Int:
+                    return CreateNode(static_cast<int>(ReadBSONValue<std::int32_t>(bsonStringStream, index, endIndex)));
+
+                case havJSONBSONType::Timestamp:
+                    return CreateNode(ReadBSONValue<unsigned long long>(bsonStringStream, index, endIndex));
+
+                default:
+                    throw std::runtime_error("Unsupported BSON type!");
+            }
+        }
+
+        // Reads the length-prefixed document at index into valueNode, which must be an object or an array. The document must end
+        // before endIndex. On return, index points past the terminating null byte of the document.
+        void ReadBSONDocument(std::string_view bsonStringStream, std::size_t& index, std::size_t endIndex, havJSONData& valueNode)
+        {
+            havJSONDepthScope depthScope(*this);
+
+            std::size_t documentIndex = index;
+
+            std::int32_t documentSize = ReadBSONValue<std::int32_t>(bsonStringStream, index, endIndex);
+
+            // Size (4 bytes) + null terminator (1 byte)
+            if (documentSize < 5 || static_cast<std::size_t>(documentSize) > endIndex - documentIndex)
+            {
+                throw std::runtime_error("Invalid BSON document size!");
+            }
+
+            std::size_t documentEnd = documentIndex + documentSize - 1;
+
+            if (bsonStringStream[documentEnd] != 0x00)
+            {
+                throw std::runtime_error("EOO not found!");
+            }
+
+            havJSONObject* objectValue = std::get_if<havJSONObject>(valueNode.getAddress());
+            std::vector<std::shared_ptr<havJSONData>>* arrayValue = std::get_if<std::vector<std::shared_ptr<havJSONData>>>(valueNode.getAddress());
+
+            // Elements are read up to the null terminator of the document
+            while (index < documentEnd)
+            {
+                havJSONBSONType bsonType = static_cast<havJSONBSONType>(bsonStringStream[index++]);
+
+                std::string_view key = ReadBSONCString(bsonStringStream, index, documentEnd);
+
+                std::shared_ptr<havJSONData> elementNode = ReadBSONElement(bsonType, bsonStringStream, index, documentEnd);
+
+                // Note: Array keys ("0", "1", ...) only restate the element order, so they're ignored
+                if (arrayValue != nullptr)
+                {
+                    arrayValue->push_back(std::move(elementNode));
+                }
+                else
+                {
+                    objectValue->insert({ MakeKey(key), std::move(elementNode) });
+                }
+            }
+
+            // Skip null terminator
+            index = documentEnd + 1;
+        }
+
+        bool ParseBSONContents(std::string_view bsonStringStream, havJSONData& valueNode)
+        {
+            havJSONData rootNode(havJSONDataType::Object);
+
+            std::size_t index = 0;
+
+            havJSONPhaseScope phaseScope = MeasurePhase(havJSONPhase::BSONParsing, bsonStringStream.size());
+
+            try
+            {
+                BeginParse(bsonStringStream.size());
+
+                if (bsonStringStream.empty() == true)
+                {
+                    return SetError(havJSONErrorCode::EmptyInput, index);
+                }
+
+                // Note: A BSON document is always an object
+                ReadBSONDocument(bsonStringStream, index, bsonStringStream.size(), rootNode);
+
+                if (index != bsonStringStream.size())
+                {
+                    return SetError(havJSONErrorCode::InvalidBSON, index);
+                }
+            }
+            catch (const havJSONLimitError&)
+            {
+                return SetError(havJSONErrorCode::LimitExceeded, index);
+            }
+            catch (const std::exception&)
+            {
+                // Note: index stops at the value that couldn't be read
+                SetError(havJSONErrorCode::InvalidBSON, index);
+
+                throw;
+            }
+
+            valueNode = std::move(rootNode);
+
+            return true;
+        }
+
+        // Converts a BSON document to compact JSON text
+        std::string ConvertBSONToJSON(std::string_view bsonStringStream)
+        {
+            havJSONData valueNode;
+
+            std::string jsonContent;
+
+            if (ParseBSONContents(bsonStringStream, valueNode) == true)
+            {
+                ConvertJSONToString(valueNode, jsonContent);
+            }
+
+            return jsonContent;
+        }
+
+        // Appends the token, which ends before offset, and counts values, arrays and objects against the node limit
+        void AddToken(havJSONTokenValue token, std::size_t offset)
+        {
+            if (token.mToken != havJSONToken::RightSquareBracket && token.mToken != havJSONToken::RightCurlyBracket && token.mToken != havJSONToken::Colon &&
+                token.mToken != havJSONToken::Comma && token.mToken != havJSONToken::String && ++mNumOfNodes > mParseOptions.mMaxNodes)
+            {
+                throw havJSONLimitError("Maximum number of nodes exceeded!");
+            }
+
+            token.mOffset = offset;
+
+#ifdef HAVJSON_STATS
+            ++mStats.mNumOfTokens;
+#endif
+
+            mTokens.push_back(std::move(token));
+        }
+
+        // On return (or when an exception leaves it), index points to the last character that was read
+        bool Tokenization(std::string_view jsonStringStream, std::string_view::size_type& index)
+        {
+            mTokens.clear();
+
+            havJSONToken currentTypeToken = havJSONToken::None;
+
+            std::deque<havJSONToken> typeTokens;
+            std::deque<int> typeTokenDepthLevels;
+
+            int depthLevel = 0;
+
+            for (index = 0; index < jsonStringStream.size(); ++index)
+            {
+                char currentChar = jsonStringStream[index];
+
+                if (SkipWhitespaces(currentChar, false) == true)
+                {
+                    // Jump over the whole whitespace run
+                    std::string_view::size_type nextIndex = havJSONScanner::SkipWhitespaces(jsonStringStream.data(), index, jsonStringStream.size());
+
+                    if (nextIndex > index)
+                    {
+                        index = nextIndex - 1;
+                    }
+
+                    continue;
+                }
+
+                havJSONToken token = CheckToken(currentChar);
+
+                if (token != havJSONToken::None)
+                {
+                    if (token == havJSONToken::LeftCurlyBracket ||
+                        token == havJSONToken::LeftSquareBracket)
+                    {
+                        currentTypeToken = token;
+
+                        typeTokens.push_back(token);
+
+                        if (typeTokens.size() > mParseOptions.mMaxDepth)
+                        {
+                            throw havJSONLimitError("Maximum depth exceeded!");
+                        }
+
+                        if (depthLevel > 0)
+                        {
+                            typeTokenDepthLevels.push_back(depthLevel++);
+                        }
+                    }
+
+                    AddToken(havJSONTokenValue { token, std::nullopt }, index + 1);
+                }
+
+                if (token == havJSONToken::RightCurlyBracket ||
+                    token == havJSONToken::RightSquareBracket)
+                {
+                    if (typeTokens.empty() == false)
+                    {
+                        if (typeTokenDepthLevels.empty() == false)
+                        {
+                            depthLevel = typeTokenDepthLevels.back();
+                            typeTokenDepthLevels.pop_back();
+                        }
+                        else
+                        {
+                            depthLevel = 0;
+                        }
+
+                        currentTypeToken = typeTokens[depthLevel];
+                        typeTokens.pop_back();
+                    }
+
+                    continue;
+                }
+
+                if (token == havJSONToken::Comma)
+                {
+                    token = currentTypeToken;
+                }
+
+                if (token == havJSONToken::None)
+                {
+                    token = currentTypeToken;
+                    --index;
+                }
+
+                havJSONTokenValue typeToken = CheckTypeToken(token, ++index, jsonStringStream);
+
+                if (typeToken.mToken != havJSONToken::None)
+                {
+                    if (typeToken.mToken == havJSONToken::LeftCurlyBracket ||
+                        typeToken.mToken == havJSONToken::LeftSquareBracket)
+                    {
+                        currentTypeToken = typeToken.mToken;
+
+                        typeTokens.push_back(currentTypeToken);
+
+                        if (typeTokens.size() > mParseOptions.mMaxDepth)
+                        {
+                            throw havJSONLimitError("Maximum depth exceeded!");
+                        }
+
+                        typeTokenDepthLevels.push_back(depthLevel++);
+                    }
+                    else
+                    {
+                        AddToken(std::move(typeToken), index + 1);
+                    }
+                }
+            }
+
+#if 0
+            int leftSquareCount = 0;
+            int rightSquareCount = 0;
+            int leftCurlyCount = 0;
+            int rightCurlyCount = 0;
+
+            for (std::deque<havJSONTokenValue>::size_type index = 0; index < mTokens.size(); ++index)
+            {
+                std::string type;
+
+                switch (mTokens[index].mToken)
+                {
+                case havJSONToken::None:
+                    type = "None";
+                    break;
+
+                // Structural tokens
+                case havJSONToken::LeftSquareBracket:
+                    ++leftSquareCount;
+                    type = "LeftSquareBracket";
+                    break;
+
+                case havJSONToken::LeftCurlyBracket:
+                    ++leftCurlyCount;
+                    type = "LeftCurlyBracket";
+                    break;
+
+                case havJSONToken::RightSquareBracket:
+                    ++rightSquareCount;
+                    type = "RightSquareBracket";
+                    break;
+
+                case havJSONToken::RightCurlyBracket:
+                    ++rightCurlyCount;
+                    type = "RightCurlyBracket";
+                    break;
+
+                case havJSONToken::Colon:
+                    type = "Colon";
+                    break;
+
+                case havJSONToken::Comma:
+                    type = "Comma";
+                    break;
+
+                // Generic type tokens
+                case havJSONToken::Null:
+                    type = "Null";
+                    break;
+
+                case havJSONToken::Boolean:
+                    type = "Boolean";
+                    break;
+
+                case havJSONToken::Int:
+                    type = "Int";
+                    break;
+
+                case havJSONToken::UInt:
+                    type = "UInt";
+                    break;
+
+                case havJSONToken::Long:
+                    type = "Long";
+                    break;
+
+                case havJSONToken::ULong:
+                    type = "ULong";
+                    break;
+
+                case havJSONToken::Int64:
+                    type = "Int64";
+                    break;
+
+                case havJSONToken::UInt64:
+                    type = "UInt64";
+                    break;
+
+                case havJSONToken::Double:
+                    type = "Double";
+                    break;
+
+                case havJSONToken::String:
+                    type = "String";
+                    break;
+
+                case havJSONToken::Value:
+                    type = "Value";
+                    break;
+
+                default:
+                    type = "Unsupported token type!";
+                }
+
+                if (mTokens[index].mValue.has_value() == true)
+                {
+                    std::cout << std::setfill('0') << std::setw(5) << index << ": " << type << " -> " << mTokens[index].mValue.value() << "\n";
+                }
+                else
+                {
+                    std::cout << std::setfill('0') << std::setw(5) << index << ": " << type << "\n";
+                }
+            }
+
+            std::cout << "left square count: " << leftSquareCount << "\n";
+            std::cout << "right square count: " << rightSquareCount << "\n";
+            std::cout << "left curly count: " << leftCurlyCount << "\n";
+            std::cout << "right curly count: " << rightCurlyCount << "\n";
+#endif
+
+            return mTokens.size() > 0;
+        }
+
+        // Drops the current token and moves the next one into token. Returns false if there's no next token.
+        bool NextToken(havJSONTokenValue& token)
+        {
+            mTokens.pop_front();
+
+            if (mTokens.empty() == true)
+            {
+                return false;
+            }
+
+            token = std::move(mTokens.front());
+
+            return true;
+        }
+
+        bool ParseJSONContents(havJSONData& valueNode)
+        {
+            if (mTokens.empty() == true)
+            {
+                return false;
+            }
+
+            // Check if the root node is an object or array
+            if (mTokens[0].mToken != havJSONToken::LeftCurlyBracket &&
+                mTokens[0].mToken != havJSONToken::LeftSquareBracket)
+            {
+                return false;
+            }
+
+            std::deque<havJSONData*> tokenTypeReferences;
+            std::unique_ptr<havJSONData> rootNode = nullptr;
+
+            while (mTokens.empty() == false)
+            {
+                havJSONTokenValue token = std::move(mTokens.front());
+
+                if (token.mToken == havJSONToken::Comma)
+                {
+                    mTokens.pop_front();
+
+                    continue;
+                }
+
+                // Only commas may follow once the root node is closed
+                if (rootNode != nullptr && tokenTypeReferences.empty() == true)
+                {
+                    mTokens.clear();
+
+                    return false;
+                }
+
+                // Check if we're dealing with an object
+                if (token.mToken == havJSONToken::LeftCurlyBracket)
+                {
+                    if (rootNode != nullptr)
+                    {
+                        if (tokenTypeReferences.back()->getType() == havJSONDataType::Array)
+                        {
+                            std::vector<std::shared_ptr<havJSONData>>* item = std::get_if<std::vector<std::shared_ptr<havJSONData>>>(tokenTypeReferences.back()->getAddress());
+
+                            havJSONObject tmpObject;
+                            item->push_back(CreateNode(std::move(tmpObject), havJSONDataType::Object));
+
+                            tokenTypeReferences.push_back(item->back().get());
+                        }
+                    }
+
+                    if (rootNode == nullptr)
+                    {
+                        // Note: Like in the recursive descent parser, the root node counts as a node
+                        CountNode();
+
+                        havJSONObject tmpObject;
+                        rootNode = std::make_unique<havJSONData>(std::move(tmpObject), havJSONDataType::Object);
+
+                        tokenTypeReferences.push_back(rootNode.get());
+                    }
+
+                    if (NextToken(token) == false)
+                    {
+                        return false;
+                    }
+
+                    // Check if the next token is valid
+                    if (token.mToken != havJSONToken::String &&
+                        token.mToken != havJSONToken::Value &&
+                        token.mToken != havJSONToken::Null &&
+                        token.mToken != havJSONToken::Boolean &&
+                        token.mToken != havJSONToken::Int &&
+                        token.mToken != havJSONToken::UInt &&
+                        token.mToken != havJSONToken::Long &&
+                        token.mToken != havJSONToken::ULong &&
+                        token.mToken != havJSONToken::Int64 &&
+                        token.mToken != havJSONToken::UInt64 &&
+                        token.mToken != havJSONToken::Double &&
+                        token.mToken != havJSONToken::Colon &&
+                        token.mToken != havJSONToken::Comma &&
+                        token.mToken != havJSONToken::RightCurlyBracket &&
+                        token.mToken != havJSONToken::LeftCurlyBracket &&
+                        token.mToken != havJSONToken::LeftSquareBracket)
+                    {
+                        return false;
+                    }
+
+                    if (token.mToken == havJSONToken::LeftCurlyBracket ||
+                        token.mToken == havJSONToken::LeftSquareBracket)
+                    {
+                        continue;
+                    }
+                }
+
+                // Check if we're dealing with an array
+                if (token.mToken == havJSONToken::LeftSquareBracket)
+                {
+                    if (rootNode != nullptr)
+                    {
+                        if (tokenTypeReferences.back()->getType() == havJSONDataType::Array)
+                        {
+                            std::vector<std::shared_ptr<havJSONData>>* item = std::get_if<std::vector<std::shared_ptr<havJSONData>>>(tokenTypeReferences.back()->getAddress());
+
+                            std::vector<std::shared_ptr<havJSONData>> tmpArray;
+                            item->push_back(CreateNode(std::move(tmpArray), havJSONDataType::Array));
+
+                            tokenTypeReferences.push_back(item->back().get());
+                        }
+                    }
+
+                    if (rootNode == nullptr)
+                    {
+                        // Note: Like in the recursive descent parser, the root node counts as a node
+                        CountNode();
+
+                        std::vector<std::shared_ptr<havJSONData>> tmpArray;
+                        rootNode = std::make_unique<havJSONData>(std::move(tmpArray), havJSONDataType::Array);
+
+                        tokenTypeReferences.push_back(rootNode.get());
+                    }
+
+                    if (NextToken(token) == false)
+                    {
+                        return false;
+                    }
+
+                    // Check if the next token is valid
+                    if (token.mToken != havJSONToken::Value &&
+                        token.mToken != havJSONToken::Null &&
+                        token.mToken != havJSONToken::Boolean &&
+                        token.mToken != havJSONToken::Int &&
+                        token.mToken != havJSONToken::UInt &&
+                        token.mToken != havJSONToken::Long &&
+                        token.mToken != havJSONToken::ULong &&
+                        token.mToken != havJSONToken::Int64 &&
+                        token.mToken != havJSONToken::UInt64 &&
+                        token.mToken != havJSONToken::Double &&
+                        token.mToken != havJSONToken::Comma &&
+                        token.mToken != havJSONToken::RightSquareBracket &&
+                        token.mToken != havJSONToken::LeftSquareBracket &&
+                        token.mToken != havJSONToken::LeftCurlyBracket)
+                    {
+                        return false;
+                    }
+
+                    if (token.mToken == havJSONToken::LeftSquareBracket ||
+                        token.mToken == havJSONToken::LeftCurlyBracket)
+                    {
                         continue;
                     }
                 }
 
-                if (token.mToken == havJSONToken::RightCurlyBracket ||
-                    token.mToken == havJSONToken::RightSquareBracket)
+                if (token.mToken == havJSONToken::RightCurlyBracket ||
+                    token.mToken == havJSONToken::RightSquareBracket)
+                {
+                    tokenTypeReferences.pop_back();
+                }
+
+                bool processed = false;
+
+                // Read contents of string token
+                if (token.mToken == havJSONToken::String)
+                {
+                    std::string key = std::move(token.mValue.value());
+
+                    if (NextToken(token) == false)
+                    {
+                        return false;
+                    }
+
+                    if (token.mToken == havJSONToken::Colon)
+                    {
+                        if (NextToken(token) == false)
+                        {
+                            return false;
+                        }
+
+                        if (token.mToken == havJSONToken::Value ||
+                            token.mToken == havJSONToken::Null ||
+                            token.mToken == havJSONToken::Boolean ||
+                            token.mToken == havJSONToken::Int ||
+                            token.mToken == havJSONToken::UInt ||
+                            token.mToken == havJSONToken::Long ||
+                            token.mToken == havJSONToken::ULong ||
+                            token.mToken == havJSONToken::Int64 ||
+                            token.mToken == havJSONToken::UInt64 ||
+                            token.mToken == havJSONToken::Double)
+                        {
+                            havJSONData value;
+
+                            switch (token.mToken)
+                            {
+                            case havJSONToken::Null:
+                                value = havJSONData(token.mValue.value(), havJSONDataType::Null);
+                                break;
+
+                            case havJSONToken::Boolean:
+                                value = havJSONData(((token.mValue.value() == "true") ? true : false), havJSONDataType::Boolean);
+                                break;
+
+                            case havJSONToken::Int:
+                                value = havJSONData(havJSONNumberConverter::FromChars<int>(token.mValue.value()), havJSONDataType::Int);
+                                break;
+
+                            case havJSONToken::UInt:
+                                value = havJSONData(havJSONNumberConverter::FromChars<unsigned int>(token.mValue.value()), havJSONDataType::UInt);
+                                break;
+
+                            case havJSONToken::Long:
+                                value = havJSONData(havJSONNumberConverter::FromChars<long>(token.mValue.value()), havJSONDataType::Long);
+                                break;
+
+                            case havJSONToken::ULong:
+                                value = havJSONData(havJSONNumberConverter::FromChars<unsigned long>(token.mValue.value()), havJSONDataType::ULong);
+                                break;
+
+                            case havJSONToken::Int64:
+                                value = havJSONData(havJSONNumberConverter::FromChars<long long>(token.mValue.value()), havJSONDataType::Int64);
+                                break;
+
+                            case havJSONToken::UInt64:
+                                value = havJSONData(havJSONNumberConverter::FromChars<unsigned long long>(token.mValue.value()), havJSONDataType::UInt64);
+                                break;
+
+                            case havJSONToken::Double:
+                                value = havJSONData(havJSONNumberConverter::FromChars<double>(token.mValue.value()), havJSONDataType::Double);
+                                break;
+
+                            case havJSONToken::Value:
+                            default:
+                                value = havJSONData(std::move(token.mValue.value()), havJSONDataType::String);
+                            }
+
+                            if (tokenTypeReferences.back()->getType() == havJSONDataType::Object)
+                            {
+                                std::get_if<havJSONObject>(tokenTypeReferences.back()->getAddress())->insert({ MakeKey(std::move(key)), CreateNode(std::move(*value.getAddress()), value.getType()) });
+
+                                processed = true;
+                            }
+                            else
+                            {
+                                throw std::runtime_error("Invalid token! Expected object!");
+                            }
+                        }
+                        else if (token.mToken == havJSONToken::LeftSquareBracket)
+                        {
+                            if (tokenTypeReferences.back()->getType() == havJSONDataType::Object)
+                            {
+                                havJSONObject* item = std::get_if<havJSONObject>(tokenTypeReferences.back()->getAddress());
+
+                                std::vector<std::shared_ptr<havJSONData>> tmpArray;
+                                auto itr = item->insert({ MakeKey(std::move(key)), CreateNode(std::move(tmpArray), havJSONDataType::Array) });
+
+                                tokenTypeReferences.push_back(itr.first->second.get());
+
+                                processed = true;
+                            }
+                            else
+                            {
+                                throw std::runtime_error("Invalid token! Expected object!");
+                            }
+                        }
+                        else if (token.mToken == havJSONToken::LeftCurlyBracket)
+                        {
+                            if (tokenTypeReferences.back()->getType() == havJSONDataType::Object)
+                            {
+                                havJSONObject* item = std::get_if<havJSONObject>(tokenTypeReferences.back()->getAddress());
+
+                                havJSONObject tmpObject;
+                                auto itr = item->insert({ MakeKey(std::move(key)), CreateNode(std::move(tmpObject), havJSONDataType::Object) });
+
+                                tokenTypeReferences.push_back(itr.first->second.get());
+
+                                processed = true;
+                            }
+                            else
+                            {
+                                throw std::runtime_error("Invalid token! Expected object!");
+                            }
+                        }
+                    }
+                }
+
+                if (processed == false)
+                {
+                    if (token.mToken == havJSONToken::Value ||
+                        token.mToken == havJSONToken::Null ||
+                        token.mToken == havJSONToken::Boolean ||
+                        token.mToken == havJSONToken::Int ||
+                        token.mToken == havJSONToken::UInt ||
+                        token.mToken == havJSONToken::Long ||
+                        token.mToken == havJSONToken::ULong ||
+                        token.mToken == havJSONToken::Int64 ||
+                        token.mToken == havJSONToken::UInt64 ||
+                        token.mToken == havJSONToken::Double)
+                    {
+                        havJSONData value;
+
+                        switch (token.mToken)
+                        {
+                        case havJSONToken::Null:
+                            value = havJSONData(token.mValue.value(), havJSONDataType::Null);
+                            break;
+
+                        case havJSONToken::Boolean:
+                            value = havJSONData(((token.mValue.value() == "true") ? true : false), havJSONDataType::Boolean);
+                            break;
+
+                        case havJSONToken::Int:
+                            value = havJSONData(havJSONNumberConverter::FromChars<int>(token.mValue.value()), havJSONDataType::Int);
+                            break;
+
+                        case havJSONToken::UInt:
+                            value = havJSONData(havJSONNumberConverter::FromChars<unsigned int>(token.mValue.value()), havJSONDataType::UInt);
+                            break;
+
+                        case havJSONToken::Long:
+                            value = havJSONData(havJSONNumberConverter::FromChars<long>(token.mValue.value()), havJSONDataType::Long);
+                            break;
+
+                        case havJSONToken::ULong:
+                            value = havJSONData(havJSONNumberConverter::FromChars<unsigned long>(token.mValue.value()), havJSONDataType::ULong);
+                            break;
+
+                        case havJSONToken::Int64:
+                            value = havJSONData(havJSONNumberConverter::FromChars<long long>(token.mValue.value()), havJSONDataType::Int64);
+                            break;
+
+                        case havJSONToken::UInt64:
+                            value = havJSONData(havJSONNumberConverter::FromChars<unsigned long long>(token.mValue.value()), havJSONDataType::UInt64);
+                            break;
+
+                        case havJSONToken::Double:
+                            value = havJSONData(havJSONNumberConverter::FromChars<double>(token.mValue.value()), havJSONDataType::Double);
+                            break;
+
+                        case havJSONToken::Value:
+                        default:
+                            value = havJSONData(std::move(token.mValue.value()), havJSONDataType::String);
+                        }
+
+                        if (tokenTypeReferences.back()->getType() == havJSONDataType::Array)
+                        {
+                            std::get_if<std::vector<std::shared_ptr<havJSONData>>>(tokenTypeReferences.back()->getAddress())->push_back(CreateNode(std::move(*value.getAddress()), value.getType()));
+                        }
+                        else
+                        {
+                            throw std::runtime_error("Invalid token! Expected array!");
+                        }
+                    }
+                }
+
+                mTokens.pop_front();
+            }
+
+            if (rootNode == nullptr)
+            {
+                throw std::runtime_error("No root node found!");
+            }
+
+            valueNode = std::move(*rootNode);
+
+            return true;
+        }
+
+        // Counts a node against the node limit. Nodes made through CreateNode are counted already.
+        void CountNode()
+        {
+            if (++mNumOfNodes > mParseOptions.mMaxNodes)
+            {
+                throw havJSONLimitError("Maximum number of nodes exceeded!");
+            }
+
+#ifdef HAVJSON_STATS
+            ++mStats.mNumOfNodes;
+#endif
+        }
+
+        template<typename... Args>
+        std::shared_ptr<havJSONData> CreateNode(Args&&... args)
+        {
+            CountNode();
+
+#ifdef HAVJSON_STATS
+            return std::allocate_shared<havJSONData>(havJSONStatsAllocator<havJSONData>(mArena, &mStats), std::forward<Args>(args)...);
+#else
+            if (mArena != nullptr)
+            {
+                return std::allocate_shared<havJSONData>(havJSONArenaAllocator<havJSONData>(mArena), std::forward<Args>(args)...);
+            }
+
+            return std::make_shared<havJSONData>(std::forward<Args>(args)...);
+#endif
+        }
+
+        void SkipWhitespacesDirect(std::string_view::size_type& index, std::string_view jsonStringStream)
+        {
+            index = havJSONScanner::SkipWhitespaces(jsonStringStream.data(), index, jsonStringStream.size());
+        }
+
+        std::shared_ptr<havJSONData> ReadNumberDirect(std::string_view::size_type& index, std::string_view jsonStringStream)
+        {
+            std::string_view::size_type startIndex = index;
+
+            bool isFloatingPoint = false;
+
+            if (havJSONNumberConverter::Scan(index, jsonStringStream, isFloatingPoint) == false)
+            {
+                throw std::runtime_error("Unable to read number value!");
+            }
+
+            return havJSONNumberConverter::Convert(jsonStringStream.substr(startIndex, index - startIndex), isFloatingPoint, [this](auto result) { return CreateNode(result); });
+        }
+
+        bool ParseElementDirect(std::string_view::size_type& index, std::string_view jsonStringStream, std::shared_ptr<havJSONData>& valueNode)
+        {
+            if (index >= jsonStringStream.size())
+            {
+                return false;
+            }
+
+            char currentChar = jsonStringStream[index];
+
+            switch (currentChar)
+            {
+            case '{':
+                valueNode = CreateNode(havJSONDataType::Object);
+                return ParseObjectDirect(index, jsonStringStream, *valueNode);
+
+            case '[':
+                valueNode = CreateNode(havJSONDataType::Array);
+                return ParseArrayDirect(index, jsonStringStream, *valueNode);
+
+            case '"':
+                {
+                    std::string tempValue;
+
+                    ReadStringValue(index, jsonStringStream, tempValue);
+
+                    // Skip closing quotation mark
+                    ++index;
+
+                    valueNode = CreateNode(std::move(tempValue), havJSONDataType::String);
+                }
+                return true;
+
+            case 't':
+            case 'f':
+            case 'n':
+                {
+                    std::string literalValue = ((currentChar == 't') ? "true" : ((currentChar == 'f') ? "false" : "null"));
+
+                    CheckForLiteral(++index, jsonStringStream, literalValue);
+
+                    // Skip last character of the literal
+                    ++index;
+
+                    if (currentChar == 'n')
+                    {
+                        valueNode = CreateNode(havJSONDataType::Null);
+                    }
+                    else
+                    {
+                        valueNode = CreateNode(currentChar == 't');
+                    }
+                }
+                return true;
+
+            default:
+                if (currentChar == '-' || (currentChar >= '0' && currentChar <= '9'))
+                {
+                    valueNode = ReadNumberDirect(index, jsonStringStream);
+
+                    return true;
+                }
+
+                return false;
+            }
+        }
+
+        bool ParseArrayDirect(std::string_view::size_type& index, std::string_view jsonStringStream, havJSONData& arrayNode)
+        {
+            havJSONDepthScope depthScope(*this);
+
+            std::vector<std::shared_ptr<havJSONData>>* item = std::get_if<std::vector<std::shared_ptr<havJSONData>>>(arrayNode.getAddress());
+
+            // Skip left square bracket
+            ++index;
+
+            SkipWhitespacesDirect(index, jsonStringStream);
+
+            if (index < jsonStringStream.size() && jsonStringStream[index] == ']')
+            {
+                ++index;
+
+                return true;
+            }
+
+            // Collect the elements in a scratch buffer of the current depth first, so the array is allocated only once with its final size
+            if (mArrayScratch.size() <= mArrayDepth)
+            {
+                mArrayScratch.emplace_back();
+            }
+
+            std::size_t scratchIndex = mArrayDepth++;
+
+            while (index < jsonStringStream.size())
+            {
+                std::shared_ptr<havJSONData> valueNode;
+
+                if (ParseElementDirect(index, jsonStringStream, valueNode) == false)
+                {
+                    return false;
+                }
+
+                // Note: Nested arrays may grow mArrayScratch, so it has to be indexed again every time
+                mArrayScratch[scratchIndex].push_back(std::move(valueNode));
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+
+                if (index >= jsonStringStream.size())
+                {
+                    return false;
+                }
+
+                if (jsonStringStream[index] == ']')
+                {
+                    ++index;
+
+                    mArrayDepth = scratchIndex;
+
+                    std::vector<std::shared_ptr<havJSONData>>& currentElements = mArrayScratch[scratchIndex];
+
+                    item->reserve(currentElements.size());
+                    item->insert(item->end(), std::make_move_iterator(currentElements.begin()), std::make_move_iterator(currentElements.end()));
+
+                    currentElements.clear();
+
+                    return true;
+                }
+
+                if (jsonStringStream[index] != ',')
+                {
+                    return false;
+                }
+
+                ++index;
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+            }
+
+            return false;
+        }
+
+        bool ParseObjectDirect(std::string_view::size_type& index, std::string_view jsonStringStream, havJSONData& objectNode)
+        {
+            havJSONDepthScope depthScope(*this);
+
+            havJSONObject* item = std::get_if<havJSONObject>(objectNode.getAddress());
+
+            // Skip left curly bracket
+            ++index;
+
+            SkipWhitespacesDirect(index, jsonStringStream);
+
+            if (index < jsonStringStream.size() && jsonStringStream[index] == '}')
+            {
+                ++index;
+
+                return true;
+            }
+
+            // Collect the members in a scratch buffer of the current depth first, so the object is allocated only once with its final size
+            if (mObjectScratch.size() <= mObjectDepth)
+            {
+                mObjectScratch.emplace_back();
+            }
+
+            std::size_t scratchIndex = mObjectDepth++;
+
+            while (index < jsonStringStream.size())
+            {
+                // Name
+                if (jsonStringStream[index] != '"')
+                {
+                    return false;
+                }
+
+                // Note: Keys without escape sequences are read as a view into the input, so only the key itself is allocated (or looked up)
+                havJSONObjectKey key = MakeKey(ReadStringView(index, jsonStringStream, mKeyString));
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+
+                if (index >= jsonStringStream.size() || jsonStringStream[index] != ':')
+                {
+                    return false;
+                }
+
+                ++index;
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+
+                // Value
+                std::shared_ptr<havJSONData> valueNode;
+
+                if (ParseElementDirect(index, jsonStringStream, valueNode) == false)
+                {
+                    return false;
+                }
+
+                // Note: Nested objects may grow mObjectScratch, so it has to be indexed again every time
+                mObjectScratch[scratchIndex].emplace_back(std::move(key), std::move(valueNode));
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+
+                if (index >= jsonStringStream.size())
+                {
+                    return false;
+                }
+
+                if (jsonStringStream[index] == '}')
+                {
+                    ++index;
+
+                    mObjectDepth = scratchIndex;
+
+                    std::vector<havJSONObject::value_type>& currentMembers = mObjectScratch[scratchIndex];
+
+#ifdef HAVJSON_ORDERED_OBJECTS
+                    item->reserve(currentMembers.size());
+#endif
+
+                    // Note: Like the tokenizer, the first occurrence of a duplicate key wins
+                    for (havJSONObject::value_type& member : currentMembers)
+                    {
+                        item->insert(std::move(member));
+                    }
+
+                    currentMembers.clear();
+
+                    return true;
+                }
+
+                if (jsonStringStream[index] != ',')
+                {
+                    return false;
+                }
+
+                ++index;
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+            }
+
+            return false;
+        }
+
+        // Parses the members or elements of the array or object at index that are selected by filterIndex (a node of mFilter) and
+        // skips the rest. containerNode must be an empty array or object already.
+        bool ParseFilteredContainer(std::string_view::size_type& index, std::string_view jsonStringStream, std::size_t filterIndex, havJSONData& containerNode)
+        {
+            havJSONDepthScope depthScope(*this);
+
+            havJSONObject* objectValue = std::get_if<havJSONObject>(containerNode.getAddress());
+            std::vector<std::shared_ptr<havJSONData>>* arrayValue = std::get_if<std::vector<std::shared_ptr<havJSONData>>>(containerNode.getAddress());
+
+            char closingChar = (objectValue != nullptr) ? '}' : ']';
+
+            // Skip left bracket
+            ++index;
+
+            SkipWhitespacesDirect(index, jsonStringStream);
+
+            if (index < jsonStringStream.size() && jsonStringStream[index] == closingChar)
+            {
+                ++index;
+
+                return true;
+            }
+
+            std::size_t elementIndex = 0;
+
+            while (index < jsonStringStream.size())
+            {
+                std::size_t childIndex = havJSONFilter::npos;
+
+                std::optional<havJSONObjectKey> key;
+
+                if (objectValue != nullptr)
+                {
+                    // Name
+                    if (jsonStringStream[index] != '"')
+                    {
+                        return false;
+                    }
+
+                    std::string_view keyView = ReadStringView(index, jsonStringStream, mKeyString);
+
+                    childIndex = mFilter->findChild(filterIndex, keyView);
+
+                    // Note: keyView may point into mKeyString, which is reused by nested objects
+                    if (childIndex != havJSONFilter::npos)
+                    {
+                        key = MakeKey(keyView);
+                    }
+
+                    SkipWhitespacesDirect(index, jsonStringStream);
+
+                    if (index >= jsonStringStream.size() || jsonStringStream[index] != ':')
+                    {
+                        return false;
+                    }
+
+                    ++index;
+
+                    SkipWhitespacesDirect(index, jsonStringStream);
+                }
+                else
+                {
+                    childIndex = mFilter->findChild(filterIndex, elementIndex++);
+                }
+
+                // Value
+                std::shared_ptr<havJSONData> valueNode;
+
+                char currentChar = (index < jsonStringStream.size()) ? jsonStringStream[index] : '\0';
+
+                if (childIndex != havJSONFilter::npos && mFilter->isSelected(childIndex) == true)
+                {
+                    if (ParseElementDirect(index, jsonStringStream, valueNode) == false)
+                    {
+                        return false;
+                    }
+                }
+                else if (childIndex != havJSONFilter::npos && (currentChar == '{' || currentChar == '['))
+                {
+                    valueNode = CreateNode((currentChar == '{') ? havJSONDataType::Object : havJSONDataType::Array);
+
+                    if (ParseFilteredContainer(index, jsonStringStream, childIndex, *valueNode) == false)
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    // Note: A scalar can't contain the rest of a path, so it's skipped as well
+                    std::size_t endIndex = havJSONScanner::SkipValue(jsonStringStream.data(), index, jsonStringStream.size());
+
+                    if (endIndex == index)
+                    {
+                        return false;
+                    }
+
+                    index = endIndex;
+                }
+
+                if (valueNode != nullptr)
+                {
+                    if (arrayValue != nullptr)
+                    {
+                        arrayValue->push_back(std::move(valueNode));
+                    }
+                    else
+                    {
+                        // Note: Like the tokenizer, the first occurrence of a duplicate key wins
+                        objectValue->insert({ std::move(*key), std::move(valueNode) });
+                    }
+                }
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+
+                if (index >= jsonStringStream.size())
+                {
+                    return false;
+                }
+
+                if (jsonStringStream[index] == closingChar)
+                {
+                    ++index;
+
+                    return true;
+                }
+
+                if (jsonStringStream[index] != ',')
+                {
+                    return false;
+                }
+
+                ++index;
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+            }
+
+            return false;
+        }
+
+        bool ParseJSONContentsDirect(std::string_view jsonStringStream, havJSONData& valueNode)
+        {
+            mArrayDepth = 0;
+            mObjectDepth = 0;
+
+            // Note: The parse functions leave index where they stopped, which is where the error is
+            std::string_view::size_type index = 0;
+
+            havJSONPhaseScope phaseScope = MeasurePhase(havJSONPhase::Parsing, jsonStringStream.size());
+
+            try
+            {
+                bool result = ParseRootDirect(index, jsonStringStream, valueNode);
+
+                ClearScratch();
+
+                if (result == false)
+                {
+                    SetSyntaxError(jsonStringStream, index);
+                }
+
+                return result;
+            }
+            catch (const havJSONLimitError&)
+            {
+                ClearScratch();
+
+                SetError(havJSONErrorCode::LimitExceeded, jsonStringStream, index);
+
+                throw;
+            }
+            catch (const std::exception&)
+            {
+                ClearScratch();
+
+                SetSyntaxError(jsonStringStream, index);
+
+                throw;
+            }
+            catch (...)
+            {
+                ClearScratch();
+
+                throw;
+            }
+        }
+
+        // Drops the elements of incomplete arrays and objects left behind by a failed parse
+        void ClearScratch()
+        {
+            for (std::vector<std::shared_ptr<havJSONData>>& elements : mArrayScratch)
+            {
+                elements.clear();
+            }
+
+            for (std::vector<havJSONObject::value_type>& members : mObjectScratch)
+            {
+                members.clear();
+            }
+
+            mArrayDepth = 0;
+            mObjectDepth = 0;
+        }
+
+        bool ParseRootDirect(std::string_view::size_type& index, std::string_view jsonStringStream, havJSONData& valueNode)
+        {
+            SkipWhitespacesDirect(index, jsonStringStream);
+
+            if (index >= jsonStringStream.size())
+            {
+                return SetError(havJSONErrorCode::EmptyInput, jsonStringStream, index);
+            }
+
+            // Note: The root node isn't created through CreateNode, so it's counted here
+            CountNode();
+
+            // Check if the root node is an object or array
+            if (mFilter != nullptr && mFilter->isSelected(0) == false && (jsonStringStream[index] == '{' || jsonStringStream[index] == '['))
+            {
+                valueNode = havJSONData((jsonStringStream[index] == '{') ? havJSONDataType::Object : havJSONDataType::Array);
+
+                if (ParseFilteredContainer(index, jsonStringStream, 0, valueNode) == false)
+                {
+                    return false;
+                }
+            }
+            else if (jsonStringStream[index] == '{')
+            {
+                valueNode = havJSONData(havJSONDataType::Object);
+
+                if (ParseObjectDirect(index, jsonStringStream, valueNode) == false)
+                {
+                    return false;
+                }
+            }
+            else if (jsonStringStream[index] == '[')
+            {
+                valueNode = havJSONData(havJSONDataType::Array);
+
+                if (ParseArrayDirect(index, jsonStringStream, valueNode) == false)
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                return false;
+            }
+
+            SkipWhitespacesDirect(index, jsonStringStream);
+
+            // Only whitespace may follow the root node
+            return index == jsonStringStream.size();
+        }
+
+        // Creates the key for a parsed object member. With HAVJSON_INTERNED_KEYS, the key is taken from the stream's key table.
+#ifdef HAVJSON_INTERNED_KEYS
+        havJSONObjectKey MakeKey(std::string_view key)
+        {
+            return mKeyTable.intern(key);
+        }
+
+        havJSONKeyTable& GetKeyTable() { return mKeyTable; }
+#else
+        havJSONObjectKey MakeKey(std::string_view key)
+        {
+            return std::string(key);
+        }
+
+        havJSONObjectKey MakeKey(std::string&& key)
+        {
+            return std::move(key);
+        }
+#endif
+
+        // Reads the string starting at the quotation mark at index. Strings without escape sequences are returned as a view into
+        // jsonStringStream, all others are decoded into tempValue. On return, index points past the closing quotation mark.
+        std::string_view ReadStringView(std::string_view::size_type& index, std::string_view jsonStringStream, std::string& tempValue)
+        {
+            std::string_view::size_type startIndex = index + 1;
+            std::string_view::size_type specialIndex = havJSONScanner::FindStringSpecial(jsonStringStream.data(), startIndex, jsonStringStream.size());
+
+            if (specialIndex < jsonStringStream.size() && jsonStringStream[specialIndex] == '"')
+            {
+                CheckStringLength(specialIndex - startIndex);
+
+                index = specialIndex + 1;
+
+                return jsonStringStream.substr(startIndex, specialIndex - startIndex);
+            }
+
+            tempValue.clear();
+
+            ReadStringValue(index, jsonStringStream, tempValue);
+
+            // Skip closing quotation mark
+            ++index;
+
+            return tempValue;
+        }
+
+        bool ParseElementSAX(std::string_view::size_type& index, std::string_view jsonStringStream, havJSONSAXHandler& handler)
+        {
+            if (index >= jsonStringStream.size())
+            {
+                return false;
+            }
+
+            char currentChar = jsonStringStream[index];
+
+            switch (currentChar)
+            {
+            case '{':
+                return ParseObjectSAX(index, jsonStringStream, handler);
+
+            case '[':
+                return ParseArraySAX(index, jsonStringStream, handler);
+
+            case '"':
+                return handler.onString(ReadStringView(index, jsonStringStream, mSAXString));
+
+            case 't':
+            case 'f':
+            case 'n':
+                {
+                    std::string literalValue = ((currentChar == 't') ? "true" : ((currentChar == 'f') ? "false" : "null"));
+
+                    CheckForLiteral(++index, jsonStringStream, literalValue);
+
+                    // Skip last character of the literal
+                    ++index;
+
+                    if (currentChar == 'n')
+                    {
+                        return handler.onNull();
+                    }
+
+                    return handler.onBoolean(currentChar == 't');
+                }
+
+            default:
+                if (currentChar == '-' || (currentChar >= '0' && currentChar <= '9'))
+                {
+                    std::string_view::size_type startIndex = index;
+
+                    bool isFloatingPoint = false;
+
+                    if (havJSONNumberConverter::Scan(index, jsonStringStream, isFloatingPoint) == false)
+                    {
+                        throw std::runtime_error("Unable to read number value!");
+                    }
+
+                    return havJSONNumberConverter::Convert(jsonStringStream.substr(startIndex, index - startIndex), isFloatingPoint, [&handler](auto result)
+                    {
+                        typedef decltype(result) ResultType;
+
+                        if constexpr (std::is_floating_point_v<ResultType> == true)
+                        {
+                            return handler.onDouble(result);
+                        }
+                        else if constexpr (std::is_unsigned_v<ResultType> == true)
+                        {
+                            if (result > static_cast<ResultType>(std::numeric_limits<long long>::max()))
+                            {
+                                return handler.onUInt64(result);
+                            }
+
+                            return handler.onInt64(static_cast<long long>(result));
+                        }
+                        else
+                        {
+                            return handler.onInt64(result);
+                        }
+                    });
+                }
+
+                return false;
+            }
+        }
+
+        bool ParseArraySAX(std::string_view::size_type& index, std::string_view jsonStringStream, havJSONSAXHandler& handler)
+        {
+            havJSONDepthScope depthScope(*this);
+
+            if (handler.onArrayBegin() == false)
+            {
+                return false;
+            }
+
+            // Skip left square bracket
+            ++index;
+
+            SkipWhitespacesDirect(index, jsonStringStream);
+
+            if (index < jsonStringStream.size() && jsonStringStream[index] == ']')
+            {
+                ++index;
+
+                return handler.onArrayEnd();
+            }
+
+            while (index < jsonStringStream.size())
+            {
+                if (ParseElementSAX(index, jsonStringStream, handler) == false)
+                {
+                    return false;
+                }
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+
+                if (index >= jsonStringStream.size())
+                {
+                    return false;
+                }
+
+                if (jsonStringStream[index] == ']')
+                {
+                    ++index;
+
+                    return handler.onArrayEnd();
+                }
+
+                if (jsonStringStream[index] != ',')
+                {
+                    return false;
+                }
+
+                ++index;
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+            }
+
+            return false;
+        }
+
+        bool ParseObjectSAX(std::string_view::size_type& index, std::string_view jsonStringStream, havJSONSAXHandler& handler)
+        {
+            havJSONDepthScope depthScope(*this);
+
+            if (handler.onObjectBegin() == false)
+            {
+                return false;
+            }
+
+            // Skip left curly bracket
+            ++index;
+
+            SkipWhitespacesDirect(index, jsonStringStream);
+
+            if (index < jsonStringStream.size() && jsonStringStream[index] == '}')
+            {
+                ++index;
+
+                return handler.onObjectEnd();
+            }
+
+            while (index < jsonStringStream.size())
+            {
+                // Name
+                if (jsonStringStream[index] != '"')
+                {
+                    return false;
+                }
+
+                if (handler.onKey(ReadStringView(index, jsonStringStream, mSAXString)) == false)
+                {
+                    return false;
+                }
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+
+                if (index >= jsonStringStream.size() || jsonStringStream[index] != ':')
+                {
+                    return false;
+                }
+
+                ++index;
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+
+                // Value
+                if (ParseElementSAX(index, jsonStringStream, handler) == false)
+                {
+                    return false;
+                }
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+
+                if (index >= jsonStringStream.size())
+                {
+                    return false;
+                }
+
+                if (jsonStringStream[index] == '}')
+                {
+                    ++index;
+
+                    return handler.onObjectEnd();
+                }
+
+                if (jsonStringStream[index] != ',')
+                {
+                    return false;
+                }
+
+                ++index;
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+            }
+
+            return false;
+        }
+
+        bool ParseRootSAX(std::string_view jsonStringStream, havJSONSAXHandler& handler)
+        {
+            std::string_view::size_type index = 0;
+
+            havJSONPhaseScope phaseScope = MeasurePhase(havJSONPhase::Parsing, jsonStringStream.size());
+
+            try
+            {
+                BeginParse(jsonStringStream.size());
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+
+                if (index >= jsonStringStream.size())
+                {
+                    return SetError(havJSONErrorCode::EmptyInput, jsonStringStream, index);
+                }
+
+                // Check if the root node is an object or array
+                if (jsonStringStream[index] != '{' && jsonStringStream[index] != '[')
+                {
+                    return SetSyntaxError(jsonStringStream, index);
+                }
+
+                // Note: A handler that stops the parse is reported like a syntax error at the value it rejected
+                if (ParseElementSAX(index, jsonStringStream, handler) == false)
+                {
+                    return SetSyntaxError(jsonStringStream, index);
+                }
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+
+                // Only whitespace may follow the root node
+                if (index != jsonStringStream.size())
+                {
+                    return SetSyntaxError(jsonStringStream, index);
+                }
+
+                return true;
+            }
+            catch (const havJSONLimitError&)
+            {
+                return SetError(havJSONErrorCode::LimitExceeded, jsonStringStream, index);
+            }
+            catch (const std::exception&)
+            {
+                SetSyntaxError(jsonStringStream, index);
+
+                throw;
+            }
+        }
+
+        bool ReadBoundLiteral(std::string_view::size_type& index, std::string_view jsonStringStream, std::string_view literalValue)
+        {
+            if (jsonStringStream.size() - index < literalValue.size() || jsonStringStream.compare(index, literalValue.size(), literalValue) != 0)
+            {
+                return false;
+            }
+
+            index += literalValue.size();
+
+            return true;
+        }
+
+        // Reads the value at index into a member of a bound struct. A value that doesn't match the member's type fails the parse.
+        template<typename T>
+        bool ReadBoundValue(std::string_view::size_type& index, std::string_view jsonStringStream, T& value)
+        {
+            static_assert(havJSONIsBindable<T>::value == true, "Unsupported member type!");
+
+            if (index >= jsonStringStream.size())
+            {
+                return false;
+            }
+
+            if constexpr (std::is_same_v<T, bool> == true)
+            {
+                if (ReadBoundLiteral(index, jsonStringStream, "true") == true)
+                {
+                    value = true;
+
+                    return true;
+                }
+
+                if (ReadBoundLiteral(index, jsonStringStream, "false") == true)
+                {
+                    value = false;
+
+                    return true;
+                }
+
+                return false;
+            }
+            else if constexpr (std::is_arithmetic_v<T> == true)
+            {
+                std::string_view::size_type startIndex = index;
+
+                bool isFloatingPoint = false;
+
+                if (havJSONNumberConverter::Scan(index, jsonStringStream, isFloatingPoint) == false)
+                {
+                    return false;
+                }
+
+                // Note: Integer members only take integers in their range, floating point members take any number
+                if constexpr (std::is_integral_v<T> == true)
+                {
+                    if (isFloatingPoint == true)
+                    {
+                        return false;
+                    }
+                }
+
+                std::from_chars_result conversionResult = std::from_chars(jsonStringStream.data() + startIndex, jsonStringStream.data() + index, value);
+
+                return conversionResult.ec == std::errc() && conversionResult.ptr == jsonStringStream.data() + index;
+            }
+            else if constexpr (std::is_same_v<T, std::string> == true)
+            {
+                if (jsonStringStream[index] != '"')
+                {
+                    return false;
+                }
+
+                // Note: Assigning keeps the capacity of a reused struct's string
+                value.assign(ReadStringView(index, jsonStringStream, mBindString));
+
+                return true;
+            }
+            else if constexpr (std::is_same_v<T, havJSONData> == true)
+            {
+                std::shared_ptr<havJSONData> valueNode;
+
+                if (ParseElementDirect(index, jsonStringStream, valueNode) == false)
+                {
+                    return false;
+                }
+
+                value = std::move(*valueNode);
+
+                return true;
+            }
+            else
+            {
+                return ReadBoundObject(index, jsonStringStream, value);
+            }
+        }
+
+        template<typename T>
+        bool ReadBoundValue(std::string_view::size_type& index, std::string_view jsonStringStream, std::optional<T>& value)
+        {
+            if (ReadBoundLiteral(index, jsonStringStream, "null") == true)
+            {
+                value.reset();
+
+                return true;
+            }
+
+            if (value.has_value() == false)
+            {
+                value.emplace();
+            }
+
+            return ReadBoundValue(index, jsonStringStream, *value);
+        }
+
+        template<typename T>
+        bool ReadBoundValue(std::string_view::size_type& index, std::string_view jsonStringStream, std::vector<T>& value)
+        {
+            if (index >= jsonStringStream.size() || jsonStringStream[index] != '[')
+            {
+                return false;
+            }
+
+            havJSONDepthScope depthScope(*this);
+
+            // Skip left square bracket
+            ++index;
+
+            value.clear();
+
+            SkipWhitespacesDirect(index, jsonStringStream);
+
+            if (index < jsonStringStream.size() && jsonStringStream[index] == ']')
+            {
+                ++index;
+
+                return true;
+            }
+
+            while (index < jsonStringStream.size())
+            {
+                // Note: Elements are read in place, so only the vector itself allocates
+                if constexpr (std::is_same_v<T, bool> == true)
+                {
+                    bool element = false;
+
+                    if (ReadBoundValue(index, jsonStringStream, element) == false)
+                    {
+                        return false;
+                    }
+
+                    value.push_back(element);
+                }
+                else
+                {
+                    value.emplace_back();
+
+                    if (ReadBoundValue(index, jsonStringStream, value.back()) == false)
+                    {
+                        return false;
+                    }
+                }
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+
+                if (index >= jsonStringStream.size())
+                {
+                    return false;
+                }
+
+                if (jsonStringStream[index] == ']')
+                {
+                    ++index;
+
+                    return true;
+                }
+
+                if (jsonStringStream[index] != ',')
+                {
+                    return false;
+                }
+
+                ++index;
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+            }
+
+            return false;
+        }
+
+        // Reads an object into the members of a bound struct. Unknown and repeated members are skipped and missing members keep their value.
+        template<typename T>
+        bool ReadBoundObject(std::string_view::size_type& index, std::string_view jsonStringStream, T& value)
+        {
+            constexpr std::size_t numOfFields = std::tuple_size_v<decltype(havJSONBinding<T>::fields())>;
+
+            if (jsonStringStream[index] != '{')
+            {
+                return false;
+            }
+
+            havJSONDepthScope depthScope(*this);
+
+            // Skip left curly bracket
+            ++index;
+
+            SkipWhitespacesDirect(index, jsonStringStream);
+
+            if (index < jsonStringStream.size() && jsonStringStream[index] == '}')
+            {
+                ++index;
+
+                return true;
+            }
+
+            std::size_t nextPosition = 0;
+
+            std::array<bool, numOfFields> readFields {};
+
+            while (index < jsonStringStream.size())
+            {
+                // Name
+                if (jsonStringStream[index] != '"')
+                {
+                    return false;
+                }
+
+                std::size_t position = FindBoundField<T>(ReadStringView(index, jsonStringStream, mBindString), nextPosition);
+
+                // Note: Like the tree parsers, the first occurrence of a duplicate key wins, so later ones are skipped
+                if (position < numOfFields && readFields[position] == true)
+                {
+                    position = numOfFields;
+                }
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+
+                if (index >= jsonStringStream.size() || jsonStringStream[index] != ':')
+                {
+                    return false;
+                }
+
+                ++index;
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+
+                // Value
+                if (position < numOfFields)
+                {
+                    if (ReadBoundField(index, jsonStringStream, value, position, std::make_index_sequence<numOfFields>()) == false)
+                    {
+                        return false;
+                    }
+
+                    readFields[position] = true;
+                    nextPosition = position + 1;
+                }
+                else
+                {
+                    // The value of an unknown member is checked and skipped without creating nodes
+                    havJSONSAXHandler skipHandler;
+
+                    if (ParseElementSAX(index, jsonStringStream, skipHandler) == false)
+                    {
+                        return false;
+                    }
+                }
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+
+                if (index >= jsonStringStream.size())
+                {
+                    return false;
+                }
+
+                if (jsonStringStream[index] == '}')
+                {
+                    ++index;
+
+                    return true;
+                }
+
+                if (jsonStringStream[index] != ',')
+                {
+                    return false;
+                }
+
+                ++index;
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+            }
+
+            return false;
+        }
+
+        template<typename T, std::size_t... Indices>
+        static constexpr std::array<std::string_view, sizeof...(Indices)> GetBoundFieldNames(std::index_sequence<Indices...>)
+        {
+            return { { std::get<Indices>(havJSONBinding<T>::fields()).mName... } };
+        }
+
+        // Returns the position of the field with the given name, or the number of fields if there's none. Members usually come
+        // in the order they were bound in, so the field after the previous one is compared first.
+        template<typename T>
+        static std::size_t FindBoundField(std::string_view key, std::size_t nextPosition)
+        {
+            static constexpr std::array<std::string_view, std::tuple_size_v<decltype(havJSONBinding<T>::fields())>> fieldNames = GetBoundFieldNames<T>(std::make_index_sequence<std::tuple_size_v<decltype(havJSONBinding<T>::fields())>>());
+
+            if (nextPosition < fieldNames.size() && fieldNames[nextPosition] == key)
+            {
+                return nextPosition;
+            }
+
+            for (std::size_t position = 0; position < fieldNames.size(); ++position)
+            {
+                if (fieldNames[position] == key)
+                {
+                    return position;
+                }
+            }
+
+            return fieldNames.size();
+        }
+
+        template<typename T, std::size_t... Indices>
+        bool ReadBoundField(std::string_view::size_type& index, [[maybe_unused]] std::string_view jsonStringStream, T& value, std::size_t position, std::index_sequence<Indices...>)
+        {
+            // Note: Unused for structs without fields
+            [[maybe_unused]] constexpr auto fields = havJSONBinding<T>::fields();
+
+            bool result = false;
+
+            // Note: Expands to a chain of position compares, so each member is read by code specialized for its type
+            static_cast<void>(((Indices == position && ((result = ReadBoundValue(index, jsonStringStream, value.*(std::get<Indices>(fields).mMember))), true)) || ...));
+
+            return result;
+        }
+
+        template<typename T>
+        bool ParseBoundContents(std::string_view jsonStringStream, T& value)
+        {
+            // Note: havJSONData members are parsed by the recursive descent parser, which uses the scratch buffers
+            mArrayDepth = 0;
+            mObjectDepth = 0;
+
+            std::string_view::size_type index = 0;
+
+            havJSONPhaseScope phaseScope = MeasurePhase(havJSONPhase::Parsing, jsonStringStream.size());
+
+            try
+            {
+                BeginParse(jsonStringStream.size());
+
+                SkipWhitespacesDirect(index, jsonStringStream);
+
+                if (index >= jsonStringStream.size())
+                {
+                    return SetError(havJSONErrorCode::EmptyInput, jsonStringStream, index);
+                }
+
+                bool result = ReadBoundValue(index, jsonStringStream, value);
+
+                if (result == true)
+                {
+                    SkipWhitespacesDirect(index, jsonStringStream);
+
+                    // Only whitespace may follow the root node
+                    result = (index == jsonStringStream.size());
+                }
+
+                ClearScratch();
+
+                if (result == false)
+                {
+                    SetSyntaxError(jsonStringStream, index);
+                }
+
+                return result;
+            }
+            catch (const havJSONLimitError&)
+            {
+                ClearScratch();
+
+                return SetError(havJSONErrorCode::LimitExceeded, jsonStringStream, index);
+            }
+            catch (const std::exception&)
+            {
+                ClearScratch();
+
+                SetSyntaxError(jsonStringStream, index);
+
+                throw;
+            }
+            catch (...)
+            {
+                ClearScratch();
+
+                throw;
+            }
+        }
+
+        bool ParseJSONContents(std::string_view jsonStringStream, havJSONData& valueNode)
+        {
+            try
+            {
+                BeginParse(jsonStringStream.size());
+
+                // Note: Only the recursive descent parser can skip the values a filter doesn't select
+                if (mParserType == havJSONParserType::RecursiveDescent || mFilter != nullptr)
+                {
+                    return ParseJSONContentsDirect(jsonStringStream, valueNode);
+                }
+            }
+            catch (const havJSONLimitError&)
+            {
+                // Note: The recursive descent parser has recorded where the limit was exceeded already
+                if (mLastResult.mCode == havJSONErrorCode::None)
+                {
+                    SetError(havJSONErrorCode::LimitExceeded, jsonStringStream, 0);
+                }
+
+                return false;
+            }
+
+            std::string_view::size_type index = 0;
+
+            try
+            {
+                havJSONPhaseScope phaseScope = MeasurePhase(havJSONPhase::Tokenization, jsonStringStream.size());
+
+                // 1. Tokenization phase
+                if (Tokenization(jsonStringStream, index) == false)
+                {
+                    // Note: No tokens were found
+                    index = havJSONScanner::SkipWhitespaces(jsonStringStream.data(), 0, jsonStringStream.size());
+
+                    return SetError((index >= jsonStringStream.size()) ? havJSONErrorCode::EmptyInput : havJSONErrorCode::SyntaxError, jsonStringStream, index);
+                }
+            }
+            catch (const havJSONLimitError&)
+            {
+                mTokens.clear();
+
+                return SetError(havJSONErrorCode::LimitExceeded, jsonStringStream, index);
+            }
+            catch (const std::exception&)
+            {
+                SetSyntaxError(jsonStringStream, index);
+
+                throw;
+            }
+
+            // Note: The tokens have been counted against the node limit already
+            mNumOfNodes = 0;
+
+            try
+            {
+                havJSONPhaseScope phaseScope = MeasurePhase(havJSONPhase::TreeBuilding, jsonStringStream.size());
+
+                // 2. Parse JSON contents
+                if (ParseJSONContents(valueNode) == true)
+                {
+                    return true;
+                }
+            }
+            catch (const havJSONLimitError&)
+            {
+                mTokens.clear();
+
+                return SetError(havJSONErrorCode::LimitExceeded, jsonStringStream, jsonStringStream.size());
+            }
+            catch (const std::exception&)
+            {
+                SetTokenError(jsonStringStream);
+
+                throw;
+            }
+
+            return SetTokenError(jsonStringStream);
+        }
+
+        void SetParserType(havJSONParserType parserType) { mParserType = parserType; }
+
+        void SetParseOptions(const havJSONParseOptions& parseOptions) { mParseOptions = parseOptions; }
+
+        const havJSONParseOptions& GetParseOptions() const { return mParseOptions; }
+
+        // Resets the counters of the parse limits and the last result, and checks the size of the next input
+        void BeginParse(std::size_t contentSize)
+        {
+            mNumOfNodes = 0;
+            mDepthLevel = 0;
+
+            mLastResult = havJSONResult();
+
+            if (contentSize > mParseOptions.mMaxBytes)
+            {
+                throw havJSONLimitError("Maximum input size exceeded!");
+            }
+        }
+
+        // Result of the last parse, also after a parse function returned false or threw
+        const havJSONResult& GetLastResult() const { return mLastResult; }
+
+        // Records the error of the current parse and returns false. Line and column are only counted here, so rejecting input
+        // costs at most one more pass over the part that was read.
+        bool SetError(havJSONErrorCode errorCode, std::string_view jsonStringStream, std::size_t offset)
+        {
+            offset = std::min(offset, jsonStringStream.size());
+
+            std::string_view readContents = jsonStringStream.substr(0, offset);
+
+            std::string_view::size_type lineStart = readContents.rfind('\n');
+
+            mLastResult.mCode = errorCode;
+            mLastResult.mOffset = offset;
+            mLastResult.mLine = std::count(readContents.begin(), readContents.end(), '\n') + 1;
+            mLastResult.mColumn = offset - ((lineStart == std::string_view::npos) ? 0 : lineStart + 1) + 1;
+
+            return false;
+        }
+
+        // Records an error without a position in text, e.g. in BSON input
+        bool SetError(havJSONErrorCode errorCode, std::size_t offset)
+        {
+            mLastResult.mCode = errorCode;
+            mLastResult.mOffset = offset;
+            mLastResult.mLine = 0;
+            mLastResult.mColumn = 0;
+
+            return false;
+        }
+
+        // Records a syntax error at offset, unless an error has been recorded already. Input that ends before the error tells
+        // truncated input apart from malformed input.
+        bool SetSyntaxError(std::string_view jsonStringStream, std::size_t offset)
+        {
+            if (mLastResult.mCode != havJSONErrorCode::None)
+            {
+                return false;
+            }
+
+            return SetError((offset >= jsonStringStream.size()) ? havJSONErrorCode::UnexpectedEnd : havJSONErrorCode::SyntaxError, jsonStringStream, offset);
+        }
+
+        // Records a syntax error at the first token the tokenizer's tree building didn't get to
+        bool SetTokenError(std::string_view jsonStringStream)
+        {
+            std::size_t offset = (mTokens.empty() == true) ? jsonStringStream.size() : mTokens.front().mOffset;
+
+            mTokens.clear();
+
+            return SetSyntaxError(jsonStringStream, offset);
+        }
+
+        // Messages of ParseFile and the write functions go to errorStream. nullptr turns them off.
+        void SetErrorStream(std::ostream* errorStream) { mErrorStream = errorStream; }
+
+        template<typename... Args>
+        void LogError(const Args&... args) const
+        {
+            if (mErrorStream != nullptr)
+            {
+                (*mErrorStream << ... << args);
+            }
+        }
+
+#ifdef HAVJSON_STATS
+        const havJSONStats& GetStats() const { return mStats; }
+
+        void ResetStats() { mStats.reset(); }
+
+        havJSONPhaseScope MeasurePhase(havJSONPhase phase, std::size_t numOfBytes = 0) { return havJSONPhaseScope(mStats, phase, numOfBytes); }
+#else
+        havJSONPhaseScope MeasurePhase(havJSONPhase /* phase */, std::size_t /* numOfBytes */ = 0) { return havJSONPhaseScope(); }
+#endif
+
+        void CheckStringLength(std::size_t stringLength) const
+        {
+            if (stringLength > mParseOptions.mMaxStringLength)
+            {
+                throw havJSONLimitError("Maximum string length exceeded!");
+            }
+        }
+
+        havJSONParserType GetParserType() const { return mParserType; }
+
+        havJSONBOMType DetectBOMType(std::string_view fileContents, int& bytesToSkip)
+        {
+            bytesToSkip = 0;
+
+            if (fileContents.size() < 4)
+            {
+                return havJSONBOMType::None;
+            }
+
+            const unsigned char bomArray[4] = { static_cast<unsigned char>(fileContents[0]), static_cast<unsigned char>(fileContents[1]),
+                                                static_cast<unsigned char>(fileContents[2]), static_cast<unsigned char>(fileContents[3]) };
+
+            if (bomArray[0] == 0xff && bomArray[1] == 0xfe &&
+                bomArray[2] == 0x00 && bomArray[3] == 0x00)
+            {
+                bytesToSkip = 4;
+
+                return havJSONBOMType::UTF32LE;
+            }
+
+            if (bomArray[0] == 0x00 && bomArray[1] == 0x00 &&
+                bomArray[2] == 0xfe && bomArray[3] == 0xff)
+            {
+                bytesToSkip = 4;
+
+                return havJSONBOMType::UTF32BE;
+            }
+
+            if (bomArray[0] == 0xff && bomArray[1] == 0xfe)
+            {
+                bytesToSkip = 2;
+
+                return havJSONBOMType::UTF16LE;
+            }
+
+            if (bomArray[0] == 0xfe && bomArray[1] == 0xff)
+            {
+                bytesToSkip = 2;
+
+                return havJSONBOMType::UTF16BE;
+            }
+
+            if (bomArray[0] == 0xef && bomArray[1] == 0xbb && bomArray[2] == 0xbf)
+            {
+                bytesToSkip = 3;
+
+                return havJSONBOMType::UTF8;
+            }
+
+            // If no BOM has been found, we still need to check for the file encoding
+            if (bomArray[0] != 0x00 && bomArray[1] == 0x00 &&
+                bomArray[2] == 0x00 && bomArray[3] == 0x00)
+            {
+                return havJSONBOMType::UTF32LE;
+            }
+
+            if (bomArray[0] == 0x00 && bomArray[1] == 0x00 &&
+                bomArray[2] == 0x00 && bomArray[3] != 0x00)
+            {
+                return havJSONBOMType::UTF32BE;
+            }
+
+            if (bomArray[0] != 0x00 && bomArray[1] == 0x00 &&
+                bomArray[2] != 0x00 && bomArray[3] == 0x00)
+            {
+                return havJSONBOMType::UTF16LE;
+            }
+
+            if (bomArray[0] == 0x00 && bomArray[1] != 0x00 &&
+                bomArray[2] == 0x00 && bomArray[3] != 0x00)
+            {
+                return havJSONBOMType::UTF16BE;
+            }
+
+            return havJSONBOMType::None;
+        }
+
+        void AppendCodePoint(std::string& value, const unsigned int codePoint)
+        {
+            if (codePoint < 0x80)
+            {
+                value += static_cast<char>(codePoint);
+            }
+            else if (codePoint < 0x800)
+            {
+                const char bytes[2] = { static_cast<char>((codePoint >> 6) | 0xc0), static_cast<char>((codePoint & 0x3f) | 0x80) };
+
+                value.append(bytes, 2);
+            }
+            else if (codePoint < 0x10000)
+            {
+                const char bytes[3] = { static_cast<char>((codePoint >> 12) | 0xe0), static_cast<char>(((codePoint >> 6) & 0x3f) | 0x80),
+                                        static_cast<char>((codePoint & 0x3f) | 0x80) };
+
+                value.append(bytes, 3);
+            }
+            else if (codePoint < 0x110000)
+            {
+                const char bytes[4] = { static_cast<char>((codePoint >> 18) | 0xf0), static_cast<char>(((codePoint >> 12) & 0x3f) | 0x80),
+                                        static_cast<char>(((codePoint >> 6) & 0x3f) | 0x80), static_cast<char>((codePoint & 0x3f) | 0x80) };
+
+                value.append(bytes, 4);
+            }
+            else
+            {
+                throw std::runtime_error("Invalid code point!");
+            }
+        }
+
+        std::string ConvertUTF16ToUTF8(std::string_view fileContents, bool bigEndian)
+        {
+            const unsigned char* data = reinterpret_cast<const unsigned char*>(fileContents.data());
+
+            std::string::size_type numOfCodeUnits = fileContents.size() / 2;
+
+            std::string resultValue;
+
+            // ASCII-heavy documents need one byte per code unit
+            resultValue.reserve(numOfCodeUnits);
+
+            for (std::string::size_type index = 0; index < numOfCodeUnits; ++index)
+            {
+                unsigned int codeUnit = (bigEndian == true) ? ((data[index * 2] << 8) | data[index * 2 + 1]) : ((data[index * 2 + 1] << 8) | data[index * 2]);
+
+                // Code point is UTF-16 surrogate pair
+                if (codeUnit >= 0xd800 && codeUnit <= 0xdbff)
+                {
+                    if (++index >= numOfCodeUnits)
+                    {
+                        throw std::runtime_error("Invalid UTF-16 sequence!");
+                    }
+
+                    unsigned int lowSurrogate = (bigEndian == true) ? ((data[index * 2] << 8) | data[index * 2 + 1]) : ((data[index * 2 + 1] << 8) | data[index * 2]);
+
+                    if (lowSurrogate < 0xdc00 || lowSurrogate > 0xdfff)
+                    {
+                        throw std::runtime_error("Invalid UTF-16 sequence!");
+                    }
+
+                    codeUnit = 0x10000 + ((codeUnit - 0xd800) * 0x400) + (lowSurrogate - 0xdc00);
+                }
+                else if (codeUnit >= 0xdc00 && codeUnit <= 0xdfff)
+                {
+                    throw std::runtime_error("Invalid UTF-16 sequence!");
+                }
+
+                AppendCodePoint(resultValue, codeUnit);
+            }
+
+            return resultValue;
+        }
+
+        std::string ConvertUTF32ToUTF8(std::string_view fileContents, bool bigEndian)
+        {
+            const unsigned char* data = reinterpret_cast<const unsigned char*>(fileContents.data());
+
+            std::string::size_type numOfCodeUnits = fileContents.size() / 4;
+
+            std::string resultValue;
+
+            resultValue.reserve(numOfCodeUnits);
+
+            for (std::string::size_type index = 0; index < numOfCodeUnits; ++index)
+            {
+                const unsigned char* codeUnitData = data + index * 4;
+
+                unsigned int codePoint = (bigEndian == true) ?
+                    ((static_cast<unsigned int>(codeUnitData[0]) << 24) | (codeUnitData[1] << 16) | (codeUnitData[2] << 8) | codeUnitData[3]) :
+                    ((static_cast<unsigned int>(codeUnitData[3]) << 24) | (codeUnitData[2] << 16) | (codeUnitData[1] << 8) | codeUnitData[0]);
+
+                if (codePoint >= 0xd800 && codePoint <= 0xdfff)
+                {
+                    throw std::runtime_error("Invalid UTF-32 sequence!");
+                }
+
+                AppendCodePoint(resultValue, codePoint);
+            }
+
+            return resultValue;
+        }
+
+        // Note: Offsets in the result of a JSON file count from the end of the BOM, in the UTF-8 contents
+        bool ParseFile(const std::string& fileName, havJSONData& valueNode, havJSONType jsonType = havJSONType::JSON)
+        {
+            mLastResult = havJSONResult();
+
+            // 1. Open file (memory-mapped, or read with a single bulk read)
+            havJSONFileMapping fileMapping;
+
+            bool fileOpened = false;
+
+            {
+                havJSONPhaseScope phaseScope = MeasurePhase(havJSONPhase::FileRead);
+
+#ifdef _WIN32
+                fileOpened = fileMapping.Open(ConvertStringToWString(fileName));
+#else
+                fileOpened = fileMapping.Open(fileName);
+#endif
+
+                phaseScope.SetNumOfBytes(fileMapping.size());
+            }
+
+            if (fileOpened == false)
+            {
+                if (jsonType == havJSONType::BSON)
+                {
+                    LogError("Unable to parse BSON file: ", fileName, "\n");
+                }
+                else
+                {
+                    LogError("Unable to parse JSON file: ", fileName, "\n");
+                }
+
+                SetError(havJSONErrorCode::FileNotOpened, 0);
+
+                havJSONData newValueNode;
+
+                valueNode = std::move(newValueNode);
+
+                return false;
+            }
+
+            return ParseFileMapping(fileName, fileMapping, valueNode, jsonType);
+        }
+
+        // Parses a file that was opened already, e.g. on another thread. fileName is only used in messages.
+        bool ParseFileMapping(const std::string& fileName, const havJSONFileMapping& fileMapping, havJSONData& valueNode, havJSONType jsonType = havJSONType::JSON)
+        {
+            mLastResult = havJSONResult();
+
+            // 1. Check file size
+            if (fileMapping.size() == 0)
+            {
+                if (jsonType == havJSONType::BSON)
+                {
+                    LogError("BSON file is empty!\n");
+                }
+                else
+                {
+                    LogError("JSON file is empty!\n");
+                }
+
+                SetError(havJSONErrorCode::EmptyInput, 0);
+
+                havJSONData newValueNode;
+
+                valueNode = std::move(newValueNode);
+
+                return false;
+            }
+
+            // Note: Files above the size limit are rejected before their contents are looked at
+            if (fileMapping.size() > mParseOptions.mMaxBytes)
+            {
+                if (jsonType == havJSONType::BSON)
+                {
+                    LogError("BSON file is too large!\n");
+                }
+                else
+                {
+                    LogError("JSON file is too large!\n");
+                }
+
+                SetError(havJSONErrorCode::LimitExceeded, 0);
+
+                havJSONData newValueNode;
+
+                valueNode = std::move(newValueNode);
+
+                return false;
+            }
+
+            // 2. Get file contents
+            std::string_view fileContents = fileMapping.view();
+
+            // Holds the file contents in case they have to be converted
+            std::string convertedFileContents;
+
+            // Check for file encoding and BOM (Byte order mark) - BOM is illegal in JSON, but the source JSON file could contain it regardless
+            if (jsonType == havJSONType::JSON)
+            {
+                havJSONPhaseScope phaseScope = MeasurePhase(havJSONPhase::Conversion, fileContents.size());
+
+                int bytesToSkip = 0;
+
+                havJSONBOMType bomType = DetectBOMType(fileContents, bytesToSkip);
+
+                if (bomType != havJSONBOMType::None)
+                {
+                    std::string bomTypeString;
+
+                    switch (bomType)
+                    {
+                    case havJSONBOMType::UTF16LE:
+                        bomTypeString = "UTF-16 Little Endian";
+                        break;
+
+                    case havJSONBOMType::UTF16BE:
+                        bomTypeString = "UTF-16 Big Endian";
+                        break;
+
+                    case havJSONBOMType::UTF32LE:
+                        bomTypeString = "UTF-32 Little Endian";
+                        break;
+
+                    case havJSONBOMType::UTF32BE:
+                        bomTypeString = "UTF-32 Big Endian";
+                        break;
+
+                    default:
+                        bomTypeString = "UTF-8";
+                    }
+
+                    LogError("File starts with ", bomTypeString, " BOM! Please note that the BOM will be skipped, and removed in case the file gets saved!\n");
+                }
+
+                fileContents.remove_prefix(bytesToSkip);
+
+                // Convert the file contents to UTF-8, if necessary
+                if (bomType == havJSONBOMType::UTF16LE ||
+                    bomType == havJSONBOMType::UTF16BE)
+                {
+                    convertedFileContents = ConvertUTF16ToUTF8(fileContents, bomType == havJSONBOMType::UTF16BE);
+
+                    fileContents = convertedFileContents;
+                }
+                else if (bomType == havJSONBOMType::UTF32LE ||
+                         bomType == havJSONBOMType::UTF32BE)
+                {
+                    convertedFileContents = ConvertUTF32ToUTF8(fileContents, bomType == havJSONBOMType::UTF32BE);
+
+                    fileContents = convertedFileContents;
+                }
+            }
+
+            if (jsonType == havJSONType::BSON)
+            {
+                // 3. Parse BSON contents
+                if (ParseBSONContents(fileContents, valueNode) == true)
+                {
+                    return true;
+                }
+
+                LogError("Unable to parse BSON file: ", fileName, "\n");
+
+                havJSONData newValueNode;
+
+                valueNode = std::move(newValueNode);
+
+                return false;
+            }
+
+            // 3. Parse JSON contents
+            if (ParseJSONContents(fileContents, valueNode) == true)
+            {
+                return true;
+            }
+
+            // 4. Return JSON contents as havJSONData object
+            havJSONData newValueNode;
+
+            valueNode = std::move(newValueNode);
+
+            return false;
+        }
+
+        // Parses the file into the document. All nodes are allocated from the document's arena, which is cleared first.
+        bool ParseFile(const std::string& fileName, havJSONDocument& document, havJSONType jsonType = havJSONType::JSON)
+        {
+            document.clear();
+
+            havJSONArenaScope arenaScope(mArena, &document.arena());
+
+            return ParseFile(fileName, document.root(), jsonType);
+        }
+
+        // Parses the content into the document. All nodes are allocated from the document's arena, which is cleared first.
+        bool ParseContent(std::string_view fileContents, havJSONDocument& document)
+        {
+            document.clear();
+
+            havJSONArenaScope arenaScope(mArena, &document.arena());
+
+            return ParseContent(fileContents, document.root());
+        }
+
+        // Parses only the values selected by the filter. Arrays keep the selected elements in order, without gaps. The values that
+        // are skipped are only checked for matching quotation marks and brackets.
+        bool ParseContent(std::string_view fileContents, havJSONData& valueNode, const havJSONFilter& filter)
+        {
+            havJSONFilterScope filterScope(mFilter, &filter);
+
+            return ParseContent(fileContents, valueNode);
+        }
+
+        bool ParseContent(std::string_view fileContents, havJSONDocument& document, const havJSONFilter& filter)
+        {
+            havJSONFilterScope filterScope(mFilter, &filter);
+
+            return ParseContent(fileContents, document);
+        }
+
+        bool ParseContent(const char* fileContents, std::size_t fileSize, havJSONData& valueNode)
+        {
+            return ParseContent(std::string_view(fileContents, fileSize), valueNode);
+        }
+
+        bool ParseContent(std::string_view fileContents, havJSONData& valueNode)
+        {
+            // 1. Parse JSON contents
+            if (ParseJSONContents(fileContents, valueNode) == true)
+            {
+                return true;
+            }
+
+            // 2. Return JSON contents as havJSONData object
+            havJSONData newValueNode;
+
+            valueNode = std::move(newValueNode);
+
+            return false;
+        }
+
+        // Reports the content to the handler instead of building a tree
+        bool ParseContent(const char* fileContents, std::size_t fileSize, havJSONSAXHandler& handler)
+        {
+            return ParseContent(std::string_view(fileContents, fileSize), handler);
+        }
+
+        bool ParseContent(std::string_view fileContents, havJSONSAXHandler& handler)
+        {
+            return ParseRootSAX(fileContents, handler);
+        }
+
+        // Parses the content straight into a bound struct (see havJSONBinding) or a std::vector of bindable values, without
+        // building a tree. On failure, value is reset.
+        template<typename T, std::enable_if_t<havJSONIsBindableRoot<T>::value, int> = 0>
+        bool ParseContent(std::string_view fileContents, T& value)
+        {
+            // 1. Parse JSON contents
+            if (ParseBoundContents(fileContents, value) == true)
+            {
+                return true;
+            }
+
+            // 2. Reset value
+            value = T();
+
+            return false;
+        }
+
+        // Parses the BSON content into the document. All nodes are allocated from the document's arena, which is cleared first.
+        bool ParseBSONContent(std::string_view fileContents, havJSONDocument& document)
+        {
+            document.clear();
+
+            havJSONArenaScope arenaScope(mArena, &document.arena());
+
+            return ParseBSONContent(fileContents, document.root());
+        }
+
+        bool ParseBSONContent(const char* fileContents, std::size_t fileSize, havJSONData& valueNode)
+        {
+            return ParseBSONContent(std::string_view(fileContents, fileSize), valueNode);
+        }
+
+        bool ParseBSONContent(std::string_view fileContents, havJSONData& valueNode)
+        {
+            // 1. Parse BSON contents
+            if (ParseBSONContents(fileContents, valueNode) == true)
+            {
+                return true;
+            }
+
+            // 2. Return BSON contents as havJSONData object
+            havJSONData newValueNode;
+
+            valueNode = std::move(newValueNode);
+
+            return false;
+        }
+
+        // The TryParse functions work like their Parse counterparts, but report malformed input through the result instead of
+        // throwing. On failure, the tree (or struct) is reset.
+        havJSONResult TryParseFile(const std::string& fileName, havJSONData& valueNode, havJSONType jsonType = havJSONType::JSON)
+        {
+            return TryParse(valueNode, [&]() { return ParseFile(fileName, valueNode, jsonType); });
+        }
+
+        havJSONResult TryParseFile(const std::string& fileName, havJSONDocument& document, havJSONType jsonType = havJSONType::JSON)
+        {
+            return TryParse(document, [&]() { return ParseFile(fileName, document, jsonType); });
+        }
+
+        havJSONResult TryParseFileMapping(const std::string& fileName, const havJSONFileMapping& fileMapping, havJSONData& valueNode, havJSONType jsonType = havJSONType::JSON)
+        {
+            return TryParse(valueNode, [&]() { return ParseFileMapping(fileName, fileMapping, valueNode, jsonType); });
+        }
+
+        havJSONResult TryParseContent(std::string_view fileContents, havJSONData& valueNode)
+        {
+            return TryParse(valueNode, [&]() { return ParseContent(fileContents, valueNode); });
+        }
+
+        havJSONResult TryParseContent(std::string_view fileContents, havJSONDocument& document)
+        {
+            return TryParse(document, [&]() { return ParseContent(fileContents, document); });
+        }
+
+        havJSONResult TryParseContent(std::string_view fileContents, havJSONData& valueNode, const havJSONFilter& filter)
+        {
+            return TryParse(valueNode, [&]() { return ParseContent(fileContents, valueNode, filter); });
+        }
+
+        havJSONResult TryParseContent(std::string_view fileContents, havJSONDocument& document, const havJSONFilter& filter)
+        {
+            return TryParse(document, [&]() { return ParseContent(fileContents, document, filter); });
+        }
+
+        havJSONResult TryParseContent(std::string_view fileContents, havJSONSAXHandler& handler)
+        {
+            return TryParse(handler, [&]() { return ParseContent(fileContents, handler); });
+        }
+
+        template<typename T, std::enable_if_t<havJSONIsBindableRoot<T>::value, int> = 0>
+        havJSONResult TryParseContent(std::string_view fileContents, T& value)
+        {
+            return TryParse(value, [&]() { return ParseContent(fileContents, value); });
+        }
+
+        havJSONResult TryParseBSONContent(std::string_view fileContents, havJSONData& valueNode)
+        {
+            return TryParse(valueNode, [&]() { return ParseBSONContent(fileContents, valueNode); });
+        }
+
+        void TokenizeArray(const std::vector<std::shared_ptr<havJSONData>>& rootArray, std::deque<havJSONTokenValue>& tokens)
+        {
+            for (std::vector<std::shared_ptr<havJSONData>>::size_type index = 0; index < rootArray.size(); ++index)
+            {
+                if (index > 0)
+                {
+                    tokens.push_back(havJSONTokenValue { havJSONToken::Comma, std::nullopt });
+                }
+
+                const havJSONData* currentValue = rootArray[index].get();
+
+                switch (currentValue->getType())
+                {
+                    case havJSONDataType::Null:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::Null, std::string("null") });
+                        break;
+
+                    case havJSONDataType::Boolean:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::Boolean, std::get<bool>(currentValue->getValueRef()) ? "true" : "false" });
+                        break;
+
+                    case havJSONDataType::Int:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::Int, std::to_string(std::get<int>(currentValue->getValueRef())) });
+                        break;
+
+                    case havJSONDataType::UInt:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::UInt, std::to_string(std::get<unsigned int>(currentValue->getValueRef())) });
+                        break;
+
+                    case havJSONDataType::Long:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::Long, std::to_string(std::get<long>(currentValue->getValueRef())) });
+                        break;
+
+                    case havJSONDataType::ULong:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::ULong, std::to_string(std::get<unsigned long>(currentValue->getValueRef())) });
+                        break;
+
+                    case havJSONDataType::Int64:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::Int64, std::to_string(std::get<long long>(currentValue->getValueRef())) });
+                        break;
+
+                    case havJSONDataType::UInt64:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::UInt64, std::to_string(std::get<unsigned long long>(currentValue->getValueRef())) });
+                        break;
+
+                    case havJSONDataType::Double:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::Double, havJSONNumberConverter::ToString(std::get<double>(currentValue->getValueRef())) });
+                        break;
+
+                    case havJSONDataType::String:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::Value, std::get<std::string>(currentValue->getValueRef()) });
+                        break;
+
+                    case havJSONDataType::Array:
+                        {
+                            tokens.push_back(havJSONTokenValue { havJSONToken::LeftSquareBracket, std::nullopt });
+
+                            const std::vector<std::shared_ptr<havJSONData>>& newArray = std::get<std::vector<std::shared_ptr<havJSONData>>>(currentValue->getValueRef());
+
+                            TokenizeArray(newArray, tokens);
+                        }
+                        break;
+
+                    case havJSONDataType::Object:
+                        {
+                            tokens.push_back(havJSONTokenValue { havJSONToken::LeftCurlyBracket, std::nullopt });
+
+                            const havJSONObject& rootObject = std::get<havJSONObject>(currentValue->getValueRef());
+
+                            TokenizeObject(rootObject, tokens);
+                        }
+                        break;
+                }
+            }
+
+            tokens.push_back(havJSONTokenValue { havJSONToken::RightSquareBracket, std::nullopt });
+        }
+
+        void TokenizeObject(const havJSONObject& rootObject, std::deque<havJSONTokenValue>& tokens)
+        {
+            for (havJSONObject::const_iterator itr = rootObject.begin(); itr != rootObject.end(); ++itr)
+            {
+                if (itr != rootObject.begin())
+                {
+                    tokens.push_back(havJSONTokenValue { havJSONToken::Comma, std::nullopt });
+                }
+
+                const havJSONData* item = (*itr).second.get();
+
+                tokens.push_back(havJSONTokenValue { havJSONToken::String, (*itr).first });
+                tokens.push_back(havJSONTokenValue { havJSONToken::Colon, std::nullopt });
+
+                switch (item->getType())
+                {
+                    case havJSONDataType::Null:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::Null, std::string("null") });
+                        break;
+
+                    case havJSONDataType::Boolean:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::Boolean, std::get<bool>(item->getValueRef()) ? "true" : "false" });
+                        break;
+
+                    case havJSONDataType::Int:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::Int, std::to_string(std::get<int>(item->getValueRef())) });
+                        break;
+
+                    case havJSONDataType::UInt:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::UInt, std::to_string(std::get<unsigned int>(item->getValueRef())) });
+                        break;
+
+                    case havJSONDataType::Long:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::Long, std::to_string(std::get<long>(item->getValueRef())) });
+                        break;
+
+                    case havJSONDataType::ULong:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::ULong, std::to_string(std::get<unsigned long>(item->getValueRef())) });
+                        break;
+
+                    case havJSONDataType::Int64:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::Int64, std::to_string(std::get<long long>(item->getValueRef())) });
+                        break;
+
+                    case havJSONDataType::UInt64:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::UInt64, std::to_string(std::get<unsigned long long>(item->getValueRef())) });
+                        break;
+
+                    case havJSONDataType::Double:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::Double, havJSONNumberConverter::ToString(std::get<double>(item->getValueRef())) });
+                        break;
+
+                    case havJSONDataType::String:
+                        tokens.push_back(havJSONTokenValue { havJSONToken::Value, std::get<std::string>(item->getValueRef()) });
+                        break;
+
+                    case havJSONDataType::Array:
+                        {
+                            tokens.push_back(havJSONTokenValue { havJSONToken::LeftSquareBracket, std::nullopt });
+
+                            const std::vector<std::shared_ptr<havJSONData>>& rootArray = std::get<std::vector<std::shared_ptr<havJSONData>>>(item->getValueRef());
+
+                            TokenizeArray(rootArray, tokens);
+                        }
+                        break;
+
+                    case havJSONDataType::Object:
+                        {
+                            tokens.push_back(havJSONTokenValue { havJSONToken::LeftCurlyBracket, std::nullopt });
+
+                            const havJSONObject& newObject = std::get<havJSONObject>(item->getValueRef());
+
+                            TokenizeObject(newObject, tokens);
+                        }
+                        break;
+                }
+            }
+
+            tokens.push_back(havJSONTokenValue { havJSONToken::RightCurlyBracket, std::nullopt });
+        }
+
+        bool Tokenization(const havJSONData& rootNode, std::deque<havJSONTokenValue>& tokens)
+        {
+            havJSONToken currentTypeToken = havJSONToken::None;
+
+            if (rootNode.isArray() == true)
+            {
+                currentTypeToken = havJSONToken::LeftSquareBracket;
+            }
+
+            if (rootNode.isObject() == true)
+            {
+                currentTypeToken = havJSONToken::LeftCurlyBracket;
+            }
+
+            if (currentTypeToken == havJSONToken::None)
+            {
+                throw std::runtime_error("Invalid token: Expected array or object as root node!");
+            }
+
+            tokens.push_back(havJSONTokenValue { currentTypeToken, std::nullopt });
+
+            if (rootNode.isArray() == true)
+            {
+                const std::vector<std::shared_ptr<havJSONData>>& rootArray = std::get<std::vector<std::shared_ptr<havJSONData>>>(rootNode.getValueRef());
+
+                TokenizeArray(rootArray, tokens);
+            }
+
+            if (rootNode.isObject() == true)
+            {
+                const havJSONObject& rootObject = std::get<havJSONObject>(rootNode.getValueRef());
+
+                TokenizeObject(rootObject, tokens);
+            }
+
+            return tokens.size() > 0;
+        }
+
+        bool ConvertJSONToString(const havJSONData& valueNode, std::string& jsonContentsAsString, bool formatted = false)
+        {
+            havJSONOutputBuffer outputBuffer(jsonContentsAsString);
+
+            return WriteJSON(valueNode, outputBuffer, formatted);
+        }
+
+        // Writes the tree straight to the output buffer without an intermediate token stream.
+        bool WriteJSON(const havJSONData& valueNode, havJSONOutputBuffer& outputBuffer, bool formatted = false)
+        {
+            havJSONPhaseScope phaseScope = MeasurePhase(havJSONPhase::Serialization);
+
+            std::size_t numOfBytes = outputBuffer.GetNumOfBytes();
+
+            havJSONWriter writer(formatted);
+
+            bool result = writer.Write(valueNode, outputBuffer);
+
+            phaseScope.SetNumOfBytes(outputBuffer.GetNumOfBytes() - numOfBytes);
+
+            return result;
+        }
+
+        // Like ConvertJSONToString above, but only the arrays and objects that were marked as changed in the cache since the last
+        // call are written again (see havJSONSerializationCache). The others are copied from the previous output.
+        bool ConvertJSONToString(const havJSONData& valueNode, std::string& jsonContentsAsString, havJSONSerializationCache& cache, bool formatted = false)
+        {
+            WriteCachedJSON(valueNode, cache, formatted);
+
+            jsonContentsAsString.append(cache.content());
+
+            return true;
+        }
+
+        // Writes a bound struct (see havJSONBinding) or a std::vector of bindable values
+        template<typename T, std::enable_if_t<havJSONIsBindableRoot<T>::value, int> = 0>
+        bool ConvertJSONToString(const T& value, std::string& jsonContentsAsString, bool formatted = false)
+        {
+            havJSONOutputBuffer outputBuffer(jsonContentsAsString);
+
+            return WriteJSON(value, outputBuffer, formatted);
+        }
+
+        template<typename T, std::enable_if_t<havJSONIsBindableRoot<T>::value, int> = 0>
+        bool WriteJSON(const T& value, havJSONOutputBuffer& outputBuffer, bool formatted = false)
+        {
+            havJSONPhaseScope phaseScope = MeasurePhase(havJSONPhase::Serialization);
+
+            std::size_t numOfBytes = outputBuffer.GetNumOfBytes();
+
+            havJSONWriter writer(formatted);
+
+            bool result = writer.WriteBound(value, outputBuffer);
+
+            phaseScope.SetNumOfBytes(outputBuffer.GetNumOfBytes() - numOfBytes);
+
+            return result;
+        }
+
+        // Note: BOM is illegal in JSON!
+        bool WriteJSONFile(const std::string& fileName, const havJSONData& valueNode, std::string& jsonContentsAsString, bool formatted = false)
+        {
+            // 1. Open file stream
+#ifdef _WIN32
+            std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(_wfopen(&ConvertStringToWString(fileName)[0], L"wb"), std::fclose);
+#else
+            std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(std::fopen(fileName.c_str(), "wb"), std::fclose);
+#endif
+
+            if (fileStream == nullptr)
+            {
+                LogError("Unable to write JSON file: ", fileName, "\n");
+
+                return false;
+            }
+
+            // 2. Convert JSON to string
+            if (ConvertJSONToString(valueNode, jsonContentsAsString, formatted) == true)
+            {
+                std::fwrite(jsonContentsAsString.data(), sizeof(char), jsonContentsAsString.size(), fileStream.get());
+
+                return true;
+            }
+
+            return false;
+        }
+
+        // Writes the tree with the cache (see the cached ConvertJSONToString)
+        bool WriteJSONFile(const std::string& fileName, const havJSONData& valueNode, havJSONSerializationCache& cache, bool formatted = false)
+        {
+            // 1. Open file stream
+#ifdef _WIN32
+            std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(_wfopen(&ConvertStringToWString(fileName)[0], L"wb"), std::fclose);
+#else
+            std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(std::fopen(fileName.c_str(), "wb"), std::fclose);
+#endif
+
+            if (fileStream == nullptr)
+            {
+                LogError("Unable to write JSON file: ", fileName, "\n");
+
+                return false;
+            }
+
+            // 2. Convert JSON to string
+            WriteCachedJSON(valueNode, cache, formatted);
+
+            // 3. Write string to file stream
+            if (std::fwrite(cache.content().data(), sizeof(char), cache.content().size(), fileStream.get()) != cache.content().size())
+            {
+                LogError("Unable to write JSON file: ", fileName, "\n");
+
+                return false;
+            }
+
+            return true;
+        }
+
+        // Note: Streams the output to the file in large chunks instead of building the whole document in memory first.
+        bool WriteJSONFile(const std::string& fileName, const havJSONData& valueNode, bool formatted = false)
+        {
+            // 1. Open file stream
+#ifdef _WIN32
+            std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(_wfopen(&ConvertStringToWString(fileName)[0], L"wb"), std::fclose);
+#else
+            std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(std::fopen(fileName.c_str(), "wb"), std::fclose);
+#endif
+
+            if (fileStream == nullptr)
+            {
+                LogError("Unable to write JSON file: ", fileName, "\n");
+
+                return false;
+            }
+
+            // 2. Write JSON to file stream
+            havJSONOutputBuffer outputBuffer(fileStream.get());
+
+            if (WriteJSON(valueNode, outputBuffer, formatted) == false)
+            {
+                LogError("Unable to write JSON file: ", fileName, "\n");
+
+                return false;
+            }
+
+            return true;
+        }
+
+        // Encodes the tree as a complete BSON document (including its size prefix)
+        bool ConvertJSONToBSON(const havJSONData& valueNode, std::vector<char>& jsonContentsAsBinaryStream)
+        {
+            havJSONPhaseScope phaseScope = MeasurePhase(havJSONPhase::BSONSerialization);
+
+            jsonContentsAsBinaryStream.clear();
+
+            havJSONBSONWriter writer;
+
+            writer.Write(valueNode, jsonContentsAsBinaryStream);
+
+            phaseScope.SetNumOfBytes(jsonContentsAsBinaryStream.size());
+
+            return jsonContentsAsBinaryStream.empty() == false;
+        }
+
+        bool WriteBSONFile(const std::string& fileName, const havJSONData& valueNode, std::vector<char>& jsonContentsAsBinaryStream)
+        {
+            // 1. Open file stream
+#ifdef _WIN32
+            std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(_wfopen(&ConvertStringToWString(fileName)[0], L"wb"), std::fclose);
+#else
+            std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(std::fopen(fileName.c_str(), "wb"), std::fclose);
+#endif
+
+            if (fileStream == nullptr)
+            {
+                LogError("Unable to write BSON file: ", fileName, "\n");
+
+                return false;
+            }
+
+            // 2. Convert JSON to BSON
+            if (ConvertJSONToBSON(valueNode, jsonContentsAsBinaryStream) == true)
+            {
+                // 3. Write file contents to binary file in one go
+                if (std::fwrite(jsonContentsAsBinaryStream.data(), sizeof(char), jsonContentsAsBinaryStream.size(), fileStream.get()) != jsonContentsAsBinaryStream.size())
+                {
+                    LogError("Unable to write BSON file: ", fileName, "\n");
+
+                    return false;
+                }
+
+                return true;
+            }
+
+            return false;
+        }
+
+#ifdef _WIN32
+        std::wstring ConvertStringToWString(const std::string& value)
+        {
+            int numOfChars = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, value.c_str(), -1, nullptr, 0);
+
+            std::wstring wstr(numOfChars, 0);
+
+            numOfChars = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, value.c_str(), -1, &wstr[0], numOfChars);
+
+            if (numOfChars > 0)
+            {
+                return wstr;
+            }
+
+            return std::wstring();
+        }
+#endif
+
+    private:
+        // Sets the arena nodes are allocated from for the lifetime of the scope
+        class havJSONArenaScope
+        {
+        public:
+            havJSONArenaScope(havJSONArena*& arena, havJSONArena* newArena) : mArena(arena), mPreviousArena(arena) { mArena = newArena; }
+            ~havJSONArenaScope() { mArena = mPreviousArena; }
+
+        private:
+            havJSONArena*& mArena;
+            havJSONArena* mPreviousArena;
+        };
+
+        // Sets the filter of the parse for the lifetime of the scope
+        class havJSONFilterScope
+        {
+        public:
+            havJSONFilterScope(const havJSONFilter*& filter, const havJSONFilter* newFilter) : mFilter(filter), mPreviousFilter(filter) { mFilter = newFilter; }
+            ~havJSONFilterScope() { mFilter = mPreviousFilter; }
+
+        private:
+            const havJSONFilter*& mFilter;
+            const havJSONFilter* mPreviousFilter;
+        };
+
+        // Runs a parse function and turns a thrown parse error into the result
+        template<typename T, typename Function>
+        havJSONResult TryParse(T& value, Function&& parseFunction)
+        {
+            try
+            {
+                if (parseFunction() == true)
+                {
+                    return mLastResult;
+                }
+            }
+            catch (const std::exception&)
+            {
+                ResetValue(value);
+            }
+
+            // Note: E.g. an invalid UTF-16 sequence in a file is found before the parse itself starts
+            if (mLastResult.mCode == havJSONErrorCode::None)
+            {
+                mLastResult.mCode = havJSONErrorCode::SyntaxError;
+            }
+
+            return mLastResult;
+        }
+
+        void ResetValue(havJSONData& valueNode) { valueNode = havJSONData(); }
+        void ResetValue(havJSONDocument& document) { document.clear(); }
+        void ResetValue(havJSONSAXHandler& /* handler */) {}
+
+        template<typename T, std::enable_if_t<havJSONIsBindableRoot<T>::value, int> = 0>
+        void ResetValue(T& value) { value = T(); }
+
+        void WriteCachedJSON(const havJSONData& valueNode, havJSONSerializationCache& cache, bool formatted)
+        {
+            havJSONPhaseScope phaseScope = MeasurePhase(havJSONPhase::Serialization);
+
+            havJSONWriter writer(formatted);
+
+            writer.WriteCached(valueNode, cache);
+
+            phaseScope.SetNumOfBytes(cache.content().size());
+        }
+
+        // Counts a nested array or object against the depth limit for the lifetime of the scope
+        class havJSONDepthScope
+        {
+        public:
+            explicit havJSONDepthScope(havJSONStream& stream) : mStream(stream)
+            {
+                // Note: The recursion limit also applies if the parse options allow deeper input, since every level is a stack frame
+                if (mStream.mDepthLevel >= mStream.mParseOptions.mMaxDepth || mStream.mDepthLevel >= HAVJSON_MAX_RECURSION_DEPTH)
+                {
+                    throw havJSONLimitError("Maximum depth exceeded!");
+                }
+
+                ++mStream.mDepthLevel;
+            }
+
+            ~havJSONDepthScope() { --mStream.mDepthLevel; }
+
+            havJSONDepthScope(const havJSONDepthScope&) = delete;
+            havJSONDepthScope& operator=(const havJSONDepthScope&) = delete;
+
+        private:
+            havJSONStream& mStream;
+        };
+
+        std::deque<havJSONTokenValue> mTokens;
+
+        havJSONArena* mArena = nullptr;
+
+        // Set while a filtered parse is running
+        const havJSONFilter* mFilter = nullptr;
+
+        havJSONParseOptions mParseOptions;
+
+        // Counters of the current parse for the limits in mParseOptions
+        std::size_t mNumOfNodes = 0;
+        std::size_t mDepthLevel = 0;
+
+        havJSONResult mLastResult;
+
+#ifdef HAVJSON_STATS
+        havJSONStats mStats;
+#endif
+
+        // Note: Defaults to the console, like before there was a way to turn it off
+        std::ostream* mErrorStream = &std::cout;
+
+        // Per-depth scratch buffers of the recursive descent parser
+        std::vector<std::vector<std::shared_ptr<havJSONData>>> mArrayScratch;
+        std::size_t mArrayDepth = 0;
+        std::vector<std::vector<havJSONObject::value_type>> mObjectScratch;
+        std::size_t mObjectDepth = 0;
+
+        // Decoded key of the recursive descent parser for keys with escape sequences
+        std::string mKeyString;
+
+#ifdef HAVJSON_INTERNED_KEYS
+        // Kept between parses, so the keys of all documents parsed by this stream are shared
+        havJSONKeyTable mKeyTable;
+#endif
+
+        // Decoded string of the SAX parser for strings with escape sequences
+        std::string mSAXString;
+
+        // Decoded strings of bound structs
+        std::string mBindString;
+
+        havJSONParserType mParserType = havJSONParserType::Tokenizer;
+    };
+
+    // Resumable parser for input that arrives in chunks (e.g. from a socket). Each chunk is parsed as far as possible when it's
+    // fed; only an incomplete token at the end of a chunk is kept until the next one arrives. Builds the same tree as
+    // havJSONStream::ParseContent with the recursive descent parser.
+    class havJSONStreamParser
+    {
+    public:
+        havJSONStreamParser() = default;
+
+        havJSONStreamParser(const havJSONStreamParser&) = delete;
+        havJSONStreamParser& operator=(const havJSONStreamParser&) = delete;
+
+        // Parses the next chunk. Returns false as soon as the input is known to be invalid.
+        bool feed(const char* data, std::size_t size)
+        {
+            return feed(std::string_view(data, size));
+        }
+
+        bool feed(std::string_view data)
+        {
+            if (mFailed == true)
+            {
+                return false;
+            }
+
+            mNumOfBytes += data.size();
+
+            if (mNumOfBytes > mStream.GetParseOptions().mMaxBytes)
+            {
+                Fail();
+
+                return false;
+            }
+
+            try
+            {
+                if (mPending.empty() == true)
+                {
+                    // Parse straight from the chunk and only copy what's left of it
+                    std::size_t index = ParseChunk(data);
+
+                    mPending.assign(data.data() + index, data.size() - index);
+                }
+                else
+                {
+                    mPending.append(data.data(), data.size());
+
+                    std::size_t index = ParseChunk(mPending);
+
+                    mPending.erase(0, index);
+                }
+            }
+            catch (const std::exception&)
+            {
+                // Note: Besides the limits, the string, literal and number readers throw on malformed input
+                Fail();
+            }
+            catch (...)
+            {
+                mFailed = true;
+
+                throw;
+            }
+
+            return mFailed == false;
+        }
+
+        // Signals the end of the input and moves the parsed tree into valueNode. The parser can be used again afterwards.
+        bool finish(havJSONData& valueNode)
+        {
+            bool result = (mFailed == false && mState == havJSONStreamParserState::Done && mPending.empty() == true);
+
+            if (result == true)
+            {
+                valueNode = std::move(mRoot);
+            }
+            else
+            {
+                havJSONData newValueNode;
+
+                valueNode = std::move(newValueNode);
+            }
+
+            reset();
+
+            return result;
+        }
+
+        // Discards the current input, e.g. after a connection was dropped
+        void reset()
+        {
+            mStream.BeginParse(0);
+            mNumOfBytes = 0;
+            mRoot = havJSONData();
+            mContainers.clear();
+            mDiscardedContainers.clear();
+            mPending.clear();
+            mKey.clear();
+            mStringScanOffset = 0;
+            mState = havJSONStreamParserState::Root;
+            mFailed = false;
+        }
+
+        bool failed() const { return mFailed; }
+
+        // Limits the input of the next and all following documents. Input is counted over all chunks.
+        void setParseOptions(const havJSONParseOptions& parseOptions) { mStream.SetParseOptions(parseOptions); }
+
+    private:
+        enum class havJSONStreamParserState : std::uint8_t
+        {
+            Root,            // '{' or '['
+            FirstArrayValue, // value or ']'
+            Value,           // value
+            FirstObjectKey,  // name or '}'
+            ObjectKey,       // name
+            Colon,           // ':'
+            CommaOrEnd,      // ',' or the closing bracket of the current container
+            Done             // only whitespace may follow the root node
+        };
+
+        // Checks if the string starting at index is complete. Scanning resumes where the previous chunk ended.
+        bool IsStringComplete(std::string_view jsonStringStream, std::size_t index)
+        {
+            std::size_t scanIndex = index + ((mStringScanOffset > 0) ? mStringScanOffset : 1);
+
+            while (true)
+            {
+                scanIndex = havJSONScanner::FindStringSpecial(jsonStringStream.data(), scanIndex, jsonStringStream.size());
+
+                if (scanIndex >= jsonStringStream.size())
+                {
+                    break;
+                }
+
+                if (jsonStringStream[scanIndex] == '"')
+                {
+                    mStringScanOffset = 0;
+
+                    return true;
+                }
+
+                // Skip the escaped character, the backslash is looked at again if it's the last character of the chunk
+                if (scanIndex + 1 >= jsonStringStream.size())
+                {
+                    break;
+                }
+
+                scanIndex += 2;
+            }
+
+            mStringScanOffset = std::min(scanIndex, jsonStringStream.size()) - index;
+
+            // Note: A string that never ends fails once it's longer than the limit, instead of piling up in the pending input
+            mStream.CheckStringLength(mStringScanOffset - 1);
+
+            return false;
+        }
+
+        // Adds a value to the current container. Returns false if its key is a duplicate, in which case valueNode isn't moved from.
+        bool AddValue(std::shared_ptr<havJSONData>&& valueNode)
+        {
+            havJSONData& containerNode = *mContainers.back();
+
+            mState = havJSONStreamParserState::CommaOrEnd;
+
+            if (containerNode.isArray() == true)
+            {
+                std::get_if<std::vector<std::shared_ptr<havJSONData>>>(containerNode.getAddress())->push_back(std::move(valueNode));
+
+                return true;
+            }
+
+            // Note: Like the other parsers, the first occurrence of a duplicate key wins
+            auto result = std::get_if<havJSONObject>(containerNode.getAddress())->insert({ mStream.MakeKey(mKey), nullptr });
+
+            mKey.clear();
+
+            if (result.second == true)
+            {
+                result.first->second = std::move(valueNode);
+            }
+
+            return result.second;
+        }
+
+        // Starts a value at index. Returns false if the value isn't complete yet.
+        bool ParseValue(std::string_view jsonStringStream, std::size_t& index)
+        {
+            char currentChar = jsonStringStream[index];
+
+            switch (currentChar)
+            {
+            case '{':
+            case '[':
+                {
+                    std::shared_ptr<havJSONData> valueNode = mStream.CreateNode((currentChar == '{') ? havJSONDataType::Object : havJSONDataType::Array);
+
+                    // Note: A container under a duplicate key isn't part of the tree, so it's kept alive here until it's closed
+                    havJSONData* containerNode = valueNode.get();
+
+                    if (AddValue(std::move(valueNode)) == false)
+                    {
+                        mDiscardedContainers.push_back({ mContainers.size(), std::move(valueNode) });
+                    }
+
+                    mContainers.push_back(containerNode);
+
+                    if (mContainers.size() > mStream.GetParseOptions().mMaxDepth)
+                    {
+                        throw havJSONLimitError("Maximum depth exceeded!");
+                    }
+
+                    mState = (currentChar == '{') ? havJSONStreamParserState::FirstObjectKey : havJSONStreamParserState::FirstArrayValue;
+
+                    ++index;
+                }
+                return true;
+
+            case '"':
+                {
+                    if (IsStringComplete(jsonStringStream, index) == false)
+                    {
+                        return false;
+                    }
+
+                    std::string tempValue;
+
+                    mStream.ReadStringValue(index, jsonStringStream, tempValue);
+
+                    // Skip closing quotation mark
+                    ++index;
+
+                    AddValue(mStream.CreateNode(std::move(tempValue), havJSONDataType::String));
+                }
+                return true;
+
+            case 't':
+            case 'f':
+            case 'n':
+                {
+                    std::string literalValue = ((currentChar == 't') ? "true" : ((currentChar == 'f') ? "false" : "null"));
+
+                    if (jsonStringStream.size() - index < literalValue.size())
+                    {
+                        return false;
+                    }
+
+                    mStream.CheckForLiteral(++index, jsonStringStream, literalValue);
+
+                    // Skip last character of the literal
+                    ++index;
+
+                    if (currentChar == 'n')
+                    {
+                        AddValue(mStream.CreateNode(havJSONDataType::Null));
+                    }
+                    else
+                    {
+                        AddValue(mStream.CreateNode(currentChar == 't'));
+                    }
+                }
+                return true;
+
+            default:
+                if (currentChar == '-' || (currentChar >= '0' && currentChar <= '9'))
+                {
+                    // A number is only complete once a character that can't be part of it follows
+                    std::size_t endIndex = index;
+
+                    while (endIndex < jsonStringStream.size() && havJSONNumberConverter::IsNumberCharacter(jsonStringStream[endIndex]) == true)
+                    {
+                        ++endIndex;
+                    }
+
+                    if (endIndex >= jsonStringStream.size())
+                    {
+                        return false;
+                    }
+
+                    std::shared_ptr<havJSONData> valueNode = mStream.ReadNumberDirect(index, jsonStringStream.substr(0, endIndex));
+
+                    // Like the recursive descent parser, characters left over (e.g. "01") are a syntax error
+                    if (index != endIndex)
+                    {
+                        Fail();
+
+                        return false;
+                    }
+
+                    AddValue(std::move(valueNode));
+
+                    return true;
+                }
+
+                Fail();
+
+                return false;
+            }
+        }
+
+        // Closes the current container if currentChar is its closing bracket
+        bool CloseContainer(char currentChar)
+        {
+            if (currentChar != (mContainers.back()->isArray() == true ? ']' : '}'))
+            {
+                Fail();
+
+                return false;
+            }
+
+            mContainers.pop_back();
+
+            if (mDiscardedContainers.empty() == false && mDiscardedContainers.back().first == mContainers.size())
+            {
+                mDiscardedContainers.pop_back();
+            }
+
+            mState = (mContainers.empty() == true) ? havJSONStreamParserState::Done : havJSONStreamParserState::CommaOrEnd;
+
+            return true;
+        }
+
+        void Fail()
+        {
+            mFailed = true;
+        }
+
+        // Parses as many complete tokens as possible. Returns the index of the first character that hasn't been consumed yet.
+        std::size_t ParseChunk(std::string_view jsonStringStream)
+        {
+            std::size_t index = 0;
+
+            while (mFailed == false)
+            {
+                index = havJSONScanner::SkipWhitespaces(jsonStringStream.data(), index, jsonStringStream.size());
+
+                if (index >= jsonStringStream.size())
+                {
+                    break;
+                }
+
+                char currentChar = jsonStringStream[index];
+
+                switch (mState)
+                {
+                case havJSONStreamParserState::Root:
+                    if (currentChar != '{' && currentChar != '[')
+                    {
+                        Fail();
+
+                        break;
+                    }
+
+                    mStream.CountNode();
+
+                    mRoot = havJSONData((currentChar == '{') ? havJSONDataType::Object : havJSONDataType::Array);
+
+                    mContainers.push_back(&mRoot);
+
+                    mState = (currentChar == '{') ? havJSONStreamParserState::FirstObjectKey : havJSONStreamParserState::FirstArrayValue;
+
+                    ++index;
+                    break;
+
+                case havJSONStreamParserState::FirstArrayValue:
+                    if (currentChar == ']')
+                    {
+                        CloseContainer(currentChar);
+
+                        ++index;
+
+                        break;
+                    }
+
+                    [[fallthrough]];
+
+                case havJSONStreamParserState::Value:
+                    if (ParseValue(jsonStringStream, index) == false)
+                    {
+                        return index;
+                    }
+                    break;
+
+                case havJSONStreamParserState::FirstObjectKey:
+                    if (currentChar == '}')
+                    {
+                        CloseContainer(currentChar);
+
+                        ++index;
+
+                        break;
+                    }
+
+                    [[fallthrough]];
+
+                case havJSONStreamParserState::ObjectKey:
+                    if (currentChar != '"')
+                    {
+                        Fail();
+
+                        break;
+                    }
+
+                    if (IsStringComplete(jsonStringStream, index) == false)
+                    {
+                        return index;
+                    }
+
+                    mStream.ReadStringValue(index, jsonStringStream, mKey);
+
+                    // Skip closing quotation mark
+                    ++index;
+
+                    mState = havJSONStreamParserState::Colon;
+                    break;
+
+                case havJSONStreamParserState::Colon:
+                    if (currentChar != ':')
+                    {
+                        Fail();
+
+                        break;
+                    }
+
+                    mState = havJSONStreamParserState::Value;
+
+                    ++index;
+                    break;
+
+                case havJSONStreamParserState::CommaOrEnd:
+                    if (currentChar == ',')
+                    {
+                        mState = (mContainers.back()->isArray() == true) ? havJSONStreamParserState::Value : havJSONStreamParserState::ObjectKey;
+                    }
+                    else
+                    {
+                        CloseContainer(currentChar);
+                    }
+
+                    ++index;
+                    break;
+
+                case havJSONStreamParserState::Done:
+                    // Only whitespace may follow the root node
+                    Fail();
+                    break;
+                }
+            }
+
+            return index;
+        }
+
+        havJSONStream mStream;
+
+        havJSONData mRoot;
+
+        // Open containers, the innermost one is at the back
+        std::vector<havJSONData*> mContainers;
+
+        // Open containers that were dropped because of a duplicate key, with their position in mContainers
+        std::vector<std::pair<std::size_t, std::shared_ptr<havJSONData>>> mDiscardedContainers;
+
+        // Unconsumed end of the previous chunk (an incomplete token)
+        std::string mPending;
+
+        // Name of the object member whose value is parsed next
+        std::string mKey;
+
+        // Offset into the incomplete string up to which it has already been scanned
+        std::size_t mStringScanOffset = 0;
+        // Input over all chunks of the current document
+        std::size_t mNumOfBytes = 0;
+
+        havJSONStreamParserState mState = havJSONStreamParserState::Root;
+
+        bool mFailed = false;
+    };
+
+    // Document that is parsed on demand. parse() only runs a structural pre-pass that records where every object and array
+    // starts and ends. Values are decoded when they're accessed through havJSONLazyValue, and both the member lists of visited
+    // containers and decoded values are cached. Syntax errors inside values that are never accessed aren't detected.
+    // Note: Not thread-safe, because accessing values updates the caches.
+    class havJSONLazyDocument
+    {
+    public:
+        // Lightweight handle to a value of a havJSONLazyDocument, only valid as long as the document isn't cleared
+        class havJSONLazyValue
+        {
+        public:
+            havJSONLazyValue(havJSONLazyDocument* document, std::size_t index) : mDocument(document), mIndex(index) {}
+
+            bool isArray() const { return mDocument->CharAt(mIndex) == '['; }
+            bool isObject() const { return mDocument->CharAt(mIndex) == '{'; }
+            bool isNull() const { return mDocument->CharAt(mIndex) == 'n'; }
+            bool isBoolean() const { return mDocument->CharAt(mIndex) == 't' || mDocument->CharAt(mIndex) == 'f'; }
+            bool isString() const { return mDocument->CharAt(mIndex) == '"'; }
+            bool isNumber() const { return mDocument->CharAt(mIndex) == '-' || (mDocument->CharAt(mIndex) >= '0' && mDocument->CharAt(mIndex) <= '9'); }
+
+            // Note: Decodes numbers to tell the exact type
+            havJSONDataType getType() { return (isArray() == true) ? havJSONDataType::Array : ((isObject() == true) ? havJSONDataType::Object : value().getType()); }
+
+            // Decodes the value (and all values below it) into a havJSONData. The result is cached.
+            havJSONData& value() { return mDocument->GetValue(mIndex); }
+
+            bool toBoolean(bool explicitCast = false, bool defaultValue = false) { return value().toBoolean(explicitCast, defaultValue); }
+            int toInt(bool explicitCast = false, int defaultValue = 0) { return value().toInt(explicitCast, defaultValue); }
+            unsigned int toUInt(bool explicitCast = false, unsigned int defaultValue = 0) { return value().toUInt(explicitCast, defaultValue); }
+            long toLong(bool explicitCast = false, long defaultValue = 0) { return value().toLong(explicitCast, defaultValue); }
+            unsigned long toULong(bool explicitCast = false, unsigned long defaultValue = 0) { return value().toULong(explicitCast, defaultValue); }
+            long long toInt64(bool explicitCast = false, long long defaultValue = 0) { return value().toInt64(explicitCast, defaultValue); }
+            unsigned long long toUInt64(bool explicitCast = false, unsigned long long defaultValue = 0) { return value().toUInt64(explicitCast, defaultValue); }
+            double toDouble(bool explicitCast = false, double defaultValue = 0.0) { return value().toDouble(explicitCast, defaultValue); }
+            std::string toString() { return value().toString(); }
+
+            // Array
+            havJSONLazyValue at(int index)
+            {
+                const std::vector<std::size_t>& valueIndices = mDocument->GetContainer(mIndex, '[').mValueIndices;
+
+                if (index < 0 || static_cast<std::size_t>(index) >= valueIndices.size())
+                {
+                    throw std::out_of_range("Index is out of range!");
+                }
+
+                return havJSONLazyValue(mDocument, valueIndices[index]);
+            }
+
+            havJSONLazyValue operator[](int index) { return at(index); }
+
+            std::size_t arraySize() { return mDocument->GetContainer(mIndex, '[').mValueIndices.size(); }
+
+            // Object
+            havJSONLazyValue find(std::string_view key)
+            {
+                std::size_t valueIndex = 0;
+
+                if (mDocument->FindKey(mIndex, key, valueIndex) == false)
+                {
+                    throw std::runtime_error("Key was not found in object!");
+                }
+
+                return havJSONLazyValue(mDocument, valueIndex);
+            }
+
+            havJSONLazyValue operator[](const char* key) { return find(key); }
+            havJSONLazyValue operator[](const std::string& key) { return find(key); }
+
+            bool contains(std::string_view key)
+            {
+                std::size_t valueIndex = 0;
+
+                return mDocument->FindKey(mIndex, key, valueIndex);
+            }
+
+            std::size_t objectSize() { return mDocument->GetContainer(mIndex, '{').mValueIndices.size(); }
+
+            // Member or element at the given position, in document order
+            havJSONLazyValue childAt(std::size_t index)
+            {
+                const std::vector<std::size_t>& valueIndices = mDocument->GetContainer(mIndex, (isArray() == true) ? '[' : '{').mValueIndices;
+
+                if (index >= valueIndices.size())
+                {
+                    throw std::out_of_range("Index is out of range!");
+                }
+
+                return havJSONLazyValue(mDocument, valueIndices[index]);
+            }
+
+            // Name of the member at the given position
+            const std::string& keyAt(std::size_t index)
+            {
+                const std::vector<std::string>& keys = mDocument->GetContainer(mIndex, '{').mKeys;
+
+                if (index >= keys.size())
+                {
+                    throw std::out_of_range("Index is out of range!");
+                }
+
+                return keys[index];
+            }
+
+        private:
+            havJSONLazyDocument* mDocument;
+            std::size_t mIndex;
+        };
+
+        havJSONLazyDocument() { mStream.SetParserType(havJSONParserType::RecursiveDescent); }
+
+        // Messages of parseFile go to errorStream. nullptr turns them off.
+        void setErrorStream(std::ostream* errorStream) { mStream.SetErrorStream(errorStream); }
+
+        havJSONLazyDocument(const havJSONLazyDocument&) = delete;
+        havJSONLazyDocument& operator=(const havJSONLazyDocument&) = delete;
+
+        // Runs the structural pre-pass. The content isn't copied and has to outlive the document.
+        bool parse(std::string_view content)
+        {
+            clear();
+
+            // Skip UTF-8 BOM
+            if (content.size() >= 3 && content.substr(0, 3) == "\xEF\xBB\xBF")
+            {
+                content.remove_prefix(3);
+            }
+
+            mContent = content;
+
+            if (IndexContainers() == false)
+            {
+                clear();
+
+                return false;
+            }
+
+            return true;
+        }
+
+        // Maps the file into memory (or reads it) and runs the structural pre-pass
+        bool parseFile(const std::string& fileName)
+        {
+            clear();
+
+            mFileMapping.Close();
+
+#ifdef _WIN32
+            bool fileOpened = mFileMapping.Open(mStream.ConvertStringToWString(fileName));
+#else
+            bool fileOpened = mFileMapping.Open(fileName);
+#endif
+
+            if (fileOpened == false)
+            {
+                mStream.LogError("Unable to parse JSON file: ", fileName, "\n");
+
+                return false;
+            }
+
+            return parse(mFileMapping.view());
+        }
+
+        havJSONLazyValue root()
+        {
+            if (mOpenIndices.empty() == true)
+            {
+                throw std::runtime_error("No root node found!");
+            }
+
+            return havJSONLazyValue(this, mOpenIndices[0]);
+        }
+
+        void clear()
+        {
+            mContent = std::string_view();
+            mOpenIndices.clear();
+            mCloseIndices.clear();
+            mContainers.clear();
+            mValues.clear();
+        }
+
+    private:
+        struct havJSONLazyContainer
+        {
+            std::vector<std::size_t> mValueIndices;
+            // Decoded names, only used for objects
+            std::vector<std::string> mKeys;
+        };
+
+        char CharAt(std::size_t index) const { return mContent[index]; }
+
+        // Records the start and end of every object and array and checks that brackets and strings are balanced
+        bool IndexContainers()
+        {
+            std::vector<std::size_t> openContainers;
+
+            std::size_t index = havJSONScanner::SkipWhitespaces(mContent.data(), 0, mContent.size());
+
+            if (index >= mContent.size() || (mContent[index] != '{' && mContent[index] != '['))
+            {
+                return false;
+            }
+
+            for (; index < mContent.size(); ++index)
+            {
+                switch (mContent[index])
+                {
+                case '{':
+                case '[':
+                    openContainers.push_back(mOpenIndices.size());
+                    mOpenIndices.push_back(index);
+                    mCloseIndices.push_back(0);
+                    break;
+
+                case '}':
+                case ']':
+                    {
+                        if (openContainers.empty() == true || mContent[mOpenIndices[openContainers.back()]] != ((mContent[index] == '}') ? '{' : '['))
+                        {
+                            return false;
+                        }
+
+                        mCloseIndices[openContainers.back()] = index;
+                        openContainers.pop_back();
+
+                        if (openContainers.empty() == true)
+                        {
+                            // Only whitespace may follow the root node
+                            return havJSONScanner::SkipWhitespaces(mContent.data(), index + 1, mContent.size()) == mContent.size();
+                        }
+                    }
+                    break;
+
+                case '"':
+                    index = FindStringEnd(index);
+
+                    if (index >= mContent.size())
+                    {
+                        return false;
+                    }
+                    break;
+
+                default:
+                    break;
+                }
+            }
+
+            return false;
+        }
+
+        // Returns the index of the closing quotation mark of the string starting at index
+        std::size_t FindStringEnd(std::size_t index) const
+        {
+            ++index;
+
+            while (true)
+            {
+                index = havJSONScanner::FindStringSpecial(mContent.data(), index, mContent.size());
+
+                if (index >= mContent.size() || mContent[index] == '"')
+                {
+                    return index;
+                }
+
+                // Skip the escaped character
+                index += 2;
+            }
+        }
+
+        std::size_t FindContainerEnd(std::size_t index) const
+        {
+            std::vector<std::size_t>::const_iterator itr = std::lower_bound(mOpenIndices.begin(), mOpenIndices.end(), index);
+
+            return mCloseIndices[itr - mOpenIndices.begin()];
+        }
+
+        // Returns the index past the end of the value starting at index
+        std::size_t SkipValue(std::size_t index) const
+        {
+            switch (mContent[index])
+            {
+            case '{':
+            case '[':
+                return FindContainerEnd(index) + 1;
+
+            case '"':
+                return FindStringEnd(index) + 1;
+
+            default:
+                while (index < mContent.size() && mContent[index] != ',' && mContent[index] != ']' && mContent[index] != '}' &&
+                       mContent[index] != ' ' && mContent[index] != '\n' && mContent[index] != '\r' && mContent[index] != '\t')
+                {
+                    ++index;
+                }
+
+                return index;
+            }
+        }
+
+        // Lists the members of the container at index once; later calls return the cached list
+        const havJSONLazyContainer& GetContainer(std::size_t index, char expectedType)
+        {
+            if (mContent[index] != expectedType)
+            {
+                throw std::runtime_error((expectedType == '[') ? "Value is not an array!" : "Value is not an object!");
+            }
+
+            auto itr = mContainers.find(index);
+
+            if (itr != mContainers.end())
+            {
+                return itr->second;
+            }
+
+            havJSONLazyContainer container;
+
+            std::size_t containerIndex = index;
+            std::size_t endIndex = FindContainerEnd(index);
+
+            index = havJSONScanner::SkipWhitespaces(mContent.data(), index + 1, endIndex);
+
+            while (index < endIndex)
+            {
+                if (expectedType == '{')
+                {
+                    if (mContent[index] != '"')
+                    {
+                        throw std::runtime_error("Invalid object member!");
+                    }
+
+                    std::string key;
+
+                    mStream.ReadStringValue(index, mContent, key);
+
+                    container.mKeys.push_back(std::move(key));
+
+                    index = havJSONScanner::SkipWhitespaces(mContent.data(), index + 1, endIndex);
+
+                    if (index >= endIndex || mContent[index] != ':')
+                    {
+                        throw std::runtime_error("Invalid object member!");
+                    }
+
+                    index = havJSONScanner::SkipWhitespaces(mContent.data(), index + 1, endIndex);
+
+                    if (index >= endIndex)
+                    {
+                        throw std::runtime_error("Invalid object member!");
+                    }
+                }
+
+                std::size_t valueEndIndex = SkipValue(index);
+
+                if (valueEndIndex == index)
                 {
-                    tokenTypeReferences.pop_back();
+                    throw std::runtime_error("Missing value!");
                 }
 
-                bool processed = false;
+                container.mValueIndices.push_back(index);
 
-                // Read contents of string token
-                if (token.mToken == havJSONToken::String)
+                index = havJSONScanner::SkipWhitespaces(mContent.data(), valueEndIndex, endIndex);
+
+                if (index < endIndex)
                 {
-                    std::string key = token.mValue.value();
+                    if (mContent[index] != ',')
+                    {
+                        throw std::runtime_error("Expected comma between values!");
+                    }
 
-                    mTokens.pop_front();
-                    token = mTokens.front();
+                    index = havJSONScanner::SkipWhitespaces(mContent.data(), index + 1, endIndex);
 
-                    if (token.mToken == havJSONToken::Colon)
+                    if (index >= endIndex)
                     {
-                        mTokens.pop_front();
-                        token = mTokens.front();
+                        throw std::runtime_error("Trailing comma found!");
+                    }
+                }
+            }
 
-                        if (token.mToken == havJSONToken::Value ||
-                            token.mToken == havJSONToken::Null ||
-                            token.mToken == havJSONToken::Boolean ||
-                            token.mToken == havJSONToken::Int ||
-                            token.mToken == havJSONToken::UInt ||
-                            token.mToken == havJSONToken::Long ||
-                            token.mToken == havJSONToken::ULong ||
-                            token.mToken == havJSONToken::Int64 ||
-                            token.mToken == havJSONToken::UInt64 ||
-                            token.mToken == havJSONToken::Double)
-                        {
-                            havJSONData value;
+            return mContainers.emplace(containerIndex, std::move(container)).first->second;
+        }
 
-                            switch (token.mToken)
-                            {
-                            case havJSONToken::Null:
-                                value = havJSONData(token.mValue.value(), havJSONDataType::Null);
-                                break;
+        bool FindKey(std::size_t index, std::string_view key, std::size_t& valueIndex)
+        {
+            const havJSONLazyContainer& container = GetContainer(index, '{');
 
-                            case havJSONToken::Boolean:
-                                value = havJSONData(((token.mValue.value() == "true") ? true : false), havJSONDataType::Boolean);
-                                break;
+            // Note: Like the parsers, the first occurrence of a duplicate key wins
+            for (std::size_t keyIndex = 0; keyIndex < container.mKeys.size(); ++keyIndex)
+            {
+                if (container.mKeys[keyIndex] == key)
+                {
+                    valueIndex = container.mValueIndices[keyIndex];
 
-                            case havJSONToken::Int:
-                                value = havJSONData(static_cast<int>(std::stol(token.mValue.value())), havJSONDataType::Int);
-                                break;
+                    return true;
+                }
+            }
 
-                            case havJSONToken::UInt:
-                                value = havJSONData(static_cast<unsigned int>(std::stoul(token.mValue.value())), havJSONDataType::UInt);
-                                break;
+            return false;
+        }
 
-                            case havJSONToken::Long:
-                                value = havJSONData(static_cast<long>(std::stol(token.mValue.value())), havJSONDataType::Long);
-                                break;
+        havJSONData& GetValue(std::size_t index)
+        {
+            auto itr = mValues.find(index);
 
-                            case havJSONToken::ULong:
-                                value = havJSONData(static_cast<unsigned long>(std::stoul(token.mValue.value())), havJSONDataType::ULong);
-                                break;
+            if (itr != mValues.end())
+            {
+                return itr->second;
+            }
 
-                            case havJSONToken::Int64:
-                                value = havJSONData(static_cast<std::int64_t>(std::stoll(token.mValue.value())), havJSONDataType::Int64);
-                                break;
+            havJSONData valueNode;
 
-                            case havJSONToken::UInt64:
-                                value = havJSONData(static_cast<std::uint64_t>(std::stoull(token.mValue.value())), havJSONDataType::UInt64);
-                                break;
+            if (mContent[index] == '{' || mContent[index] == '[')
+            {
+                if (mStream.ParseContent(mContent.substr(index, FindContainerEnd(index) - index + 1), valueNode) == false)
+                {
+                    throw std::runtime_error("Unable to parse value!");
+                }
+            }
+            else
+            {
+                std::shared_ptr<havJSONData> scalarNode;
 
-                            case havJSONToken::Double:
-                                value = havJSONData(static_cast<double>(std::stod(token.mValue.value())), havJSONDataType::Double);
-                                break;
+                std::string_view::size_type valueIndex = index;
 
-                            case havJSONToken::Value:
-                            default:
-                                value = havJSONData(token.mValue.value(), havJSONDataType::String);
-                            }
+                if (mStream.ParseElementDirect(valueIndex, mContent, scalarNode) == false)
+                {
+                    throw std::runtime_error("Unable to parse value!");
+                }
 
-                            if (tokenTypeReferences.back()->getType() == havJSONDataType::Object)
-                            {
-                                std::get_if<std::map<std::string, std::shared_ptr<havJSONData>>>(tokenTypeReferences.back()->getAddress())->insert({key, std::make_shared<havJSONData>(value.getValue(), value.getType())});
+                valueNode = std::move(*scalarNode);
+            }
 
-                                processed = true;
-                            }
-                            else
-                            {
-                                throw std::runtime_error("Invalid token! Expected object!");
-                            }
-                        }
-                        else if (token.mToken == havJSONToken::LeftSquareBracket)
-                        {
-                            if (tokenTypeReferences.back()->getType() == havJSONDataType::Object)
-                            {
-                                std::map<std::string, std::shared_ptr<havJSONData>>* item = std::get_if<std::map<std::string, std::shared_ptr<havJSONData>>>(tokenTypeReferences.back()->getAddress());
+            return mValues.emplace(index, std::move(valueNode)).first->second;
+        }
 
-                                std::vector<std::shared_ptr<havJSONData>> tmpArray;
-                                auto itr = item->insert({key, std::make_shared<havJSONData>(std::move(tmpArray), havJSONDataType::Array)});
+        havJSONStream mStream;
 
-                                tokenTypeReferences.push_back(itr.first->second.get());
+        havJSONFileMapping mFileMapping;
 
-                                processed = true;
-                            }
-                            else
-                            {
-                                throw std::runtime_error("Invalid token! Expected object!");
-                            }
-                        }
-                        else if (token.mToken == havJSONToken::LeftCurlyBracket)
-                        {
-                            if (tokenTypeReferences.back()->getType() == havJSONDataType::Object)
-                            {
-                                std::map<std::string, std::shared_ptr<havJSONData>>* item = std::get_if<std::map<std::string, std::shared_ptr<havJSONData>>>(tokenTypeReferences.back()->getAddress());
+        std::string_view mContent;
 
-                                std::map<std::string, std::shared_ptr<havJSONData>> tmpObject;
-                                auto itr = item->insert({key, std::make_shared<havJSONData>(std::move(tmpObject), havJSONDataType::Object)});
+        // Start and end of every object and array, ordered by their start
+        std::vector<std::size_t> mOpenIndices;
+        std::vector<std::size_t> mCloseIndices;
 
-                                tokenTypeReferences.push_back(itr.first->second.get());
+        std::unordered_map<std::size_t, havJSONLazyContainer> mContainers;
+        std::unordered_map<std::size_t, havJSONData> mValues;
+    };
 
-                                processed = true;
-                            }
-                            else
-                            {
-                                throw std::runtime_error("Invalid token! Expected object!");
-                            }
-                        }
-                    }
-                }
+    typedef havJSONLazyDocument::havJSONLazyValue havJSONLazyValue;
 
-                if (processed == false)
+    // Compiled JSON Pointer (RFC 6901, e.g. "/Events/0/Name") or JSONPath subset query (e.g. "$.Events[*].Name", "$..Name",
+    // "$['Events'][-1]"). A query is parsed once and can then be evaluated against any number of trees or lazy documents.
+    // With a havJSONLazyDocument, only the containers along the path are visited, so subtrees that can't match are skipped.
+    class havJSONPath
+    {
+    public:
+        explicit havJSONPath(std::string_view expression)
+        {
+            if (expression.empty() == false && expression[0] == '$')
+            {
+                CompilePath(expression);
+            }
+            else
+            {
+                CompilePointer(expression);
+            }
+        }
+
+        // Returns the first match, or nullptr if the path doesn't exist
+        havJSONData* find(havJSONData& rootNode) const
+        {
+            havJSONData* result = nullptr;
+
+            Evaluate(&rootNode, 0, [&result](havJSONData* valueNode) { result = valueNode; return false; });
+
+            return result;
+        }
+
+        std::vector<havJSONData*> findAll(havJSONData& rootNode) const
+        {
+            std::vector<havJSONData*> results;
+
+            Evaluate(&rootNode, 0, [&results](havJSONData* valueNode) { results.push_back(valueNode); return true; });
+
+            return results;
+        }
+
+        bool exists(havJSONData& rootNode) const { return find(rootNode) != nullptr; }
+
+        std::optional<havJSONLazyValue> find(havJSONLazyValue rootValue) const
+        {
+            std::optional<havJSONLazyValue> result;
+
+            Evaluate(rootValue, 0, [&result](havJSONLazyValue value) { result = value; return false; });
+
+            return result;
+        }
+
+        std::vector<havJSONLazyValue> findAll(havJSONLazyValue rootValue) const
+        {
+            std::vector<havJSONLazyValue> results;
+
+            Evaluate(rootValue, 0, [&results](havJSONLazyValue value) { results.push_back(value); return true; });
+
+            return results;
+        }
+
+        bool exists(havJSONLazyValue rootValue) const { return find(rootValue).has_value(); }
+
+        // True if the path can match more than one value
+        bool isMultiple() const
+        {
+            return std::any_of(mSegments.begin(), mSegments.end(), [](const havJSONPathSegment& segment) { return segment.mType != havJSONPathSegmentType::Member; });
+        }
+
+    private:
+        enum class havJSONPathSegmentType : std::uint8_t
+        {
+            Member,         // Object member, or array index if the name is an index
+            Wildcard,       // All members or elements
+            RecursiveMember // Member at any depth below the current value
+        };
+
+        struct havJSONPathSegment
+        {
+            havJSONPathSegmentType mType;
+            std::string mKey;
+            // Set if the name can be used as an array index. Negative indices count from the end of the array (JSONPath only).
+            std::optional<std::int64_t> mIndex;
+        };
+
+        static std::optional<std::int64_t> ParseIndex(std::string_view value, bool allowNegative)
+        {
+            std::string_view digits = (allowNegative == true && value.empty() == false && value[0] == '-') ? value.substr(1) : value;
+
+            // Note: Leading zeros aren't allowed in array indices
+            if (digits.empty() == true || (digits.size() > 1 && digits[0] == '0') || digits.size() > 18 ||
+                std::all_of(digits.begin(), digits.end(), [](char currentChar) { return currentChar >= '0' && currentChar <= '9'; }) == false)
+            {
+                return std::nullopt;
+            }
+
+            std::int64_t index = 0;
+
+            std::from_chars(value.data(), value.data() + value.size(), index);
+
+            return index;
+        }
+
+        void CompilePointer(std::string_view expression)
+        {
+            for (std::string& key : SplitJSONPointer(expression))
+            {
+                std::optional<std::int64_t> arrayIndex = ParseIndex(key, false);
+
+                mSegments.push_back({ havJSONPathSegmentType::Member, std::move(key), arrayIndex });
+            }
+        }
+
+        void CompilePath(std::string_view expression)
+        {
+            std::size_t index = 1;
+
+            while (index < expression.size())
+            {
+                if (expression[index] == '.')
                 {
-                    if (token.mToken == havJSONToken::Value ||
-                        token.mToken == havJSONToken::Null ||
-                        token.mToken == havJSONToken::Boolean ||
-                        token.mToken == havJSONToken::Int ||
-                        token.mToken == havJSONToken::UInt ||
-                        token.mToken == havJSONToken::Long ||
-                        token.mToken == havJSONToken::ULong ||
-                        token.mToken == havJSONToken::Int64 ||
-                        token.mToken == havJSONToken::UInt64 ||
-                        token.mToken == havJSONToken::Double)
+                    havJSONPathSegmentType segmentType = havJSONPathSegmentType::Member;
+
+                    if (++index < expression.size() && expression[index] == '.')
                     {
-                        havJSONData value;
+                        segmentType = havJSONPathSegmentType::RecursiveMember;
 
-                        switch (token.mToken)
-                        {
-                        case havJSONToken::Null:
-                            value = havJSONData(token.mValue.value(), havJSONDataType::Null);
-                            break;
+                        ++index;
+                    }
 
-                        case havJSONToken::Boolean:
-                            value = havJSONData(((token.mValue.value() == "true") ? true : false), havJSONDataType::Boolean);
-                            break;
+                    if (index < expression.size() && expression[index] == '*')
+                    {
+                        // "..*" selects all values below the current one
+                        mSegments.push_back({ (segmentType == havJSONPathSegmentType::RecursiveMember) ? havJSONPathSegmentType::RecursiveMember : havJSONPathSegmentType::Wildcard, "*", std::nullopt });
 
-                        case havJSONToken::Int:
-                            value = havJSONData(static_cast<int>(std::stol(token.mValue.value())), havJSONDataType::Int);
-                            break;
+                        ++index;
 
-                        case havJSONToken::UInt:
-                            value = havJSONData(static_cast<unsigned int>(std::stoul(token.mValue.value())), havJSONDataType::UInt);
-                            break;
+                        continue;
+                    }
 
-                        case havJSONToken::Long:
-                            value = havJSONData(static_cast<long>(std::stol(token.mValue.value())), havJSONDataType::Long);
-                            break;
+                    if (segmentType == havJSONPathSegmentType::RecursiveMember && index < expression.size() && expression[index] == '[')
+                    {
+                        // "..['name']", the bracket is handled below
+                        mSegments.push_back({ havJSONPathSegmentType::RecursiveMember, std::string(), std::nullopt });
 
-                        case havJSONToken::ULong:
-                            value = havJSONData(static_cast<unsigned long>(std::stoul(token.mValue.value())), havJSONDataType::ULong);
-                            break;
+                        continue;
+                    }
+
+                    std::size_t endIndex = index;
+
+                    while (endIndex < expression.size() && expression[endIndex] != '.' && expression[endIndex] != '[')
+                    {
+                        ++endIndex;
+                    }
+
+                    if (endIndex == index)
+                    {
+                        throw std::runtime_error("Invalid JSON path!");
+                    }
+
+                    mSegments.push_back({ segmentType, std::string(expression.substr(index, endIndex - index)), std::nullopt });
+
+                    index = endIndex;
+                }
+                else if (expression[index] == '[')
+                {
+                    std::size_t endIndex = 0;
+
+                    havJSONPathSegment segment { havJSONPathSegmentType::Member, std::string(), std::nullopt };
+
+                    if (index + 1 < expression.size() && (expression[index + 1] == '\'' || expression[index + 1] == '"'))
+                    {
+                        // Quoted name
+                        char quoteChar = expression[index + 1];
+
+                        endIndex = index + 2;
+
+                        for (; endIndex < expression.size() && expression[endIndex] != quoteChar; ++endIndex)
+                        {
+                            if (expression[endIndex] == '\\' && endIndex + 1 < expression.size())
+                            {
+                                ++endIndex;
+                            }
 
-                        case havJSONToken::Int64:
-                            value = havJSONData(static_cast<std::int64_t>(std::stoll(token.mValue.value())), havJSONDataType::Int64);
-                            break;
+                            segment.mKey += expression[endIndex];
+                        }
 
-                        case havJSONToken::UInt64:
-                            value = havJSONData(static_cast<std::uint64_t>(std::stoull(token.mValue.value())), havJSONDataType::UInt64);
-                            break;
+                        if (endIndex + 1 >= expression.size() || expression[endIndex + 1] != ']')
+                        {
+                            throw std::runtime_error("Invalid JSON path!");
+                        }
 
-                        case havJSONToken::Double:
-                            value = havJSONData(static_cast<double>(std::stod(token.mValue.value())), havJSONDataType::Double);
-                            break;
+                        ++endIndex;
+                    }
+                    else
+                    {
+                        endIndex = expression.find(']', index);
 
-                        case havJSONToken::Value:
-                        default:
-                            value = havJSONData(token.mValue.value(), havJSONDataType::String);
+                        if (endIndex == std::string_view::npos)
+                        {
+                            throw std::runtime_error("Invalid JSON path!");
                         }
 
-                        if (tokenTypeReferences.back()->getType() == havJSONDataType::Array)
+                        std::string_view value = expression.substr(index + 1, endIndex - index - 1);
+
+                        if (value == "*")
                         {
-                            std::get_if<std::vector<std::shared_ptr<havJSONData>>>(tokenTypeReferences.back()->getAddress())->push_back(std::make_shared<havJSONData>(value.getValue(), value.getType()));
+                            segment.mType = havJSONPathSegmentType::Wildcard;
                         }
                         else
                         {
-                            throw std::runtime_error("Invalid token! Expected array!");
+                            segment.mIndex = ParseIndex(value, true);
+
+                            if (segment.mIndex.has_value() == false)
+                            {
+                                throw std::runtime_error("Invalid array index in JSON path!");
+                            }
                         }
+
+                        segment.mKey = std::string(value);
                     }
-                }
 
-                mTokens.pop_front();
+                    // "..[...]" was added as an empty recursive segment above, fill it in
+                    if (mSegments.empty() == false && mSegments.back().mType == havJSONPathSegmentType::RecursiveMember && mSegments.back().mKey.empty() == true && mSegments.back().mIndex.has_value() == false)
+                    {
+                        mSegments.back().mKey = (segment.mType == havJSONPathSegmentType::Wildcard) ? "*" : segment.mKey;
+                        mSegments.back().mIndex = segment.mIndex;
+                    }
+                    else
+                    {
+                        mSegments.push_back(std::move(segment));
+                    }
+
+                    index = endIndex + 1;
+                }
+                else
+                {
+                    throw std::runtime_error("Invalid JSON path!");
+                }
             }
+        }
 
-            if (rootNode == nullptr)
+        // Accessors that let Evaluate work on trees and lazy documents alike
+        static bool IsArray(havJSONData* valueNode) { return valueNode->isArray(); }
+        static bool IsObject(havJSONData* valueNode) { return valueNode->isObject(); }
+        static bool IsArray(havJSONLazyValue value) { return value.isArray(); }
+        static bool IsObject(havJSONLazyValue value) { return value.isObject(); }
+
+        static std::size_t ArraySize(havJSONData* valueNode) { return valueNode->arraySize(); }
+        static std::size_t ArraySize(havJSONLazyValue value) { return value.arraySize(); }
+
+        static havJSONData* ArrayValue(havJSONData* valueNode, std::size_t index) { return &valueNode->at(static_cast<int>(index)); }
+        static havJSONLazyValue ArrayValue(havJSONLazyValue value, std::size_t index) { return value.at(static_cast<int>(index)); }
+
+        static bool FindMember(havJSONData* valueNode, const std::string& key, havJSONData*& memberNode)
+        {
+            const havJSONObject& objectValue = std::get<havJSONObject>(valueNode->getValueRef());
+
+            havJSONObject::const_iterator itr = objectValue.find(key);
+
+            if (itr == objectValue.end())
             {
-                throw std::runtime_error("No root node found!");
+                return false;
             }
 
-            havJSONData newValueNode(rootNode->getValue(), rootNode->getType());
-            valueNode = std::move(newValueNode);
+            memberNode = (*itr).second.get();
 
             return true;
         }
 
-        bool ParseFile(const std::string& fileName, havJSONData& valueNode, havJSONType jsonType = havJSONType::JSON)
+        static bool FindMember(havJSONLazyValue value, const std::string& key, havJSONLazyValue& memberValue)
         {
-            // 1. Open file stream
-#ifdef _WIN32
-            std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(_wfopen(&ConvertStringToWString(fileName)[0], L"rb"), std::fclose);
-#else
-            std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(std::fopen(fileName.c_str(), "rb"), std::fclose);
-#endif
+            if (value.contains(key) == false)
+            {
+                return false;
+            }
 
-            if (fileStream == nullptr)
+            memberValue = value.find(key);
+
+            return true;
+        }
+
+        // Calls function for every member or element of the container until it returns false
+        template<typename Function>
+        static bool ForEachChild(havJSONData* valueNode, Function&& function)
+        {
+            if (valueNode->isArray() == true)
             {
-                if (jsonType == havJSONType::BSON)
+                for (const std::shared_ptr<havJSONData>& item : std::get<std::vector<std::shared_ptr<havJSONData>>>(valueNode->getValueRef()))
                 {
-                    std::cout << "Unable to parse BSON file: " << fileName << "\n";
+                    if (function(item.get()) == false)
+                    {
+                        return false;
+                    }
                 }
-                else
+            }
+            else if (valueNode->isObject() == true)
+            {
+                for (const auto& item : std::get<havJSONObject>(valueNode->getValueRef()))
                 {
-                    std::cout << "Unable to parse JSON file: " << fileName << "\n";
+                    if (function(item.second.get()) == false)
+                    {
+                        return false;
+                    }
                 }
+            }
 
-                havJSONData newValueNode;
+            return true;
+        }
 
-                valueNode = std::move(newValueNode);
+        template<typename Function>
+        static bool ForEachChild(havJSONLazyValue value, Function&& function)
+        {
+            if (value.isArray() == true || value.isObject() == true)
+            {
+                std::size_t numOfChildren = (value.isArray() == true) ? value.arraySize() : value.objectSize();
 
-                return false;
+                for (std::size_t index = 0; index < numOfChildren; ++index)
+                {
+                    if (function(value.childAt(index)) == false)
+                    {
+                        return false;
+                    }
+                }
             }
 
-            // 1.5 Get file size
-            std::fseek(fileStream.get(), 0, SEEK_END);
-            long fileSize = std::ftell(fileStream.get());
-            std::fseek(fileStream.get(), 0, SEEK_SET);
+            return true;
+        }
 
-            if (fileSize == 0)
+        // Matches a single member segment, returns false once function asked to stop
+        template<typename Node, typename Function>
+        bool EvaluateMember(Node node, const havJSONPathSegment& segment, std::size_t segmentIndex, Function& function) const
+        {
+            if (IsObject(node) == true)
             {
-                if (jsonType == havJSONType::BSON)
+                Node memberNode = node;
+
+                if (FindMember(node, segment.mKey, memberNode) == true)
                 {
-                    std::cout << "BSON file is empty!\n";
+                    return Evaluate(memberNode, segmentIndex + 1, function);
                 }
-                else
+            }
+            else if (IsArray(node) == true && segment.mIndex.has_value() == true)
+            {
+                std::int64_t arrayIndex = segment.mIndex.value();
+                std::int64_t arraySize = static_cast<std::int64_t>(ArraySize(node));
+
+                if (arrayIndex < 0)
                 {
-                    std::cout << "JSON file is empty!\n";
+                    arrayIndex += arraySize;
                 }
 
-                havJSONData newValueNode;
+                if (arrayIndex >= 0 && arrayIndex < arraySize)
+                {
+                    return Evaluate(ArrayValue(node, static_cast<std::size_t>(arrayIndex)), segmentIndex + 1, function);
+                }
+            }
 
-                valueNode = std::move(newValueNode);
+            return true;
+        }
 
-                return false;
+        template<typename Node, typename Function>
+        bool Evaluate(Node node, std::size_t segmentIndex, Function&& function) const
+        {
+            if (segmentIndex >= mSegments.size())
+            {
+                return function(node);
             }
 
-            // 2. Read file contents
-            std::u16string fileContentsU16;
-            std::u32string fileContentsU32;
-            std::string fileContents;
-
-            // Check for file encoding and BOM (Byte order mark) - BOM is illegal in JSON, but the source JSON file could contain it regardless
-            int bytesToSkip = 0;
-            int skippedBytes = 0;
-            havJSONBOMType bomType = havJSONBOMType::None;
+            const havJSONPathSegment& segment = mSegments[segmentIndex];
 
-            if (fileSize >= 4 && jsonType == havJSONType::JSON)
+            switch (segment.mType)
             {
-                unsigned char unsignedCurrentChar;
+            case havJSONPathSegmentType::Member:
+                return EvaluateMember(node, segment, segmentIndex, function);
 
-                unsigned char bomArray[4] = { '\0' };
+            case havJSONPathSegmentType::Wildcard:
+                return ForEachChild(node, [this, segmentIndex, &function](Node childNode) { return Evaluate(childNode, segmentIndex + 1, function); });
 
-                // Read the first four bytes of the file
-                for (int index = 0; index < 4; ++index)
+            case havJSONPathSegmentType::RecursiveMember:
                 {
-                    std::fread(&unsignedCurrentChar, sizeof(unsigned char), 1, fileStream.get());
+                    // Match at the current level first, then descend into all children with the same segment
+                    if (segment.mKey == "*" && segment.mIndex.has_value() == false)
+                    {
+                        if (ForEachChild(node, [this, segmentIndex, &function](Node childNode) { return Evaluate(childNode, segmentIndex + 1, function); }) == false)
+                        {
+                            return false;
+                        }
+                    }
+                    else if (EvaluateMember(node, segment, segmentIndex, function) == false)
+                    {
+                        return false;
+                    }
 
-                    bomArray[index] = unsignedCurrentChar;
+                    return ForEachChild(node, [this, segmentIndex, &function](Node childNode) { return Evaluate(childNode, segmentIndex, function); });
                 }
+            }
 
-                if (bomArray[0] == 0xff && bomArray[1] == 0xfe &&
-                    bomArray[2] == 0x00 && bomArray[3] == 0x00)
-                {
-                    bomType = havJSONBOMType::UTF32LE;
+            return true;
+        }
 
-                    bytesToSkip = 4;
-                }
-                else if (bomArray[0] == 0x00 && bomArray[1] == 0x00 &&
-                         bomArray[2] == 0xfe && bomArray[3] == 0xff)
-                {
-                    bomType = havJSONBOMType::UTF32BE;
+        std::vector<havJSONPathSegment> mSegments;
+    };
 
-                    bytesToSkip = 4;
-                }
-                else if (bomArray[0] == 0xff && bomArray[1] == 0xfe)
-                {
-                    bomType = havJSONBOMType::UTF16LE;
+    // Receives the records of NDJSON input. Returning false stops reading.
+    typedef std::function<bool(havJSONData& record)> havJSONRecordFunction;
 
-                    bytesToSkip = 2;
-                }
-                else if (bomArray[0] == 0xfe && bomArray[1] == 0xff)
-                {
-                    bomType = havJSONBOMType::UTF16BE;
+    // Parses large top-level arrays and NDJSON (one value per line) on several threads. The input is split at element or line
+    // boundaries, every worker parses its part with its own havJSONStream, and the results are stitched together in order.
+    class havJSONParallelParser
+    {
+    public:
+        // Uses one thread per hardware thread if numOfThreads is 0
+        explicit havJSONParallelParser(unsigned int numOfThreads = 0) : mNumOfThreads(numOfThreads)
+        {
+            if (mNumOfThreads == 0)
+            {
+                mNumOfThreads = std::max(1u, std::thread::hardware_concurrency());
+            }
+        }
 
-                    bytesToSkip = 2;
-                }
-                else if (bomArray[0] == 0xef && bomArray[1] == 0xbb && bomArray[2] == 0xbf)
-                {
-                    bomType = havJSONBOMType::UTF8;
+        // Parses a document whose root node is an array
+        bool ParseArray(std::string_view fileContents, havJSONData& valueNode)
+        {
+            std::vector<std::pair<std::size_t, std::size_t>> elementRanges;
 
-                    bytesToSkip = 3;
-                }
+            if (FindArrayElements(fileContents, elementRanges) == false)
+            {
+                return ResetNode(valueNode);
+            }
+
+            std::vector<std::shared_ptr<havJSONData>> elements(elementRanges.size());
+
+            // Split the elements into parts of roughly the same size
+            std::vector<std::size_t> partIndices = SplitRanges(elementRanges);
 
-                // If no BOM has been found, we still need to check for the file encoding
-                if (bomType == havJSONBOMType::None)
+            bool result = RunWorkers(partIndices.size() - 1, [&](std::size_t partIndex, havJSONStream& stream, const std::atomic<bool>& stopped)
+            {
+                for (std::size_t elementIndex = partIndices[partIndex]; elementIndex < partIndices[partIndex + 1] && stopped == false; ++elementIndex)
                 {
-                    if (bomArray[0] != 0x00 && bomArray[1] == 0x00 &&
-                        bomArray[2] == 0x00 && bomArray[3] == 0x00)
-                    {
-                        bomType = havJSONBOMType::UTF32LE;
-                    }
-                    else if (bomArray[0] == 0x00 && bomArray[1] == 0x00 &&
-                             bomArray[2] == 0x00 && bomArray[3] != 0x00)
-                    {
-                        bomType = havJSONBOMType::UTF32BE;
-                    }
-                    else if (bomArray[0] != 0x00 && bomArray[1] == 0x00 &&
-                             bomArray[2] != 0x00 && bomArray[3] == 0x00)
-                    {
-                        bomType = havJSONBOMType::UTF16LE;
-                    }
-                    else if (bomArray[0] == 0x00 && bomArray[1] != 0x00 &&
-                             bomArray[2] == 0x00 && bomArray[3] != 0x00)
+                    if (ParseValue(stream, fileContents.substr(0, elementRanges[elementIndex].second), elementRanges[elementIndex].first, elements[elementIndex]) == false)
                     {
-                        bomType = havJSONBOMType::UTF16BE;
+                        return false;
                     }
                 }
 
-                if (bomType != havJSONBOMType::None)
+                return true;
+            });
+
+            if (result == false)
+            {
+                return ResetNode(valueNode);
+            }
+
+            valueNode = havJSONData(std::move(elements), havJSONDataType::Array);
+
+            return true;
+        }
+
+        // Parses NDJSON into an array with one element per record. Empty lines are skipped.
+        bool ParseLines(std::string_view fileContents, havJSONData& valueNode)
+        {
+            std::vector<std::size_t> partOffsets = SplitLines(fileContents);
+
+            std::vector<std::vector<std::shared_ptr<havJSONData>>> partRecords(partOffsets.size() - 1);
+
+            bool result = RunWorkers(partRecords.size(), [&](std::size_t partIndex, havJSONStream& stream, const std::atomic<bool>& stopped)
+            {
+                return ForEachLine(fileContents, partOffsets[partIndex], partOffsets[partIndex + 1], stopped, [&](std::string_view lineContents, std::size_t lineIndex)
                 {
-                    std::string bomTypeString;
+                    std::shared_ptr<havJSONData> recordNode;
 
-                    switch (bomType)
+                    if (ParseValue(stream, lineContents, lineIndex, recordNode) == false)
                     {
-                    case havJSONBOMType::UTF16LE:
-                        bomTypeString = "UTF-16 Little Endian";
-                        break;
+                        return false;
+                    }
 
-                    case havJSONBOMType::UTF16BE:
-                        bomTypeString = "UTF-16 Big Endian";
-                        break;
+                    partRecords[partIndex].push_back(std::move(recordNode));
 
-                    case havJSONBOMType::UTF32LE:
-                        bomTypeString = "UTF-32 Little Endian";
-                        break;
+                    return true;
+                });
+            });
 
-                    case havJSONBOMType::UTF32BE:
-                        bomTypeString = "UTF-32 Big Endian";
-                        break;
+            if (result == false)
+            {
+                return ResetNode(valueNode);
+            }
 
-                    default:
-                        bomTypeString = "UTF-8";
-                    }
+            std::size_t numOfRecords = 0;
 
-                    std::cout << "File starts with " << bomTypeString << " BOM! Please note that the BOM will be skipped, and removed in case the file gets saved!\n";
-                }
+            for (const std::vector<std::shared_ptr<havJSONData>>& records : partRecords)
+            {
+                numOfRecords += records.size();
+            }
+
+            std::vector<std::shared_ptr<havJSONData>> elements;
+            elements.reserve(numOfRecords);
 
-                std::fseek(fileStream.get(), 0, SEEK_SET);
+            for (std::vector<std::shared_ptr<havJSONData>>& records : partRecords)
+            {
+                elements.insert(elements.end(), std::make_move_iterator(records.begin()), std::make_move_iterator(records.end()));
             }
 
-            if (bomType == havJSONBOMType::None ||
-                bomType == havJSONBOMType::UTF8)
+            valueNode = havJSONData(std::move(elements), havJSONDataType::Array);
+
+            return true;
+        }
+
+        // Parses NDJSON and hands every record to function. Note: function is called concurrently from the worker threads, and
+        // records of different parts aren't delivered in order.
+        bool ParseLines(std::string_view fileContents, const havJSONRecordFunction& function)
+        {
+            std::vector<std::size_t> partOffsets = SplitLines(fileContents);
+
+            return RunWorkers(partOffsets.size() - 1, [&](std::size_t partIndex, havJSONStream& stream, const std::atomic<bool>& stopped)
             {
-                char currentChar;
-                while (std::fread(&currentChar, sizeof(char), 1, fileStream.get()) > 0)
+                havJSONData recordNode;
+
+                return ForEachLine(fileContents, partOffsets[partIndex], partOffsets[partIndex + 1], stopped, [&](std::string_view lineContents, std::size_t lineIndex)
                 {
-                    if (bytesToSkip > 0)
+                    std::shared_ptr<havJSONData> parsedNode;
+
+                    if (ParseValue(stream, lineContents, lineIndex, parsedNode) == false)
                     {
-                        if (skippedBytes < bytesToSkip)
-                        {
-                            ++skippedBytes;
-                            continue;
-                        }
+                        return false;
                     }
-                    fileContents += currentChar;
-                }
+
+                    recordNode = std::move(*parsedNode);
+
+                    return function(recordNode);
+                });
+            });
+        }
+
+        bool ParseArrayFile(const std::string& fileName, havJSONData& valueNode)
+        {
+            havJSONFileMapping fileMapping;
+
+            if (OpenFile(fileName, fileMapping) == false)
+            {
+                return ResetNode(valueNode);
             }
-            else if (bomType == havJSONBOMType::UTF16LE ||
-                     bomType == havJSONBOMType::UTF16BE)
+
+            return ParseArray(fileMapping.view(), valueNode);
+        }
+
+        bool ParseLinesFile(const std::string& fileName, havJSONData& valueNode)
+        {
+            havJSONFileMapping fileMapping;
+
+            if (OpenFile(fileName, fileMapping) == false)
             {
-                char16_t currentCharU16;
-                while (std::fread(&currentCharU16, sizeof(char16_t), 1, fileStream.get()) > 0)
-                {
-                    if (bytesToSkip > 0)
-                    {
-                        if (skippedBytes < bytesToSkip)
-                        {
-                            skippedBytes += sizeof(char16_t);
-                            continue;
-                        }
-                    }
-                    fileContentsU16 += currentCharU16;
-                }
+                return ResetNode(valueNode);
             }
-            else if (bomType == havJSONBOMType::UTF32LE ||
-                     bomType == havJSONBOMType::UTF32BE)
+
+            return ParseLines(fileMapping.view(), valueNode);
+        }
+
+        bool ParseLinesFile(const std::string& fileName, const havJSONRecordFunction& function)
+        {
+            havJSONFileMapping fileMapping;
+
+            if (OpenFile(fileName, fileMapping) == false)
             {
-                char32_t currentCharU32;
-                while (std::fread(&currentCharU32, sizeof(char32_t), 1, fileStream.get()) > 0)
-                {
-                    if (bytesToSkip > 0)
-                    {
-                        if (skippedBytes < bytesToSkip)
-                        {
-                            skippedBytes += sizeof(char32_t);
-                            continue;
-                        }
-                    }
-                    fileContentsU32 += currentCharU32;
-                }
+                return false;
+            }
+
+            return ParseLines(fileMapping.view(), function);
+        }
+
+        void SetNumOfThreads(unsigned int numOfThreads) { mNumOfThreads = std::max(1u, numOfThreads); }
+
+        unsigned int GetNumOfThreads() const { return mNumOfThreads; }
+
+        // Messages of the file functions go to errorStream. nullptr turns them off.
+        void SetErrorStream(std::ostream* errorStream) { mStream.SetErrorStream(errorStream); }
+
+    private:
+        // Inputs below this size per thread aren't worth splitting
+        static constexpr std::size_t MinPartSize = 64 * 1024;
+
+        static bool ResetNode(havJSONData& valueNode)
+        {
+            havJSONData newValueNode;
+
+            valueNode = std::move(newValueNode);
+
+            return false;
+        }
+
+        bool OpenFile(const std::string& fileName, havJSONFileMapping& fileMapping)
+        {
+#ifdef _WIN32
+            bool fileOpened = fileMapping.Open(mStream.ConvertStringToWString(fileName));
+#else
+            bool fileOpened = fileMapping.Open(fileName);
+#endif
+
+            if (fileOpened == false)
+            {
+                mStream.LogError("Unable to parse JSON file: ", fileName, "\n");
             }
 
-            // Convert the file contents to UTF-8, if necessary
-            if (bomType == havJSONBOMType::UTF16LE)
-            {
-                fileContents = std::wstring_convert<havJSONCodeCvt<char16_t, char, std::mbstate_t>, char16_t>{}.to_bytes(fileContentsU16);
-            }
-            else if (bomType == havJSONBOMType::UTF16BE)
+            return fileOpened;
+        }
+
+        std::size_t GetNumOfParts(std::size_t size) const
+        {
+            return std::max<std::size_t>(1, std::min<std::size_t>(mNumOfThreads, size / MinPartSize));
+        }
+
+        // Parses the single value starting at index, which must be followed by whitespace only
+        static bool ParseValue(havJSONStream& stream, std::string_view jsonStringStream, std::size_t index, std::shared_ptr<havJSONData>& valueNode)
+        {
+            stream.SkipWhitespacesDirect(index, jsonStringStream);
+
+            if (stream.ParseElementDirect(index, jsonStringStream, valueNode) == false)
             {
-                std::u16string u16ConvBE;
-                for (char16_t currentChar : fileContentsU16)
-                {
-                    u16ConvBE += (((currentChar & 0x00ff) << 8) | ((currentChar & 0xff00) >> 8));
-                }
-                fileContents = std::wstring_convert<havJSONCodeCvt<char16_t, char, std::mbstate_t>, char16_t>{}.to_bytes(u16ConvBE);
+                return false;
             }
-            else if (bomType == havJSONBOMType::UTF32LE)
+
+            stream.SkipWhitespacesDirect(index, jsonStringStream);
+
+            return index == jsonStringStream.size();
+        }
+
+        // Finds the start and end of every element of the root array
+        bool FindArrayElements(std::string_view jsonStringStream, std::vector<std::pair<std::size_t, std::size_t>>& elementRanges)
+        {
+            std::size_t index = havJSONScanner::SkipWhitespaces(jsonStringStream.data(), 0, jsonStringStream.size());
+
+            if (index >= jsonStringStream.size() || jsonStringStream[index] != '[')
             {
-                fileContents = std::wstring_convert<havJSONCodeCvt<char32_t, char, std::mbstate_t>, char32_t>{}.to_bytes(fileContentsU32);
+                return false;
             }
-            else if (bomType == havJSONBOMType::UTF32BE)
+
+            index = havJSONScanner::SkipWhitespaces(jsonStringStream.data(), index + 1, jsonStringStream.size());
+
+            if (index < jsonStringStream.size() && jsonStringStream[index] == ']')
             {
-                std::u32string u32ConvBE;
-                for (char32_t currentChar : fileContentsU32)
-                {
-                    u32ConvBE += (((currentChar & 0x000000ff) << 24) |
-                                  ((currentChar & 0x0000ff00) << 8) |
-                                  ((currentChar & 0x00ff0000) >> 8) |
-                                  ((currentChar & 0xff000000) >> 24));
-                }
-                fileContents = std::wstring_convert<havJSONCodeCvt<char32_t, char, std::mbstate_t>, char32_t>{}.to_bytes(u32ConvBE);
+                return havJSONScanner::SkipWhitespaces(jsonStringStream.data(), index + 1, jsonStringStream.size()) == jsonStringStream.size();
             }
 
-            if (jsonType == havJSONType::BSON)
+            while (index < jsonStringStream.size())
             {
-                // 2.5 Convert BSON to JSON
-                fileContents = ConvertBSONToJSON(fileContents);
+                // Note: Only strings and brackets are looked at, the element itself is checked when it's parsed
+                std::size_t endIndex = havJSONScanner::SkipValue(jsonStringStream.data(), index, jsonStringStream.size());
 
-                if (fileContents.empty() == true)
+                if (endIndex == index)
                 {
-                    std::cout << "Unable to parse BSON file: " << fileName << "\n";
+                    return false;
+                }
 
-                    havJSONData newValueNode;
+                elementRanges.emplace_back(index, endIndex);
 
-                    valueNode = std::move(newValueNode);
+                index = havJSONScanner::SkipWhitespaces(jsonStringStream.data(), endIndex, jsonStringStream.size());
 
+                if (index >= jsonStringStream.size())
+                {
                     return false;
                 }
-            }
 
-            // 3. Tokenization phase
-            if (Tokenization(fileContents) == true)
-            {
-                // 4. Parse JSON contents
-                if (ParseJSONContents(valueNode) == true)
+                if (jsonStringStream[index] == ']')
                 {
-                    return true;
+                    // Only whitespace may follow the root node
+                    return havJSONScanner::SkipWhitespaces(jsonStringStream.data(), index + 1, jsonStringStream.size()) == jsonStringStream.size();
                 }
-            }
 
-            // 5. Return JSON contents as havJSONData object
-            havJSONData newValueNode;
+                if (jsonStringStream[index] != ',')
+                {
+                    return false;
+                }
 
-            valueNode = std::move(newValueNode);
+                index = havJSONScanner::SkipWhitespaces(jsonStringStream.data(), index + 1, jsonStringStream.size());
+            }
 
             return false;
         }
 
-        bool ParseContent(const std::string& fileContents, havJSONData& valueNode)
+        // Returns the first element of every part, followed by the number of elements
+        std::vector<std::size_t> SplitRanges(const std::vector<std::pair<std::size_t, std::size_t>>& elementRanges) const
         {
-            // 1. Tokenization phase
-            if (Tokenization(fileContents) == true)
+            std::vector<std::size_t> partIndices(1, 0);
+
+            if (elementRanges.empty() == false)
             {
-                // 2. Parse JSON contents
-                if (ParseJSONContents(valueNode) == true)
+                std::size_t totalSize = elementRanges.back().second - elementRanges.front().first;
+                std::size_t numOfParts = GetNumOfParts(totalSize);
+
+                for (std::size_t elementIndex = 0; elementIndex < elementRanges.size() && partIndices.size() < numOfParts; ++elementIndex)
                 {
-                    return true;
+                    if (elementRanges[elementIndex].second - elementRanges.front().first >= totalSize * partIndices.size() / numOfParts)
+                    {
+                        partIndices.push_back(elementIndex + 1);
+                    }
                 }
             }
 
-            // 3. Return JSON contents as havJSONData object
-            havJSONData newValueNode;
-
-            valueNode = std::move(newValueNode);
+            if (partIndices.back() != elementRanges.size())
+            {
+                partIndices.push_back(elementRanges.size());
+            }
 
-            return false;
+            return partIndices;
         }
 
-        void TokenizeArray(std::vector<std::shared_ptr<havJSONData>>& rootArray, std::deque<havJSONTokenValue>& tokens)
+        // Returns the start offset of every part, followed by the size of the input. Parts always start at the beginning of a line.
+        std::vector<std::size_t> SplitLines(std::string_view jsonStringStream) const
         {
-            for (std::vector<std::shared_ptr<havJSONData>>::size_type index = 0; index < rootArray.size(); ++index)
-            {
-                if (index > 0)
-                {
-                    tokens.push_back(havJSONTokenValue { havJSONToken::Comma, std::nullopt });
-                }
-
-                const havJSONData* currentValue = rootArray[index].get();
-
-                switch (currentValue->getType())
-                {
-                    case havJSONDataType::Null:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::Null, std::get<std::string>(currentValue->getValue()) });
-                        break;
-
-                    case havJSONDataType::Boolean:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::Boolean, std::get<bool>(currentValue->getValue()) ? "true" : "false" });
-                        break;
-
-                    case havJSONDataType::Int:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::Int, std::to_string(std::get<int>(currentValue->getValue())) });
-                        break;
+            std::size_t numOfParts = GetNumOfParts(jsonStringStream.size());
 
-                    case havJSONDataType::UInt:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::UInt, std::to_string(std::get<unsigned int>(currentValue->getValue())) });
-                        break;
-
-                    case havJSONDataType::Long:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::Long, std::to_string(std::get<long>(currentValue->getValue())) });
-                        break;
-
-                    case havJSONDataType::ULong:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::ULong, std::to_string(std::get<unsigned long>(currentValue->getValue())) });
-                        break;
+            std::vector<std::size_t> partOffsets(1, 0);
 
-                    case havJSONDataType::Int64:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::Int64, std::to_string(std::get<std::int64_t>(currentValue->getValue())) });
-                        break;
+            for (std::size_t partIndex = 1; partIndex < numOfParts; ++partIndex)
+            {
+                std::size_t offset = std::max(partOffsets.back(), jsonStringStream.size() * partIndex / numOfParts);
 
-                    case havJSONDataType::UInt64:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::UInt64, std::to_string(std::get<std::uint64_t>(currentValue->getValue())) });
-                        break;
+                offset = jsonStringStream.find('\n', offset);
 
-                    case havJSONDataType::Double:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::Double, std::to_string(std::get<double>(currentValue->getValue())) });
-                        break;
+                if (offset == std::string_view::npos)
+                {
+                    break;
+                }
 
-                    case havJSONDataType::String:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::Value, std::get<std::string>(currentValue->getValue()) });
-                        break;
+                if (offset + 1 > partOffsets.back())
+                {
+                    partOffsets.push_back(offset + 1);
+                }
+            }
 
-                    case havJSONDataType::Array:
-                        {
-                            tokens.push_back(havJSONTokenValue { havJSONToken::LeftSquareBracket, std::nullopt });
+            partOffsets.push_back(jsonStringStream.size());
 
-                            std::vector<std::shared_ptr<havJSONData>> newArray = std::get<std::vector<std::shared_ptr<havJSONData>>>(currentValue->getValue());
+            return partOffsets;
+        }
 
-                            TokenizeArray(newArray, tokens);
-                        }
-                        break;
+        // Calls function with every non-empty line between startIndex and endIndex and the offset its content starts at
+        template<typename Function>
+        static bool ForEachLine(std::string_view jsonStringStream, std::size_t startIndex, std::size_t endIndex, const std::atomic<bool>& stopped, Function&& function)
+        {
+            while (startIndex < endIndex && stopped == false)
+            {
+                const void* lineEnd = std::memchr(jsonStringStream.data() + startIndex, '\n', endIndex - startIndex);
 
-                    case havJSONDataType::Object:
-                        {
-                            tokens.push_back(havJSONTokenValue { havJSONToken::LeftCurlyBracket, std::nullopt });
+                std::size_t lineEndIndex = (lineEnd != nullptr) ? static_cast<std::size_t>(static_cast<const char*>(lineEnd) - jsonStringStream.data()) : endIndex;
 
-                            std::map<std::string, std::shared_ptr<havJSONData>> rootObject = std::get<std::map<std::string, std::shared_ptr<havJSONData>>>(currentValue->getValue());
+                std::size_t contentIndex = havJSONScanner::SkipWhitespaces(jsonStringStream.data(), startIndex, lineEndIndex);
 
-                            TokenizeObject(rootObject, tokens);
-                        }
-                        break;
+                if (contentIndex < lineEndIndex && function(jsonStringStream.substr(0, lineEndIndex), contentIndex) == false)
+                {
+                    return false;
                 }
+
+                startIndex = lineEndIndex + 1;
             }
 
-            tokens.push_back(havJSONTokenValue { havJSONToken::RightSquareBracket, std::nullopt });
+            return true;
         }
 
-        void TokenizeObject(std::map<std::string, std::shared_ptr<havJSONData>>& rootObject, std::deque<havJSONTokenValue>& tokens)
+        // Runs worker(partIndex, stream, stopped) for every part, on its own thread if there is more than one part. Exceptions
+        // are rethrown on the calling thread once all workers have finished.
+        template<typename Function>
+        bool RunWorkers(std::size_t numOfParts, Function&& worker)
         {
-            for (std::map<std::string, std::shared_ptr<havJSONData>>::iterator itr = rootObject.begin(); itr != rootObject.end(); ++itr)
+            std::atomic<bool> stopped(false);
+
+            if (numOfParts <= 1)
             {
-                if (itr != rootObject.begin())
-                {
-                    tokens.push_back(havJSONTokenValue { havJSONToken::Comma, std::nullopt });
-                }
+                // Note: Small inputs are parsed on the calling thread
+                bool result = (numOfParts == 0) || worker(0, mStream, stopped);
 
-                const havJSONData* item = rootObject[(*itr).first].get();
+                mStream.ClearScratch();
 
-                tokens.push_back(havJSONTokenValue { havJSONToken::String, (*itr).first });
-                tokens.push_back(havJSONTokenValue { havJSONToken::Colon, std::nullopt });
+                return result;
+            }
 
-                switch (item->getType())
-                {
-                    case havJSONDataType::Null:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::Null, std::get<std::string>(item->getValue()) });
-                        break;
+            std::vector<std::exception_ptr> exceptions(numOfParts);
+            std::vector<char> results(numOfParts, 0);
 
-                    case havJSONDataType::Boolean:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::Boolean, std::get<bool>(item->getValue()) ? "true" : "false" });
-                        break;
+            std::vector<std::thread> threads;
+            threads.reserve(numOfParts);
 
-                    case havJSONDataType::Int:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::Int, std::to_string(std::get<int>(item->getValue())) });
-                        break;
+            for (std::size_t partIndex = 0; partIndex < numOfParts; ++partIndex)
+            {
+                threads.emplace_back([&, partIndex]()
+                {
+                    try
+                    {
+                        havJSONStream stream;
 
-                    case havJSONDataType::UInt:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::UInt, std::to_string(std::get<unsigned int>(item->getValue())) });
-                        break;
+                        results[partIndex] = (worker(partIndex, stream, stopped) == true) ? 1 : 0;
+                    }
+                    catch (...)
+                    {
+                        exceptions[partIndex] = std::current_exception();
+                    }
 
-                    case havJSONDataType::Long:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::Long, std::to_string(std::get<long>(item->getValue())) });
-                        break;
+                    if (results[partIndex] == 0)
+                    {
+                        stopped = true;
+                    }
+                });
+            }
 
-                    case havJSONDataType::ULong:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::ULong, std::to_string(std::get<unsigned long>(item->getValue())) });
-                        break;
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
 
-                    case havJSONDataType::Int64:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::Int64, std::to_string(std::get<std::int64_t>(item->getValue())) });
-                        break;
+            for (const std::exception_ptr& exception : exceptions)
+            {
+                if (exception != nullptr)
+                {
+                    std::rethrow_exception(exception);
+                }
+            }
 
-                    case havJSONDataType::UInt64:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::UInt64, std::to_string(std::get<std::uint64_t>(item->getValue())) });
-                        break;
+            return std::find(results.begin(), results.end(), 0) == results.end();
+        }
 
-                    case havJSONDataType::Double:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::Double, std::to_string(std::get<double>(item->getValue())) });
-                        break;
+        unsigned int mNumOfThreads;
 
-                    case havJSONDataType::String:
-                        tokens.push_back(havJSONTokenValue { havJSONToken::Value, std::get<std::string>(item->getValue()) });
-                        break;
+        // Used for inputs that aren't split
+        havJSONStream mStream;
+    };
 
-                    case havJSONDataType::Array:
-                        {
-                            tokens.push_back(havJSONTokenValue { havJSONToken::LeftSquareBracket, std::nullopt });
+    // Reads NDJSON (JSON Lines) one record at a time, from a file in chunks or from a memory buffer. The read buffer and the
+    // parser state are reused for every record. Empty lines are skipped.
+    class havJSONLineReader
+    {
+    public:
+        havJSONLineReader() = default;
 
-                            std::vector<std::shared_ptr<havJSONData>> rootArray = std::get<std::vector<std::shared_ptr<havJSONData>>>(item->getValue());
+        havJSONLineReader(const havJSONLineReader&) = delete;
+        havJSONLineReader& operator=(const havJSONLineReader&) = delete;
 
-                            TokenizeArray(rootArray, tokens);
-                        }
-                        break;
+        // Messages of openFile go to errorStream. nullptr turns them off.
+        void setErrorStream(std::ostream* errorStream) { mStream.SetErrorStream(errorStream); }
 
-                    case havJSONDataType::Object:
-                        {
-                            tokens.push_back(havJSONTokenValue { havJSONToken::LeftCurlyBracket, std::nullopt });
+        bool openFile(const std::string& fileName)
+        {
+            close();
+
+#ifdef _WIN32
+            mFileStream.reset(_wfopen(&mStream.ConvertStringToWString(fileName)[0], L"rb"));
+#else
+            mFileStream.reset(std::fopen(fileName.c_str(), "rb"));
+#endif
 
-                            std::map<std::string, std::shared_ptr<havJSONData>> newObject = std::get<std::map<std::string, std::shared_ptr<havJSONData>>>(item->getValue());
+            if (mFileStream == nullptr)
+            {
+                mStream.LogError("Unable to parse JSON file: ", fileName, "\n");
 
-                            TokenizeObject(newObject, tokens);
-                        }
-                        break;
-                }
+                return false;
             }
 
-            tokens.push_back(havJSONTokenValue { havJSONToken::RightCurlyBracket, std::nullopt });
+            return true;
         }
 
-        bool Tokenization(havJSONData& rootNode, std::deque<havJSONTokenValue>& tokens)
+        // Reads from content, which isn't copied and has to stay valid while reading
+        void open(std::string_view content)
         {
-            havJSONToken currentTypeToken = havJSONToken::None;
+            close();
 
-            if (rootNode.isArray() == true)
-            {
-                currentTypeToken = havJSONToken::LeftSquareBracket;
-            }
+            mContent = content;
+        }
 
-            if (rootNode.isObject() == true)
-            {
-                currentTypeToken = havJSONToken::LeftCurlyBracket;
-            }
+        void close()
+        {
+            mFileStream.reset();
+            mContent = std::string_view();
+            mBufferUsed = 0;
+            mPosition = 0;
+            mLineNumber = 0;
+            mFailed = false;
+        }
 
-            if (currentTypeToken == havJSONToken::None)
+        // Parses the next record into record. Returns false at the end of the input or if the record is invalid (see failed()).
+        bool next(havJSONData& record)
+        {
+            std::string_view lineContents;
+
+            while (mFailed == false && ReadLine(lineContents) == true)
             {
-                throw std::runtime_error("Invalid token: Expected array or object as root node!");
-            }
+                std::size_t index = havJSONScanner::SkipWhitespaces(lineContents.data(), 0, lineContents.size());
 
-            tokens.push_back(havJSONTokenValue { currentTypeToken, std::nullopt });
+                if (index >= lineContents.size())
+                {
+                    continue;
+                }
 
-            if (rootNode.isArray() == true)
-            {
-                std::vector<std::shared_ptr<havJSONData>> rootArray = std::get<std::vector<std::shared_ptr<havJSONData>>>(rootNode.getValue());
+                if (ParseRecord(lineContents, index, record) == true)
+                {
+                    return true;
+                }
 
-                TokenizeArray(rootArray, tokens);
+                mFailed = true;
             }
 
-            if (rootNode.isObject() == true)
-            {
-                std::map<std::string, std::shared_ptr<havJSONData>> rootObject = std::get<std::map<std::string, std::shared_ptr<havJSONData>>>(rootNode.getValue());
+            havJSONData newValueNode;
 
-                TokenizeObject(rootObject, tokens);
-            }
+            record = std::move(newValueNode);
 
-            return tokens.size() > 0;
+            return false;
         }
 
-        bool ConvertJSONToString(havJSONData& valueNode, std::string& jsonContentsAsString, bool formatted = false)
+        // Calls function for every record until it returns false. Returns false if a record was invalid.
+        bool forEach(const havJSONRecordFunction& function)
         {
-            std::deque<havJSONTokenValue> tokens;
+            havJSONData record;
 
-            // 1. Tokenization phase
-            if (Tokenization(valueNode, tokens) == true)
+            while (next(record) == true)
             {
-                // 2. Write contents to string
-                if (tokens[0].mToken != havJSONToken::LeftCurlyBracket &&
-                    tokens[0].mToken != havJSONToken::LeftSquareBracket)
+                if (function(record) == false)
                 {
-                    return false;
+                    break;
                 }
+            }
 
-                int tokenTypesSize = 0;
-
-                char currentChar;
-
-                std::deque<havJSONDataType> tokenTypes;
+            return mFailed == false;
+        }
 
-                auto itr = tokens.begin();
+        bool failed() const { return mFailed; }
 
-                havJSONToken previousToken = havJSONToken::None;
-                havJSONDataType currentType = havJSONDataType::Null;
+        // Line of the record that was read last (1-based)
+        std::size_t lineNumber() const { return mLineNumber; }
 
-                if (tokens[0].mToken == havJSONToken::LeftCurlyBracket)
-                {
-                    currentType = havJSONDataType::Object;
-                }
+    private:
+        static constexpr std::size_t ReadSize = 64 * 1024;
 
-                if (tokens[0].mToken == havJSONToken::LeftSquareBracket)
+        // Returns the next line without the line break
+        bool ReadLine(std::string_view& lineContents)
+        {
+            if (mFileStream == nullptr)
+            {
+                if (mPosition >= mContent.size())
                 {
-                    currentType = havJSONDataType::Array;
+                    return false;
                 }
 
-                while (itr != tokens.end())
-                {
-                    if ((*itr).mToken == havJSONToken::RightCurlyBracket ||
-                        (*itr).mToken == havJSONToken::RightSquareBracket)
-                    {
-                        currentType = tokenTypes.back();
-                        tokenTypes.pop_back();
-                        tokenTypesSize = tokenTypes.size();
-                    }
-
-                    if (formatted == true)
-                    {
-                        if (currentType == havJSONDataType::Array)
-                        {
-                            if (previousToken == havJSONToken::LeftSquareBracket)
-                            {
-                                currentChar = '\n';
-
-                                jsonContentsAsString += currentChar;
-
-                                currentChar = ' ';
-
-                                for (int index = 0; index < tokenTypesSize * 4; ++index)
-                                {
-                                    jsonContentsAsString += currentChar;
-                                }
-                            }
+                std::size_t lineEndIndex = std::min(mContent.find('\n', mPosition), mContent.size());
 
-                            if (previousToken == havJSONToken::RightSquareBracket &&
-                                (*itr).mToken == havJSONToken::RightCurlyBracket)
-                            {
-                                currentChar = '\n';
+                lineContents = mContent.substr(mPosition, lineEndIndex - mPosition);
 
-                                jsonContentsAsString += currentChar;
+                mPosition = lineEndIndex + 1;
 
-                                currentChar = ' ';
+                ++mLineNumber;
 
-                                for (int index = 0; index < tokenTypesSize * 4; ++index)
-                                {
-                                    jsonContentsAsString += currentChar;
-                                }
-                            }
+                return true;
+            }
 
-                            if ((previousToken == havJSONToken::Colon && (*itr).mToken == havJSONToken::LeftCurlyBracket) ||
-                                (previousToken == havJSONToken::Comma && (*itr).mToken == havJSONToken::LeftCurlyBracket))
-                            {
-                                currentChar = ' ';
+            std::size_t searchIndex = mPosition;
 
-                                jsonContentsAsString += currentChar;
-                            }
+            while (true)
+            {
+                const void* lineEnd = (searchIndex < mBufferUsed) ? std::memchr(mBuffer.data() + searchIndex, '\n', mBufferUsed - searchIndex) : nullptr;
 
-                            if (previousToken == havJSONToken::LeftCurlyBracket)
-                            {
-                                currentChar = '\n';
+                if (lineEnd != nullptr)
+                {
+                    std::size_t lineEndIndex = static_cast<const char*>(lineEnd) - mBuffer.data();
 
-                                jsonContentsAsString += currentChar;
+                    lineContents = std::string_view(mBuffer.data() + mPosition, lineEndIndex - mPosition);
 
-                                currentChar = ' ';
+                    mPosition = lineEndIndex + 1;
 
-                                for (int index = 0; index < tokenTypesSize * 4; ++index)
-                                {
-                                    jsonContentsAsString += currentChar;
-                                }
-                            }
+                    ++mLineNumber;
 
-                            if (previousToken == havJSONToken::RightCurlyBracket &&
-                                (*itr).mToken == havJSONToken::RightSquareBracket)
-                            {
-                                currentChar = '\n';
+                    return true;
+                }
 
-                                jsonContentsAsString += currentChar;
+                // Move the incomplete line to the front of the buffer and read the next chunk behind it
+                std::size_t remainingSize = mBufferUsed - mPosition;
 
-                                currentChar = ' ';
+                if (mPosition > 0)
+                {
+                    std::memmove(mBuffer.data(), mBuffer.data() + mPosition, remainingSize);
 
-                                for (int index = 0; index < tokenTypesSize * 4; ++index)
-                                {
-                                    jsonContentsAsString += currentChar;
-                                }
-                            }
+                    mPosition = 0;
+                    mBufferUsed = remainingSize;
+                }
 
-                            if ((previousToken == havJSONToken::Colon && (*itr).mToken == havJSONToken::LeftSquareBracket) ||
-                                (previousToken == havJSONToken::Comma && (*itr).mToken == havJSONToken::LeftSquareBracket))
-                            {
-                                currentChar = ' ';
+                searchIndex = mBufferUsed;
 
-                                jsonContentsAsString += currentChar;
-                            }
+                if (mBuffer.size() < mBufferUsed + ReadSize)
+                {
+                    mBuffer.resize(mBufferUsed + ReadSize);
+                }
 
-                            if ((*itr).mToken == havJSONToken::String &&
-                                previousToken == havJSONToken::Comma)
-                            {
-                                currentChar = '\n';
+                std::size_t bytesRead = std::fread(mBuffer.data() + mBufferUsed, sizeof(char), ReadSize, mFileStream.get());
 
-                                jsonContentsAsString += currentChar;
+                mBufferUsed += bytesRead;
 
-                                currentChar = ' ';
+                if (bytesRead == 0)
+                {
+                    // The last line doesn't have to end with a line break
+                    if (remainingSize == 0)
+                    {
+                        return false;
+                    }
 
-                                for (int index = 0; index < tokenTypesSize * 4; ++index)
-                                {
-                                    jsonContentsAsString += currentChar;
-                                }
-                            }
+                    lineContents = std::string_view(mBuffer.data(), remainingSize);
 
-                            if (previousToken == havJSONToken::Colon && ((*itr).mToken == havJSONToken::Value ||
-                                (*itr).mToken == havJSONToken::Null ||
-                                (*itr).mToken == havJSONToken::Boolean ||
-                                (*itr).mToken == havJSONToken::Int ||
-                                (*itr).mToken == havJSONToken::UInt ||
-                                (*itr).mToken == havJSONToken::Long ||
-                                (*itr).mToken == havJSONToken::ULong ||
-                                (*itr).mToken == havJSONToken::Int64 ||
-                                (*itr).mToken == havJSONToken::UInt64 ||
-                                (*itr).mToken == havJSONToken::Double))
-                            {
-                                currentChar = ' ';
+                    mPosition = mBufferUsed;
 
-                                jsonContentsAsString += currentChar;
-                            }
+                    ++mLineNumber;
 
-                            if (previousToken == havJSONToken::Comma && ((*itr).mToken == havJSONToken::Value ||
-                                (*itr).mToken == havJSONToken::Null ||
-                                (*itr).mToken == havJSONToken::Boolean ||
-                                (*itr).mToken == havJSONToken::Int ||
-                                (*itr).mToken == havJSONToken::UInt ||
-                                (*itr).mToken == havJSONToken::Long ||
-                                (*itr).mToken == havJSONToken::ULong ||
-                                (*itr).mToken == havJSONToken::Int64 ||
-                                (*itr).mToken == havJSONToken::UInt64 ||
-                                (*itr).mToken == havJSONToken::Double))
-                            {
-                                currentChar = '\n';
+                    return true;
+                }
+            }
+        }
 
-                                jsonContentsAsString += currentChar;
+        bool ParseRecord(std::string_view lineContents, std::size_t index, havJSONData& record)
+        {
+            bool result = false;
 
-                                currentChar = ' ';
+            // Containers are parsed straight into the record, other values need a node first
+            if (lineContents[index] == '{')
+            {
+                record = havJSONData(havJSONDataType::Object);
 
-                                for (int index = 0; index < tokenTypesSize * 4; ++index)
-                                {
-                                    jsonContentsAsString += currentChar;
-                                }
-                            }
+                result = mStream.ParseObjectDirect(index, lineContents, record);
+            }
+            else if (lineContents[index] == '[')
+            {
+                record = havJSONData(havJSONDataType::Array);
 
-                            if (((*itr).mToken == havJSONToken::Value ||
-                                 (*itr).mToken == havJSONToken::Null ||
-                                 (*itr).mToken == havJSONToken::Boolean ||
-                                 (*itr).mToken == havJSONToken::Int ||
-                                 (*itr).mToken == havJSONToken::UInt ||
-                                 (*itr).mToken == havJSONToken::Long ||
-                                 (*itr).mToken == havJSONToken::ULong ||
-                                 (*itr).mToken == havJSONToken::Int64 ||
-                                 (*itr).mToken == havJSONToken::UInt64 ||
-                                 (*itr).mToken == havJSONToken::Double) &&
-                                (previousToken == havJSONToken::RightSquareBracket ||
-                                 previousToken == havJSONToken::RightCurlyBracket))
-                            {
-                                currentChar = ' ';
+                result = mStream.ParseArrayDirect(index, lineContents, record);
+            }
+            else
+            {
+                std::shared_ptr<havJSONData> valueNode;
 
-                                for (int index = 0; index < tokenTypesSize * 4; ++index)
-                                {
-                                    jsonContentsAsString += currentChar;
-                                }
-                            }
+                result = mStream.ParseElementDirect(index, lineContents, valueNode);
 
-                            if ((previousToken == havJSONToken::Value ||
-                                 previousToken == havJSONToken::Null ||
-                                 previousToken == havJSONToken::Boolean ||
-                                 previousToken == havJSONToken::Int ||
-                                 previousToken == havJSONToken::UInt ||
-                                 previousToken == havJSONToken::Long ||
-                                 previousToken == havJSONToken::ULong ||
-                                 previousToken == havJSONToken::Int64 ||
-                                 previousToken == havJSONToken::UInt64 ||
-                                 previousToken == havJSONToken::Double) &&
-                                ((*itr).mToken == havJSONToken::RightSquareBracket ||
-                                 (*itr).mToken == havJSONToken::RightCurlyBracket))
-                            {
-                                currentChar = '\n';
+                if (result == true)
+                {
+                    record = std::move(*valueNode);
+                }
+            }
 
-                                jsonContentsAsString += currentChar;
+            mStream.ClearScratch();
 
-                                currentChar = ' ';
+            // Only whitespace may follow the record
+            return result == true && havJSONScanner::SkipWhitespaces(lineContents.data(), index, lineContents.size()) == lineContents.size();
+        }
 
-                                for (int index = 0; index < tokenTypesSize * 4; ++index)
-                                {
-                                    jsonContentsAsString += currentChar;
-                                }
-                            }
-                        }
+        havJSONStream mStream;
 
-                        if (currentType == havJSONDataType::Object)
-                        {
-                            if (previousToken == havJSONToken::LeftSquareBracket &&
-                                (*itr).mToken == havJSONToken::LeftCurlyBracket)
-                            {
-                                currentChar = '\n';
+        std::unique_ptr<std::FILE, decltype(&std::fclose)> mFileStream { nullptr, std::fclose };
 
-                                jsonContentsAsString += currentChar;
-                            }
+        std::string_view mContent;
 
-                            if (previousToken == havJSONToken::RightSquareBracket &&
-                                (*itr).mToken == havJSONToken::RightSquareBracket)
-                            {
-                                currentChar = '\n';
+        std::vector<char> mBuffer;
+        std::size_t mBufferUsed = 0;
 
-                                jsonContentsAsString += currentChar;
+        // Start of the next line in the buffer (or in mContent)
+        std::size_t mPosition = 0;
 
-                                currentChar = ' ';
+        std::size_t mLineNumber = 0;
 
-                                for (int index = 0; index < tokenTypesSize * 4; ++index)
-                                {
-                                    jsonContentsAsString += currentChar;
-                                }
-                            }
+        bool mFailed = false;
+    };
 
-                            if (previousToken == havJSONToken::RightCurlyBracket &&
-                                (*itr).mToken == havJSONToken::RightSquareBracket)
-                            {
-                                currentChar = '\n';
+    // Writes NDJSON (JSON Lines) records, one compact value per line, through a buffered output
+    class havJSONLineWriter
+    {
+    public:
+        havJSONLineWriter() = default;
 
-                                jsonContentsAsString += currentChar;
+        // Writes to a caller-owned output buffer (e.g. a string or a callback sink)
+        explicit havJSONLineWriter(havJSONOutputBuffer& outputBuffer) : mOutput(&outputBuffer) {}
 
-                                currentChar = ' ';
+        ~havJSONLineWriter() { close(); }
 
-                                for (int index = 0; index < tokenTypesSize * 4; ++index)
-                                {
-                                    jsonContentsAsString += currentChar;
-                                }
-                            }
+        havJSONLineWriter(const havJSONLineWriter&) = delete;
+        havJSONLineWriter& operator=(const havJSONLineWriter&) = delete;
 
-                            if (previousToken == havJSONToken::Comma ||
-                                previousToken == havJSONToken::LeftCurlyBracket)
-                            {
-                                currentChar = '\n';
+        // Messages of openFile go to errorStream. nullptr turns them off.
+        void setErrorStream(std::ostream* errorStream) { mStream.SetErrorStream(errorStream); }
 
-                                jsonContentsAsString += currentChar;
-                            }
+        // Opens the file for writing. Records are appended to an existing file unless append is false.
+        bool openFile(const std::string& fileName, bool append = true)
+        {
+            close();
 
-                            if (previousToken == havJSONToken::RightSquareBracket &&
-                                (*itr).mToken == havJSONToken::RightCurlyBracket)
-                            {
-                                currentChar = '\n';
+#ifdef _WIN32
+            mFileStream.reset(_wfopen(&mStream.ConvertStringToWString(fileName)[0], (append == true) ? L"ab" : L"wb"));
+#else
+            mFileStream.reset(std::fopen(fileName.c_str(), (append == true) ? "ab" : "wb"));
+#endif
 
-                                jsonContentsAsString += currentChar;
-                            }
+            if (mFileStream == nullptr)
+            {
+                mStream.LogError("Unable to write JSON file: ", fileName, "\n");
 
-                            if (previousToken == havJSONToken::LeftSquareBracket && ((*itr).mToken == havJSONToken::Value ||
-                                (*itr).mToken == havJSONToken::Null ||
-                                (*itr).mToken == havJSONToken::Boolean ||
-                                (*itr).mToken == havJSONToken::Int ||
-                                (*itr).mToken == havJSONToken::UInt ||
-                                (*itr).mToken == havJSONToken::Long ||
-                                (*itr).mToken == havJSONToken::ULong ||
-                                (*itr).mToken == havJSONToken::Int64 ||
-                                (*itr).mToken == havJSONToken::UInt64 ||
-                                (*itr).mToken == havJSONToken::Double ||
-                                (*itr).mToken == havJSONToken::String))
-                            {
-                                currentChar = '\n';
+                return false;
+            }
 
-                                jsonContentsAsString += currentChar;
+            mFileBuffer = std::make_unique<havJSONOutputBuffer>(mFileStream.get());
 
-                                currentChar = ' ';
+            mOutput = mFileBuffer.get();
 
-                                for (int index = 0; index < tokenTypesSize * 4; ++index)
-                                {
-                                    jsonContentsAsString += currentChar;
-                                }
-                            }
+            return true;
+        }
 
-                            if (previousToken == havJSONToken::Comma && ((*itr).mToken == havJSONToken::Value ||
-                                (*itr).mToken == havJSONToken::Null ||
-                                (*itr).mToken == havJSONToken::Boolean ||
-                                (*itr).mToken == havJSONToken::Int ||
-                                (*itr).mToken == havJSONToken::UInt ||
-                                (*itr).mToken == havJSONToken::Long ||
-                                (*itr).mToken == havJSONToken::ULong ||
-                                (*itr).mToken == havJSONToken::Int64 ||
-                                (*itr).mToken == havJSONToken::UInt64 ||
-                                (*itr).mToken == havJSONToken::Double))
-                            {
-                                currentChar = '\n';
+        bool write(const havJSONData& record)
+        {
+            if (mOutput == nullptr)
+            {
+                return false;
+            }
 
-                                jsonContentsAsString += currentChar;
-                            }
+            mWriter.WriteRecord(record, *mOutput);
 
-                            if (previousToken == havJSONToken::Colon &&
-                                (*itr).mToken == havJSONToken::LeftCurlyBracket)
-                            {
-                                currentChar = ' ';
+            mOutput->Write('\n');
 
-                                jsonContentsAsString += currentChar;
-                            }
+            return mOutput->IsGood();
+        }
 
-                            if (previousToken == havJSONToken::RightCurlyBracket &&
-                                (*itr).mToken == havJSONToken::RightCurlyBracket)
-                            {
-                                currentChar = '\n';
+        // Hands the buffered records to the file or sink
+        bool flush()
+        {
+            if (mOutput == nullptr)
+            {
+                return false;
+            }
 
-                                jsonContentsAsString += currentChar;
-                            }
+            bool result = mOutput->Flush();
 
-                            if ((previousToken == havJSONToken::Value ||
-                                 previousToken == havJSONToken::Null ||
-                                 previousToken == havJSONToken::Boolean ||
-                                 previousToken == havJSONToken::Int ||
-                                 previousToken == havJSONToken::UInt ||
-                                 previousToken == havJSONToken::Long ||
-                                 previousToken == havJSONToken::ULong ||
-                                 previousToken == havJSONToken::Int64 ||
-                                 previousToken == havJSONToken::UInt64 ||
-                                 previousToken == havJSONToken::Double) &&
-                                ((*itr).mToken == havJSONToken::RightSquareBracket ||
-                                 (*itr).mToken == havJSONToken::RightCurlyBracket))
-                            {
-                                currentChar = '\n';
+            if (mFileStream != nullptr)
+            {
+                result = (std::fflush(mFileStream.get()) == 0) && result;
+            }
 
-                                jsonContentsAsString += currentChar;
+            return result;
+        }
 
-                                currentChar = ' ';
+        bool close()
+        {
+            bool result = true;
 
-                                for (int index = 0; index < tokenTypesSize * 4; ++index)
-                                {
-                                    jsonContentsAsString += currentChar;
-                                }
-                            }
+            if (mOutput != nullptr)
+            {
+                result = mOutput->Flush();
+            }
 
-                            currentChar = ' ';
+            mFileBuffer.reset();
+            mFileStream.reset();
+            mOutput = nullptr;
 
-                            if (previousToken == havJSONToken::Colon &&
-                                (*itr).mToken == havJSONToken::LeftSquareBracket)
-                            {
-                                jsonContentsAsString += currentChar;
-                            }
+            return result;
+        }
 
-                            if (previousToken != havJSONToken::Colon &&
-                                (*itr).mToken != havJSONToken::Value &&
-                                (*itr).mToken != havJSONToken::Null &&
-                                (*itr).mToken != havJSONToken::Boolean &&
-                                (*itr).mToken != havJSONToken::Int &&
-                                (*itr).mToken != havJSONToken::UInt &&
-                                (*itr).mToken != havJSONToken::Long &&
-                                (*itr).mToken != havJSONToken::ULong &&
-                                (*itr).mToken != havJSONToken::Int64 &&
-                                (*itr).mToken != havJSONToken::UInt64 &&
-                                (*itr).mToken != havJSONToken::Double)
-                            {
-                                if ((*itr).mToken != havJSONToken::Colon &&
-                                    (*itr).mToken != havJSONToken::Comma)
-                                {
-                                    if (previousToken != havJSONToken::Value &&
-                                        previousToken != havJSONToken::Null &&
-                                        previousToken != havJSONToken::Boolean &&
-                                        previousToken != havJSONToken::Int &&
-                                        previousToken != havJSONToken::UInt &&
-                                        previousToken != havJSONToken::Long &&
-                                        previousToken != havJSONToken::ULong &&
-                                        previousToken != havJSONToken::Int64 &&
-                                        previousToken != havJSONToken::UInt64 &&
-                                        previousToken != havJSONToken::Double &&
-                                        (*itr).mToken != havJSONToken::RightSquareBracket)
-                                    {
-                                        for (int index = 0; index < tokenTypesSize * 4; ++index)
-                                        {
-                                            jsonContentsAsString += currentChar;
-                                        }
-                                    }
-                                }
-                            }
+    private:
+        havJSONStream mStream;
 
-                            if ((previousToken == havJSONToken::Comma || previousToken == havJSONToken::Colon) &&
-                                ((*itr).mToken == havJSONToken::Value ||
-                                 (*itr).mToken == havJSONToken::Null ||
-                                 (*itr).mToken == havJSONToken::Boolean ||
-                                 (*itr).mToken == havJSONToken::Int ||
-                                 (*itr).mToken == havJSONToken::UInt ||
-                                 (*itr).mToken == havJSONToken::Long ||
-                                 (*itr).mToken == havJSONToken::ULong ||
-                                 (*itr).mToken == havJSONToken::Int64 ||
-                                 (*itr).mToken == havJSONToken::UInt64 ||
-                                 (*itr).mToken == havJSONToken::Double))
-                            {
-                                jsonContentsAsString += currentChar;
-                            }
-                        }
-                    }
+        havJSONWriter mWriter;
 
-                    if ((*itr).mToken != havJSONToken::Value &&
-                        (*itr).mToken != havJSONToken::Null &&
-                        (*itr).mToken != havJSONToken::Boolean &&
-                        (*itr).mToken != havJSONToken::Int &&
-                        (*itr).mToken != havJSONToken::UInt &&
-                        (*itr).mToken != havJSONToken::Long &&
-                        (*itr).mToken != havJSONToken::ULong &&
-                        (*itr).mToken != havJSONToken::Int64 &&
-                        (*itr).mToken != havJSONToken::UInt64 &&
-                        (*itr).mToken != havJSONToken::Double &&
-                        (*itr).mToken != havJSONToken::String)
-                    {
-                        currentChar = GetTokenAsCharacter((*itr).mToken);
+        std::unique_ptr<std::FILE, decltype(&std::fclose)> mFileStream { nullptr, std::fclose };
+        std::unique_ptr<havJSONOutputBuffer> mFileBuffer;
 
-                        jsonContentsAsString += currentChar;
-                    }
-                    else
-                    {
-                        std::string value;
+        havJSONOutputBuffer* mOutput = nullptr;
+    };
 
-                        if ((*itr).mToken == havJSONToken::String ||
-                            (*itr).mToken == havJSONToken::Value)
-                        {
-                            value = "\"";
-                            value += ConvertToEscapedString((*itr).mValue.value());
-                            value += "\"";
-                        }
-                        else
-                        {
-                            value = (*itr).mValue.value();
-                        }
+    // Keeps a parser, its scratch buffers and the output buffers between calls, so repeated calls only allocate once the buffers
+    // have grown to the size of the largest input. A context must only be used by one thread at a time; use one per worker thread.
+    class havJSONContext
+    {
+    public:
+        havJSONContext()
+        {
+            mStream.SetParserType(havJSONParserType::RecursiveDescent);
+        }
 
-                        jsonContentsAsString += value;
-                    }
+        havJSONContext(const havJSONContext&) = delete;
+        havJSONContext& operator=(const havJSONContext&) = delete;
 
-                    if ((*itr).mToken == havJSONToken::LeftCurlyBracket ||
-                        (*itr).mToken == havJSONToken::LeftSquareBracket)
-                    {
-                        if ((*itr).mToken == havJSONToken::LeftCurlyBracket)
-                        {
-                            currentType = havJSONDataType::Object;
+        bool parse(std::string_view content, havJSONData& valueNode)
+        {
+            return mStream.ParseContent(content, valueNode);
+        }
 
-                            tokenTypes.push_back(currentType);
-                        }
+        // Note: The document's arena keeps its blocks when it's cleared, so parsing into the same document again reuses them
+        bool parse(std::string_view content, havJSONDocument& document)
+        {
+            return mStream.ParseContent(content, document);
+        }
 
-                        if ((*itr).mToken == havJSONToken::LeftSquareBracket)
-                        {
-                            currentType = havJSONDataType::Array;
+        bool parse(std::string_view content, havJSONDocument& document, const havJSONFilter& filter)
+        {
+            return mStream.ParseContent(content, document, filter);
+        }
 
-                            tokenTypes.push_back(currentType);
-                        }
+        bool parse(std::string_view content, havJSONSAXHandler& handler)
+        {
+            return mStream.ParseContent(content, handler);
+        }
 
-                        tokenTypesSize = tokenTypes.size();
-                    }
+        template<typename T, std::enable_if_t<havJSONIsBindableRoot<T>::value, int> = 0>
+        bool parse(std::string_view content, T& value)
+        {
+            return mStream.ParseContent(content, value);
+        }
 
-                    previousToken = (*itr).mToken;
+        bool parseBSON(std::string_view content, havJSONData& valueNode)
+        {
+            return mStream.ParseBSONContent(content, valueNode);
+        }
 
-                    ++itr;
-                }
+        // Like parse, but reports malformed input through the result instead of throwing
+        havJSONResult tryParse(std::string_view content, havJSONData& valueNode)
+        {
+            return mStream.TryParseContent(content, valueNode);
+        }
 
-                return true;
-            }
+        havJSONResult tryParse(std::string_view content, havJSONDocument& document)
+        {
+            return mStream.TryParseContent(content, document);
+        }
 
-            return false;
+        havJSONResult tryParseFile(const std::string& fileName, havJSONData& valueNode, havJSONType jsonType = havJSONType::JSON)
+        {
+            return mStream.TryParseFile(fileName, valueNode, jsonType);
         }
 
-        // Note: BOM is illegal in JSON!
-        bool WriteJSONFile(const std::string& fileName, havJSONData& valueNode, std::string& jsonContentsAsString, bool formatted = false)
+        template<typename T, std::enable_if_t<havJSONIsBindableRoot<T>::value, int> = 0>
+        havJSONResult tryParse(std::string_view content, T& value)
         {
-            // 1. Open file stream
-#ifdef _WIN32
-            std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(_wfopen(&ConvertStringToWString(fileName)[0], L"wb"), std::fclose);
-#else
-            std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(std::fopen(fileName.c_str(), "wb"), std::fclose);
-#endif
+            return mStream.TryParseContent(content, value);
+        }
 
-            if (fileStream == nullptr)
-            {
-                std::cout << "Unable to write JSON file: " << fileName << "\n";
+        void setParseOptions(const havJSONParseOptions& parseOptions) { mStream.SetParseOptions(parseOptions); }
 
-                return false;
-            }
+#ifdef HAVJSON_STATS
+        // Statistics of all calls on the calling thread's context, e.g. to export them per thread
+        const havJSONStats& stats() const { return mStream.GetStats(); }
 
-            // 2. Convert JSON to string
-            if (ConvertJSONToString(valueNode, jsonContentsAsString, formatted) == true)
-            {
-                std::fwrite(jsonContentsAsString.data(), sizeof(char), jsonContentsAsString.size(), fileStream.get());
+        void resetStats() { mStream.ResetStats(); }
+#endif
 
-                return true;
+        // Returns a view of the context's output buffer, which is valid until the next call to serialize
+        std::string_view serialize(const havJSONData& valueNode, bool formatted = false)
+        {
+            mOutputString.clear();
+
+            if (mStream.ConvertJSONToString(valueNode, mOutputString, formatted) == false)
+            {
+                return std::string_view();
             }
 
-            return false;
+            return mOutputString;
         }
 
-        bool ConvertJSONToBSON(havJSONData& valueNode, std::vector<char>& jsonContentsAsBinaryStream)
+        template<typename T, std::enable_if_t<havJSONIsBindableRoot<T>::value, int> = 0>
+        std::string_view serialize(const T& value, bool formatted = false)
         {
-            std::deque<havJSONTokenValue> tokens;
+            mOutputString.clear();
 
-            // 1. Tokenization phase
-            if (Tokenization(valueNode, tokens) == true)
+            if (mStream.ConvertJSONToString(value, mOutputString, formatted) == false)
             {
-                // 2. Write contents to binary stream
-                if (tokens[0].mToken != havJSONToken::LeftCurlyBracket)
-                {
-                    throw std::runtime_error("BSON document must be an object!");
-                }
-
-                // Remove unnecessary tokens and change unsupported data types where possible
-                auto itr = tokens.begin();
-
-                while (itr != tokens.end())
-                {
-                    if ((*itr).mToken == havJSONToken::Colon ||
-                        (*itr).mToken == havJSONToken::Comma)
-                    {
-                        itr = tokens.erase(itr);
-                    }
-                    else
-                    {
-                        if ((*itr).mToken == havJSONToken::UInt)
-                        {
-                            (*itr).mToken = havJSONToken::Int;
-                        }
+                return std::string_view();
+            }
 
-                        if ((*itr).mToken == havJSONToken::Long)
-                        {
-                            (*itr).mToken = havJSONToken::Int64;
-                        }
+            return mOutputString;
+        }
 
-                        if ((*itr).mToken == havJSONToken::ULong)
-                        {
-                            (*itr).mToken = havJSONToken::UInt64;
-                        }
+        // Returns the context's output buffer, which is valid until the next call to serializeBSON
+        const std::vector<char>& serializeBSON(const havJSONData& valueNode)
+        {
+            mStream.ConvertJSONToBSON(valueNode, mBSONOutput);
 
-                        ++itr;
-                    }
-                }
+            return mBSONOutput;
+        }
 
-                std::deque<havJSONBSONDataType> tokenTypes;
+        bool writeJSONFile(const std::string& fileName, const havJSONData& valueNode, bool formatted = false)
+        {
+            return mStream.WriteJSONFile(fileName, valueNode, formatted);
+        }
 
-                itr = tokens.begin();
+        bool writeBSONFile(const std::string& fileName, const havJSONData& valueNode)
+        {
+            return mStream.WriteBSONFile(fileName, valueNode, mBSONOutput);
+        }
 
-                if ((*itr).mToken == havJSONToken::LeftCurlyBracket)
-                {
-                    tokenTypes.push_back({ havJSONDataType::Object, 0, 0, 0 });
-                }
+        // Returns the calling thread's context
+        static havJSONContext& local()
+        {
+            thread_local havJSONContext context;
 
-                ++itr;
+            return context;
+        }
 
-                int fileIndex = 0;
+    private:
+        havJSONStream mStream;
 
-                while (itr != tokens.end())
-                {
-                    havJSONBSONDataType& currentType = tokenTypes.back();
+        std::string mOutputString;
 
-                    if ((*itr).mToken == havJSONToken::LeftCurlyBracket ||
-                        (*itr).mToken == havJSONToken::LeftSquareBracket)
-                    {
-                        if ((*itr).mToken == havJSONToken::LeftCurlyBracket)
-                        {
-                            tokenTypes.push_back({ havJSONDataType::Object, fileIndex, 0, 0 });
+        std::vector<char> mBSONOutput;
+    };
 
-                            ++itr;
+    // Stateless parse and serialize functions that can be called from any number of threads at once. Parsing uses the calling
+    // thread's havJSONContext, so its scratch buffers are reused between calls on the same thread.
+    class havJSONCodec
+    {
+    public:
+        bool parse(std::string_view content, havJSONData& valueNode) const
+        {
+            return havJSONContext::local().parse(content, valueNode);
+        }
 
-                            continue;
-                        }
+        bool parse(std::string_view content, havJSONDocument& document) const
+        {
+            return havJSONContext::local().parse(content, document);
+        }
 
-                        if ((*itr).mToken == havJSONToken::LeftSquareBracket)
-                        {
-                            tokenTypes.push_back({ havJSONDataType::Array, fileIndex, 4, 0 });
+        bool parse(std::string_view content, havJSONSAXHandler& handler) const
+        {
+            return havJSONContext::local().parse(content, handler);
+        }
 
-                            ++itr;
+        template<typename T, std::enable_if_t<havJSONIsBindableRoot<T>::value, int> = 0>
+        bool parse(std::string_view content, T& value) const
+        {
+            return havJSONContext::local().parse(content, value);
+        }
 
-                            continue;
-                        }
-                    }
+        bool parseBSON(std::string_view content, havJSONData& valueNode) const
+        {
+            return havJSONContext::local().parseBSON(content, valueNode);
+        }
 
-                    if ((*itr).mToken == havJSONToken::RightCurlyBracket ||
-                        (*itr).mToken == havJSONToken::RightSquareBracket)
-                    {
-                        if ((*itr).mToken == havJSONToken::RightSquareBracket)
-                        {
-                            std::stringstream stream;
+        // Appends the JSON text to output
+        bool serialize(const havJSONData& valueNode, std::string& output, bool formatted = false) const
+        {
+            havJSONOutputBuffer outputBuffer(output);
+            havJSONWriter writer(formatted);
 
-                            stream << std::hex << std::setw(8) << std::setfill('0') << ++currentType.mArrayTotalSize;
+            return writer.Write(valueNode, outputBuffer);
+        }
 
-                            std::string stringOutput = stream.str();
+        template<typename T, std::enable_if_t<havJSONIsBindableRoot<T>::value, int> = 0>
+        bool serialize(const T& value, std::string& output, bool formatted = false) const
+        {
+            havJSONOutputBuffer outputBuffer(output);
+            havJSONWriter writer(formatted);
 
-                            int currIndex = 0;
+            return writer.WriteBound(value, outputBuffer);
+        }
 
-                            for (int sindex = stringOutput.size() - 2; sindex >= 0; sindex -= 2)
-                            {
-                                std::string twoChar = stringOutput.substr(sindex, 2);
-                                char byte = std::strtol(twoChar.c_str(), 0, 16);
-                                jsonContentsAsBinaryStream.insert(jsonContentsAsBinaryStream.begin() + currentType.mIndexToWriteTotalSizeTo + currIndex, byte);
-                                ++currIndex;
-                            }
+        std::string serialize(const havJSONData& valueNode, bool formatted = false) const
+        {
+            std::string output;
 
-                            fileIndex += 4;
-                        }
+            serialize(valueNode, output, formatted);
 
-                        jsonContentsAsBinaryStream.push_back(0x00);
+            return output;
+        }
 
-                        tokenTypes.pop_back();
+        bool serializeBSON(const havJSONData& valueNode, std::vector<char>& output) const
+        {
+            output.clear();
 
-                        ++fileIndex;
+            havJSONBSONWriter writer;
 
-                        ++itr;
+            writer.Write(valueNode, output);
 
-                        continue;
-                    }
+            return output.empty() == false;
+        }
 
-                    if ((*itr).mToken == havJSONToken::Value ||
-                        (*itr).mToken == havJSONToken::Null ||
-                        (*itr).mToken == havJSONToken::Boolean ||
-                        (*itr).mToken == havJSONToken::Int ||
-                        (*itr).mToken == havJSONToken::UInt64 ||
-                        (*itr).mToken == havJSONToken::Int64 ||
-                        (*itr).mToken == havJSONToken::Double ||
-                        (*itr).mToken == havJSONToken::String ||
-                        (*itr).mToken == havJSONToken::LeftCurlyBracket ||
-                        (*itr).mToken == havJSONToken::LeftSquareBracket ||
-                        (*itr).mToken == havJSONToken::RightCurlyBracket ||
-                        (*itr).mToken == havJSONToken::RightSquareBracket)
-                    {
-                        // The data type must be known beforehand, so peek at the next token
-                        if (currentType.mDataType != havJSONDataType::Array)
-                        {
-                            ++itr;
-                        }
+        // The async functions run the whole call, including the file I/O, on a thread of their own. valueNode has to stay alive
+        // until the future is ready, and mustn't be changed in the meantime when it's written.
+        std::future<havJSONResult> parseFileAsync(std::string fileName, havJSONData& valueNode, havJSONType jsonType = havJSONType::JSON) const
+        {
+            return std::async(std::launch::async, [fileName = std::move(fileName), &valueNode, jsonType]()
+            {
+                return havJSONContext::local().tryParseFile(fileName, valueNode, jsonType);
+            });
+        }
 
-                        havJSONTokenValue nextToken = (*itr);
+        std::future<bool> writeJSONFileAsync(std::string fileName, const havJSONData& valueNode, bool formatted = false) const
+        {
+            return std::async(std::launch::async, [fileName = std::move(fileName), &valueNode, formatted]()
+            {
+                return havJSONContext::local().writeJSONFile(fileName, valueNode, formatted);
+            });
+        }
 
-                        // Return to current token
-                        if (currentType.mDataType != havJSONDataType::Array)
-                        {
-                            --itr;
-                        }
+        std::future<bool> writeBSONFileAsync(std::string fileName, const havJSONData& valueNode) const
+        {
+            return std::async(std::launch::async, [fileName = std::move(fileName), &valueNode]()
+            {
+                return havJSONContext::local().writeBSONFile(fileName, valueNode);
+            });
+        }
+    };
 
-                        switch (nextToken.mToken)
-                        {
-                            case havJSONToken::Value:
-                                // String data type
-                                jsonContentsAsBinaryStream.push_back(0x02);
-                                break;
+    enum class havJSONBatchOutputType : std::uint8_t
+    {
+        JSON,
+        FormattedJSON,
+        BSON
+    };
 
-                            case havJSONToken::Null:
-                                jsonContentsAsBinaryStream.push_back(0x0a);
-                                break;
+    // Input and output file of one conversion
+    struct havJSONBatchFile
+    {
+        std::string mInputFileName;
+        std::string mOutputFileName;
+    };
 
-                            case havJSONToken::Boolean:
-                                jsonContentsAsBinaryStream.push_back(0x08);
-                                break;
+    // Converts many files in a pipeline: one thread reads the next files, the workers parse and encode them, and the calling thread
+    // writes the finished ones, so waiting for the disk overlaps with the CPU work. Up to maxPendingFiles files wait to be
+    // converted, and as many wait to be written.
+    class havJSONBatchConverter
+    {
+    public:
+        // Uses one worker per hardware thread if numOfWorkers is 0, and two pending files per worker if maxPendingFiles is 0
+        explicit havJSONBatchConverter(unsigned int numOfWorkers = 0, std::size_t maxPendingFiles = 0) : mNumOfWorkers(numOfWorkers), mMaxPendingFiles(maxPendingFiles)
+        {
+            if (mNumOfWorkers == 0)
+            {
+                mNumOfWorkers = std::max(1u, std::thread::hardware_concurrency());
+            }
 
-                            case havJSONToken::Int:
-                                jsonContentsAsBinaryStream.push_back(0x10);
-                                break;
+            if (mMaxPendingFiles == 0)
+            {
+                mMaxPendingFiles = 2 * static_cast<std::size_t>(mNumOfWorkers);
+            }
+        }
 
-                            case havJSONToken::UInt64:
-                                jsonContentsAsBinaryStream.push_back(0x11);
-                                break;
+        void SetInputType(havJSONType inputType) { mInputType = inputType; }
 
-                            case havJSONToken::Int64:
-                                jsonContentsAsBinaryStream.push_back(0x12);
-                                break;
+        void SetOutputType(havJSONBatchOutputType outputType) { mOutputType = outputType; }
 
-                            case havJSONToken::Double:
-                                jsonContentsAsBinaryStream.push_back(0x01);
-                                break;
+        void SetParseOptions(const havJSONParseOptions& parseOptions) { mParseOptions = parseOptions; }
 
-                            case havJSONToken::LeftSquareBracket:
-                                jsonContentsAsBinaryStream.push_back(0x04);
-                                break;
+        // Messages of all threads go to errorStream, one whole message at a time. nullptr turns them off.
+        void SetErrorStream(std::ostream* errorStream) { mErrorStream = errorStream; }
 
-                            case havJSONToken::String:
-                            case havJSONToken::LeftCurlyBracket:
-                            case havJSONToken::RightCurlyBracket:
-                            case havJSONToken::RightSquareBracket:
-                                // Ignore
-                                break;
+        // Returns one result per file, in the order of files. Files that fail are skipped, the others are converted regardless.
+        // Exceptions other than parse errors (e.g. std::bad_alloc) stop the batch and are rethrown once all threads have finished.
+        std::vector<havJSONResult> ConvertFiles(const std::vector<havJSONBatchFile>& files)
+        {
+            std::vector<havJSONResult> results(files.size());
 
-                            default:
-                                throw std::runtime_error("Unsupported token!");
-                        }
+            havJSONBatchQueue readQueue(mMaxPendingFiles);
+            havJSONBatchQueue writeQueue(mMaxPendingFiles);
 
-                        if (nextToken.mToken != havJSONToken::RightCurlyBracket &&
-                            nextToken.mToken != havJSONToken::RightSquareBracket)
-                        {
-                            ++fileIndex;
+            std::exception_ptr exception;
+            std::mutex exceptionMutex;
 
-                            if (currentType.mDataType == havJSONDataType::Array)
-                            {
-                                ++currentType.mArrayTotalSize;
-                            }
-                        }
+            // Keeps the first exception and lets all threads run out
+            auto stop = [&]()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(exceptionMutex);
 
-                        if (currentType.mDataType == havJSONDataType::Array)
-                        {
-                            // Integer to HEX string conversion
-                            std::stringstream stream;
+                    if (exception == nullptr)
+                    {
+                        exception = std::current_exception();
+                    }
+                }
 
-                            stream << std::hex << currentType.mCurrentArrayItemIndex;
+                readQueue.Close(true);
+                writeQueue.Close(true);
+            };
 
-                            std::string stringOutput = stream.str();
+            std::thread readerThread([&]()
+            {
+                try
+                {
+                    ReadFiles(files, results, readQueue);
+                }
+                catch (...)
+                {
+                    stop();
+                }
 
-                            for (std::string::size_type sindex = 0; sindex < 2; ++sindex)
-                            {
-                                if (sindex < stringOutput.size())
-                                {
-                                    jsonContentsAsBinaryStream.push_back(stringOutput[sindex]);
-                                }
-                                else
-                                {
-                                    jsonContentsAsBinaryStream.push_back(0x00);
-                                }
-                            }
+                readQueue.Close(false);
+            });
 
-                            fileIndex += 2;
+            std::atomic<unsigned int> numOfRunningWorkers(mNumOfWorkers);
 
-                            currentType.mArrayTotalSize += 2;
-                        }
+            std::vector<std::thread> workerThreads;
+            workerThreads.reserve(mNumOfWorkers);
 
-                        switch ((*itr).mToken)
-                        {
-                            case havJSONToken::Value:
-                                {
-                                    // String size
-                                    std::string stringOutput = CodePointToString((*itr).mValue.value().size() + 1);
+            for (unsigned int workerIndex = 0; workerIndex < mNumOfWorkers; ++workerIndex)
+            {
+                workerThreads.emplace_back([&]()
+                {
+                    try
+                    {
+                        ConvertItems(files, results, readQueue, writeQueue);
+                    }
+                    catch (...)
+                    {
+                        stop();
+                    }
 
-                                    for (std::string::size_type sindex = 0; sindex < 4; ++sindex)
-                                    {
-                                        if (sindex < stringOutput.size())
-                                        {
-                                            jsonContentsAsBinaryStream.push_back(stringOutput[sindex]);
-                                        }
-                                        else
-                                        {
-                                            jsonContentsAsBinaryStream.push_back(0x00);
-                                        }
-                                    }
+                    // The last worker lets the writer run out
+                    if (--numOfRunningWorkers == 0)
+                    {
+                        writeQueue.Close(false);
+                    }
+                });
+            }
 
-                                    // String
-                                    std::string stringValue = (*itr).mValue.value();
-                                    for (std::string::size_type stringIndex = 0; stringIndex < stringValue.size(); ++stringIndex)
-                                    {
-                                        jsonContentsAsBinaryStream.push_back(stringValue[stringIndex]);
-                                    }
+            try
+            {
+                WriteItems(files, results, writeQueue);
+            }
+            catch (...)
+            {
+                stop();
+            }
 
-                                    // Null terminator
-                                    jsonContentsAsBinaryStream.push_back(0x00);
+            readerThread.join();
 
-                                    fileIndex += (4 + stringValue.size() + 1);
+            for (std::thread& workerThread : workerThreads)
+            {
+                workerThread.join();
+            }
 
-                                    if (currentType.mDataType == havJSONDataType::Array)
-                                    {
-                                        currentType.mArrayTotalSize += (4 + stringValue.size() + 1);
-                                    }
-                                }
-                                break;
+            if (exception != nullptr)
+            {
+                std::rethrow_exception(exception);
+            }
 
-                            case havJSONToken::Boolean:
-                                {
-                                    if ((*itr).mValue.value() == "true")
-                                    {
-                                        // "true" value
-                                        jsonContentsAsBinaryStream.push_back(0x01);
-                                    }
-                                    else
-                                    {
-                                        // "false" value
-                                        jsonContentsAsBinaryStream.push_back(0x00);
-                                    }
+            return results;
+        }
 
-                                    ++fileIndex;
+        // Runs ConvertFiles on a thread of its own. The converter mustn't be changed or destroyed until the future is ready.
+        std::future<std::vector<havJSONResult>> ConvertFilesAsync(std::vector<havJSONBatchFile> files)
+        {
+            return std::async(std::launch::async, [this, files = std::move(files)]() { return ConvertFiles(files); });
+        }
 
-                                    if (currentType.mDataType == havJSONDataType::Array)
-                                    {
-                                        ++currentType.mArrayTotalSize;
-                                    }
-                                }
-                                break;
+    private:
+        // A file on its way through the pipeline
+        struct havJSONBatchItem
+        {
+            std::size_t mIndex = 0;
+            std::unique_ptr<havJSONFileMapping> mFileMapping;
+            std::string mJSONContents;
+            std::vector<char> mBSONContents;
+        };
 
-                            case havJSONToken::Int:
-                                {
-                                    std::stringstream stream;
+        // Blocking queue with a fixed capacity
+        class havJSONBatchQueue
+        {
+        public:
+            explicit havJSONBatchQueue(std::size_t capacity) : mCapacity(capacity) {}
 
-                                    stream << std::hex << std::setw(8) << std::setfill('0') << std::stoi((*itr).mValue.value());
+            // Waits for a free slot. Returns false if the queue was closed.
+            bool Push(havJSONBatchItem&& item)
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
 
-                                    std::string stringOutput = stream.str();
+                mNotFull.wait(lock, [&]() { return mItems.size() < mCapacity || mClosed == true; });
 
-                                    for (int sindex = stringOutput.size() - 2; sindex >= 0; sindex -= 2)
-                                    {
-                                        std::string twoChar = stringOutput.substr(sindex, 2);
-                                        char byte = std::strtol(twoChar.c_str(), 0, 16);
-                                        jsonContentsAsBinaryStream.push_back(byte);
-                                    }
+                if (mClosed == true)
+                {
+                    return false;
+                }
 
-                                    fileIndex += 4;
+                mItems.push_back(std::move(item));
 
-                                    if (currentType.mDataType == havJSONDataType::Array)
-                                    {
-                                        currentType.mArrayTotalSize += 4;
-                                    }
-                                }
-                                break;
+                mNotEmpty.notify_one();
 
-                            case havJSONToken::UInt64:
-                                {
-                                    std::stringstream stream;
+                return true;
+            }
 
-                                    stream << std::hex << std::setw(16) << std::setfill('0') << std::stoull((*itr).mValue.value());
+            // Waits for an item. Returns false once the queue is closed and empty.
+            bool Pop(havJSONBatchItem& item)
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
 
-                                    std::string stringOutput = stream.str();
+                mNotEmpty.wait(lock, [&]() { return mItems.empty() == false || mClosed == true; });
 
-                                    for (int sindex = stringOutput.size() - 2; sindex >= 0; sindex -= 2)
-                                    {
-                                        std::string twoChar = stringOutput.substr(sindex, 2);
-                                        char byte = std::strtol(twoChar.c_str(), 0, 16);
-                                        jsonContentsAsBinaryStream.push_back(byte);
-                                    }
+                if (mItems.empty() == true)
+                {
+                    return false;
+                }
 
-                                    fileIndex += 8;
+                item = std::move(mItems.front());
+                mItems.pop_front();
 
-                                    if (currentType.mDataType == havJSONDataType::Array)
-                                    {
-                                        currentType.mArrayTotalSize += 8;
-                                    }
-                                }
-                                break;
+                mNotFull.notify_one();
 
-                            case havJSONToken::Int64:
-                                {
-                                    std::stringstream stream;
+                return true;
+            }
 
-                                    stream << std::hex << std::setw(16) << std::setfill('0') << std::stoll((*itr).mValue.value());
+            // Note: Items that are still queued are only dropped if discardItems is true
+            void Close(bool discardItems)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
 
-                                    std::string stringOutput = stream.str();
+                mClosed = true;
 
-                                    for (int sindex = stringOutput.size() - 2; sindex >= 0; sindex -= 2)
-                                    {
-                                        std::string twoChar = stringOutput.substr(sindex, 2);
-                                        char byte = std::strtol(twoChar.c_str(), 0, 16);
-                                        jsonContentsAsBinaryStream.push_back(byte);
-                                    }
+                if (discardItems == true)
+                {
+                    mItems.clear();
+                }
 
-                                    fileIndex += 8;
+                mNotFull.notify_all();
+                mNotEmpty.notify_all();
+            }
 
-                                    if (currentType.mDataType == havJSONDataType::Array)
-                                    {
-                                        currentType.mArrayTotalSize += 8;
-                                    }
-                                }
-                                break;
+        private:
+            std::size_t mCapacity;
+            std::deque<havJSONBatchItem> mItems;
+            bool mClosed = false;
 
-                            case havJSONToken::Double:
-                                {
-                                    // Double to HEX converion
-                                    std::stringstream stream;
+            std::mutex mMutex;
+            std::condition_variable mNotFull;
+            std::condition_variable mNotEmpty;
+        };
 
-                                    std::int64_t integerValue;
+        // 1. Opens the files in order and reads their contents into memory
+        void ReadFiles(const std::vector<havJSONBatchFile>& files, std::vector<havJSONResult>& results, havJSONBatchQueue& readQueue)
+        {
+            std::ostringstream errorBuffer;
 
-                                    double doubleValue = std::stod((*itr).mValue.value());
+            havJSONStream stream;
+            stream.SetErrorStream((mErrorStream != nullptr) ? &errorBuffer : nullptr);
 
-                                    std::memcpy(&integerValue, &doubleValue, sizeof(std::int64_t));
+            for (std::size_t fileIndex = 0; fileIndex < files.size(); ++fileIndex)
+            {
+                havJSONBatchItem item;
+                item.mIndex = fileIndex;
+                item.mFileMapping = std::make_unique<havJSONFileMapping>();
 
-                                    stream << std::hex << integerValue;
+#ifdef _WIN32
+                bool fileOpened = item.mFileMapping->Open(stream.ConvertStringToWString(files[fileIndex].mInputFileName));
+#else
+                bool fileOpened = item.mFileMapping->Open(files[fileIndex].mInputFileName);
+#endif
 
-                                    std::string stringOutput = stream.str();
+                if (fileOpened == false)
+                {
+                    stream.LogError("Unable to parse ", (mInputType == havJSONType::BSON) ? "BSON" : "JSON", " file: ", files[fileIndex].mInputFileName, "\n");
+                    FlushErrors(errorBuffer);
 
-                                    for (int sindex = stringOutput.size() - 2; sindex >= 0; sindex -= 2)
-                                    {
-                                        std::string twoChar = stringOutput.substr(sindex, 2);
-                                        char byte = std::strtol(twoChar.c_str(), 0, 16);
-                                        jsonContentsAsBinaryStream.push_back(byte);
-                                    }
+                    results[fileIndex].mCode = havJSONErrorCode::FileNotOpened;
 
-                                    fileIndex += 8;
+                    continue;
+                }
 
-                                    if (currentType.mDataType == havJSONDataType::Array)
-                                    {
-                                        currentType.mArrayTotalSize += 8;
-                                    }
-                                }
-                                break;
+                item.mFileMapping->Prefetch();
 
-                            case havJSONToken::String:
-                                {
-                                    // String
-                                    std::string stringValue = (*itr).mValue.value();
-                                    for (std::string::size_type sindex = 0; sindex < stringValue.size(); ++sindex)
-                                    {
-                                        jsonContentsAsBinaryStream.push_back(stringValue[sindex]);
-                                    }
+                if (readQueue.Push(std::move(item)) == false)
+                {
+                    return;
+                }
+            }
+        }
 
-                                    // Null terminator
-                                    jsonContentsAsBinaryStream.push_back(0x00);
+        // 2. Parses the files and encodes them in the output format
+        void ConvertItems(const std::vector<havJSONBatchFile>& files, std::vector<havJSONResult>& results, havJSONBatchQueue& readQueue, havJSONBatchQueue& writeQueue)
+        {
+            std::ostringstream errorBuffer;
 
-                                    fileIndex += (stringValue.size() + 1);
+            havJSONStream stream;
+            stream.SetErrorStream((mErrorStream != nullptr) ? &errorBuffer : nullptr);
+            stream.SetParseOptions(mParseOptions);
+            stream.SetParserType(havJSONParserType::RecursiveDescent);
 
-                                    if (currentType.mDataType == havJSONDataType::Array)
-                                    {
-                                        currentType.mArrayTotalSize += (stringValue.size() + 1);
-                                    }
-                                }
-                                break;
+            havJSONData valueNode;
 
-                            case havJSONToken::RightCurlyBracket:
-                            case havJSONToken::RightSquareBracket:
-                                {
-                                    jsonContentsAsBinaryStream.push_back(0x00);
+            havJSONBatchItem item;
 
-                                    ++fileIndex;
+            while (readQueue.Pop(item) == true)
+            {
+                results[item.mIndex] = stream.TryParseFileMapping(files[item.mIndex].mInputFileName, *item.mFileMapping, valueNode, mInputType);
+                FlushErrors(errorBuffer);
 
-                                    if (currentType.mDataType == havJSONDataType::Array)
-                                    {
-                                        ++currentType.mArrayTotalSize;
-                                    }
-                                }
-                                break;
+                // Note: Unmaps the file before its output is queued, so at most the pending outputs are held in memory
+                item.mFileMapping.reset();
 
-                            case havJSONToken::Null:
-                            case havJSONToken::LeftCurlyBracket:
-                            case havJSONToken::LeftSquareBracket:
-                                // Ignore
-                                break;
+                if (results[item.mIndex].failed() == true)
+                {
+                    continue;
+                }
 
-                            default:
-                                // Unlikely, but we want to make the compiler happy
-                                throw std::runtime_error("Unsupported token!");
-                        }
+                try
+                {
+                    if (mOutputType == havJSONBatchOutputType::BSON)
+                    {
+                        stream.ConvertJSONToBSON(valueNode, item.mBSONContents);
                     }
                     else
                     {
-                        throw std::runtime_error("Unsupported token!");
+                        stream.ConvertJSONToString(valueNode, item.mJSONContents, mOutputType == havJSONBatchOutputType::FormattedJSON);
                     }
+                }
+                catch (const std::exception& error)
+                {
+                    // Note: E.g. a document whose root isn't an object can't be encoded as BSON
+                    stream.LogError("Unable to convert file: ", files[item.mIndex].mInputFileName, " (", error.what(), ")\n");
+                    FlushErrors(errorBuffer);
 
-                    if (currentType.mDataType == havJSONDataType::Array)
-                    {
-                        ++currentType.mCurrentArrayItemIndex;
-                    }
+                    results[item.mIndex].mCode = havJSONErrorCode::FileNotWritten;
 
-                    ++itr;
+                    continue;
                 }
 
-                return true;
+                if (writeQueue.Push(std::move(item)) == false)
+                {
+                    return;
+                }
             }
-
-            return false;
         }
 
-        bool WriteBSONFile(const std::string& fileName, havJSONData& valueNode, std::vector<char>& jsonContentsAsBinaryStream)
+        // 3. Writes the converted files in the order they're finished
+        void WriteItems(const std::vector<havJSONBatchFile>& files, std::vector<havJSONResult>& results, havJSONBatchQueue& writeQueue)
         {
-            // 1. Open file stream
-#ifdef _WIN32
-            std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(_wfopen(&ConvertStringToWString(fileName)[0], L"wb"), std::fclose);
-#else
-            std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(std::fopen(fileName.c_str(), "wb"), std::fclose);
-#endif
+            std::ostringstream errorBuffer;
 
-            if (fileStream == nullptr)
-            {
-                std::cout << "Unable to write BSON file: " << fileName << "\n";
+            havJSONStream stream;
+            stream.SetErrorStream((mErrorStream != nullptr) ? &errorBuffer : nullptr);
 
-                return false;
-            }
+            havJSONBatchItem item;
 
-            // 2. Convert JSON to BSON
-            if (ConvertJSONToBSON(valueNode, jsonContentsAsBinaryStream) == true)
+            while (writeQueue.Pop(item) == true)
             {
-                // Write file size to binary file (+ 4 = file size itself)
-                std::int32_t fileSize = jsonContentsAsBinaryStream.size() + 4; // Could result into an overflow. Oh well...
-                std::fwrite(&fileSize, sizeof(std::int32_t), 1, fileStream.get());
+                const std::string& fileName = files[item.mIndex].mOutputFileName;
+
+                std::string_view fileContents = (mOutputType == havJSONBatchOutputType::BSON) ? std::string_view(item.mBSONContents.data(), item.mBSONContents.size()) : std::string_view(item.mJSONContents);
 
-                // Write file contents to binary file
-                for (std::string::size_type index = 0; index < jsonContentsAsBinaryStream.size(); ++index)
+#ifdef _WIN32
+                std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(_wfopen(&stream.ConvertStringToWString(fileName)[0], L"wb"), std::fclose);
+#else
+                std::unique_ptr<std::FILE, decltype(&std::fclose)> fileStream(std::fopen(fileName.c_str(), "wb"), std::fclose);
+#endif
+
+                bool fileWritten = fileStream != nullptr && std::fwrite(fileContents.data(), sizeof(char), fileContents.size(), fileStream.get()) == fileContents.size();
+
+                // Note: The buffered rest of the file is only written by fclose, so it can fail even if fwrite didn't
+                if (fileStream != nullptr && std::fclose(fileStream.release()) != 0)
                 {
-                    std::fwrite(&jsonContentsAsBinaryStream[index], sizeof(jsonContentsAsBinaryStream[index]), 1, fileStream.get());
+                    fileWritten = false;
                 }
 
-                return true;
-            }
+                if (fileWritten == false)
+                {
+                    stream.LogError("Unable to write ", (mOutputType == havJSONBatchOutputType::BSON) ? "BSON" : "JSON", " file: ", fileName, "\n");
+                    FlushErrors(errorBuffer);
 
-            return false;
+                    results[item.mIndex].mCode = havJSONErrorCode::FileNotWritten;
+                }
+            }
         }
 
-#ifdef _WIN32
-        std::wstring ConvertStringToWString(const std::string& value)
+        // The threads log into buffers of their own, which are copied to the error stream under a lock
+        void FlushErrors(std::ostringstream& errorBuffer)
         {
-            int numOfChars = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, value.c_str(), -1, nullptr, 0);
-
-            std::wstring wstr(numOfChars, 0);
-
-            numOfChars = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, value.c_str(), -1, &wstr[0], numOfChars);
-
-            if (numOfChars > 0)
+            if (mErrorStream == nullptr || errorBuffer.tellp() <= 0)
             {
-                return wstr;
+                return;
             }
 
-            return std::wstring();
+            std::lock_guard<std::mutex> lock(mErrorMutex);
+
+            *mErrorStream << errorBuffer.str();
+
+            errorBuffer.str(std::string());
         }
-#endif
 
-    private:
-        template<class internT, class externT, class stateT>
-        struct havJSONCodeCvt : std::codecvt<internT, externT, stateT>
-        {
-            ~havJSONCodeCvt() {}
-        };
+        unsigned int mNumOfWorkers;
+        std::size_t mMaxPendingFiles;
 
-        std::deque<havJSONTokenValue> mTokens;
+        havJSONType mInputType = havJSONType::JSON;
+        havJSONBatchOutputType mOutputType = havJSONBatchOutputType::BSON;
+
+        havJSONParseOptions mParseOptions;
+
+        std::ostream* mErrorStream = &std::cout;
+        std::mutex mErrorMutex;
     };
 }
 
@@ -0,0 +1,402 @@
+/*
+havJSONTests.cpp
+
+Regression tests for inputs that used to crash or behave differently between the parsers. Every check prints its description
+if it fails, and the exit code is the number of failed checks.
+*/
+
+#include "../havJSON.hpp"
+
+#include <fstream>
+
+struct havJSONTestRecord
+{
+    int id = 0;
+    std::string name;
+};
+
+HAVJSON_BINDING(havJSONTestRecord, HAVJSON_FIELD(havJSONTestRecord, id), HAVJSON_FIELD(havJSONTestRecord, name));
+
+namespace
+{
+    int gNumOfFailures = 0;
+
+    void Check(bool condition, const char* description)
+    {
+        if (condition == false)
+        {
+            std::cout << "Failed: " << description << "\n";
+
+            ++gNumOfFailures;
+        }
+    }
+
+    std::string ToString(const havJSON::havJSONData& valueNode)
+    {
+        havJSON::havJSONStream stream;
+
+        std::string jsonContent;
+
+        stream.ConvertJSONToString(valueNode, jsonContent);
+
+        return jsonContent;
+    }
+
+    // Note: havJSONParallelParser and havJSONLineReader throw on malformed input instead of returning false
+    template<typename Function>
+    bool FailsWithLimitError(Function&& parseFunction)
+    {
+        try
+        {
+            return parseFunction() == false;
+        }
+        catch (const havJSON::havJSONLimitError&)
+        {
+            return true;
+        }
+    }
+
+    // Feeds the content in chunks of chunkSize bytes
+    bool ParseInChunks(std::string_view jsonContent, std::size_t chunkSize, havJSON::havJSONData& valueNode)
+    {
+        havJSON::havJSONStreamParser parser;
+
+        for (std::size_t index = 0; index < jsonContent.size(); index += chunkSize)
+        {
+            if (parser.feed(jsonContent.substr(index, chunkSize)) == false)
+            {
+                break;
+            }
+        }
+
+        return parser.finish(valueNode);
+    }
+
+    void TestStreamParserDuplicateKeys()
+    {
+        // The containers under the second "a" aren't part of the tree, but their contents are still parsed
+        const char* jsonContent = R"({"a":1,"a":[1,2,{"x":3,"x":{"y":[4]}}],"b":{"c":[5],"c":{"d":6}},"e":7})";
+
+        for (std::size_t chunkSize : { std::size_t(1), std::size_t(3), std::strlen(jsonContent) })
+        {
+            havJSON::havJSONData valueNode;
+
+            Check(ParseInChunks(jsonContent, chunkSize, valueNode) == true, "havJSONStreamParser accepts duplicate keys with container values");
+            Check(ToString(valueNode) == R"({"a":1,"b":{"c":[5]},"e":7})", "havJSONStreamParser keeps the first value of a duplicate key");
+        }
+    }
+
+    void TestStreamParserMalformedInput()
+    {
+        for (const char* jsonContent : { "[tru]", "[1.]", R"(["\x"])", R"({"a":nul})", "[01]" })
+        {
+            for (std::size_t chunkSize : { std::size_t(1), std::size_t(2), std::strlen(jsonContent) })
+            {
+                havJSON::havJSONData valueNode;
+
+                try
+                {
+                    Check(ParseInChunks(jsonContent, chunkSize, valueNode) == false, "havJSONStreamParser rejects malformed input");
+                }
+                catch (const std::exception&)
+                {
+                    Check(false, "havJSONStreamParser::feed doesn't throw on malformed input");
+                }
+            }
+        }
+    }
+
+    void TestBoundStructDuplicateKeys()
+    {
+        const char* jsonContent = R"({"id":1,"name":"first","id":2,"other":0,"name":"second"})";
+
+        havJSON::havJSONStream stream;
+
+        havJSONTestRecord record;
+
+        Check(stream.TryParseContent(jsonContent, record).mCode == havJSON::havJSONErrorCode::None, "Bound struct parser accepts duplicate keys");
+        Check(record.id == 1 && record.name == "first", "Bound struct parser keeps the first value of a duplicate key");
+
+        havJSON::havJSONData valueNode;
+
+        Check(stream.ParseContent(jsonContent, valueNode) == true && ToString(valueNode) == R"({"id":1,"name":"first","other":0})", "Tree parser keeps the same values as the bound struct parser");
+    }
+
+    void TestOrderedObjectErase()
+    {
+        havJSON::havJSONOrderedObject object;
+
+        // The keys in insertion order, as object should have them
+        std::vector<std::string> keys;
+
+        std::uint32_t seed = 1;
+
+        auto nextRandom = [&]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+
+        for (std::size_t step = 0; step < 4000; ++step)
+        {
+            if (keys.size() < 24 || nextRandom() % 3 != 0)
+            {
+                std::string key = "key" + std::to_string(nextRandom() % 1000);
+
+                if (std::find(keys.begin(), keys.end(), key) == keys.end())
+                {
+                    keys.push_back(key);
+                }
+
+                object[key];
+            }
+            else
+            {
+                // Erases from the front, the back and in between
+                std::size_t position = (step % 5 == 0) ? 0 : (step % 5 == 1) ? keys.size() - 1 : nextRandom() % keys.size();
+
+                Check(object.erase(keys[position]) == 1, "havJSONOrderedObject erases an existing key");
+                Check(object.erase(keys[position]) == 0, "havJSONOrderedObject doesn't find an erased key");
+
+                keys.erase(keys.begin() + static_cast<std::ptrdiff_t>(position));
+            }
+        }
+
+        Check(object.size() == keys.size(), "havJSONOrderedObject keeps the number of keys");
+
+        bool allFound = true;
+
+        for (std::size_t position = 0; position < keys.size(); ++position)
+        {
+            allFound = allFound && object.find(keys[position]) == object.begin() + static_cast<std::ptrdiff_t>(position);
+        }
+
+        Check(allFound == true, "havJSONOrderedObject finds every key at its position after erasing");
+    }
+
+    void TestNullConversions()
+    {
+        const havJSON::havJSONData nullValue;
+
+        Check(nullValue.toBoolean() == false && nullValue.toBoolean(false, true) == true, "toBoolean returns defaultValue for null");
+        Check(nullValue.toBoolean(true, true) == true && nullValue.toInt(true, 7) == 7, "Explicit casts return defaultValue for null");
+
+        bool numberThrows = false;
+
+        try
+        {
+            nullValue.toInt();
+        }
+        catch (const std::invalid_argument&)
+        {
+            numberThrows = true;
+        }
+
+        Check(numberThrows == true, "Number getters throw for null");
+    }
+
+    void TestDeepNesting()
+    {
+        const std::size_t depth = 100000;
+
+        std::string arrayContent = std::string(depth, '[') + std::string(depth, ']');
+
+        std::string objectContent;
+
+        for (std::size_t index = 0; index < depth; ++index)
+        {
+            objectContent += "{\"a\":";
+        }
+
+        objectContent += "null" + std::string(depth, '}');
+
+        // Note: The recursion limit applies even if the parse options allow any depth
+        havJSON::havJSONParseOptions parseOptions;
+        parseOptions.mMaxDepth = std::numeric_limits<std::size_t>::max();
+
+        havJSON::havJSONStream stream;
+        stream.SetParseOptions(parseOptions);
+        stream.SetParserType(havJSON::havJSONParserType::RecursiveDescent);
+
+        havJSON::havJSONData valueNode;
+
+        Check(stream.ParseContent(arrayContent, valueNode) == false, "Recursive descent parser rejects deeply nested arrays");
+        Check(stream.TryParseContent(objectContent, valueNode).mCode == havJSON::havJSONErrorCode::LimitExceeded, "Recursive descent parser reports deeply nested objects as a limit error");
+
+        havJSON::havJSONFilter filter { "/a/a/a" };
+
+        Check(stream.TryParseContent(objectContent, valueNode, filter).mCode == havJSON::havJSONErrorCode::LimitExceeded, "Filtered parse rejects deeply nested objects");
+
+        // Note: The default handler accepts every value
+        havJSON::havJSONSAXHandler handler;
+
+        Check(stream.TryParseContent(objectContent, handler).mCode == havJSON::havJSONErrorCode::LimitExceeded, "SAX parser rejects deeply nested objects");
+
+        // Members that aren't bound are skipped with the SAX parser
+        havJSONTestRecord record;
+
+        Check(stream.TryParseContent("{\"id\":1,\"other\":" + arrayContent + "}", record).mCode == havJSON::havJSONErrorCode::LimitExceeded, "Bound struct parser rejects deeply nested members");
+
+        havJSON::havJSONParallelParser parallelParser(2);
+
+        Check(FailsWithLimitError([&]() { return parallelParser.ParseArray("[" + arrayContent + "]", valueNode); }), "havJSONParallelParser rejects deeply nested elements");
+        Check(FailsWithLimitError([&]() { return parallelParser.ParseLines(arrayContent + "\n" + arrayContent + "\n", valueNode); }), "havJSONParallelParser rejects deeply nested lines");
+
+        havJSON::havJSONLineReader lineReader;
+        lineReader.open(arrayContent);
+
+        Check(FailsWithLimitError([&]() { return lineReader.next(valueNode); }), "havJSONLineReader rejects deeply nested records");
+
+        havJSON::havJSONLazyDocument lazyDocument;
+
+        if (lazyDocument.parse(objectContent) == true)
+        {
+            havJSON::havJSONLazyValue lazyValue = lazyDocument.root();
+
+            for (std::size_t index = 0; index < depth; ++index)
+            {
+                lazyValue = lazyValue["a"];
+            }
+
+            Check(lazyValue.isNull() == true, "havJSONLazyDocument visits deeply nested objects one level at a time");
+        }
+
+        // Documents up to the limit are still parsed
+        std::string shallowContent = std::string(HAVJSON_MAX_RECURSION_DEPTH, '[') + std::string(HAVJSON_MAX_RECURSION_DEPTH, ']');
+
+        Check(stream.ParseContent(shallowContent, valueNode) == true, "Recursive descent parser accepts nesting up to the recursion limit");
+
+        std::string tooDeepContent = "[" + shallowContent + "]";
+
+        Check(stream.ParseContent(tooDeepContent, valueNode) == false, "Recursive descent parser rejects nesting beyond the recursion limit");
+    }
+
+    void TestDefaultDepthLimit()
+    {
+        const std::size_t maxDepth = havJSON::havJSONParseOptions().mMaxDepth;
+
+        std::string deepContent = std::string(100000, '[') + std::string(100000, ']');
+        std::string limitContent = std::string(maxDepth, '[') + std::string(maxDepth, ']');
+        std::string beyondLimitContent = "[" + limitContent + "]";
+
+        for (havJSON::havJSONParserType parserType : { havJSON::havJSONParserType::Tokenizer, havJSON::havJSONParserType::RecursiveDescent })
+        {
+            havJSON::havJSONStream stream;
+            stream.SetParserType(parserType);
+
+            havJSON::havJSONData valueNode;
+
+            Check(stream.ParseContent(deepContent, valueNode) == false, "Default parse options reject deeply nested input");
+            Check(stream.GetLastResult().mCode == havJSON::havJSONErrorCode::LimitExceeded, "Deeply nested input is reported as a limit error");
+            Check(stream.TryParseContent(beyondLimitContent, valueNode).mCode == havJSON::havJSONErrorCode::LimitExceeded, "Default parse options reject one level beyond the depth limit");
+            Check(stream.ParseContent(limitContent, valueNode) == true, "Default parse options accept nesting up to the depth limit");
+        }
+
+        havJSON::havJSONData valueNode;
+
+        Check(ParseInChunks(deepContent, 4096, valueNode) == false, "havJSONStreamParser rejects deeply nested input by default");
+        Check(ParseInChunks(limitContent, 4096, valueNode) == true, "havJSONStreamParser accepts nesting up to the depth limit");
+    }
+
+    void TestBatchConverterErrors()
+    {
+        const char* inputFileName = "havJSONTestsInput.json";
+
+        {
+            std::ofstream inputFile(inputFileName, std::ios::binary);
+            inputFile << R"({"a":[1,2,3]})";
+        }
+
+        // Every file fails in one of the threads, so all of them log at the same time
+        std::vector<havJSON::havJSONBatchFile> files;
+
+        for (std::size_t index = 0; index < 64; ++index)
+        {
+            files.push_back({ "havJSONTestsMissing.json", "havJSONTestsMissing.bson" });
+            files.push_back({ inputFileName, "havJSONTestsMissingDirectory/output.bson" });
+        }
+
+#ifdef __linux__
+        // Note: The write to /dev/full is buffered, so only fclose fails
+        files.push_back({ inputFileName, "/dev/full" });
+#endif
+
+        std::ostringstream errorStream;
+
+        havJSON::havJSONBatchConverter converter(4, 2);
+        converter.SetErrorStream(&errorStream);
+
+        std::vector<havJSON::havJSONResult> results = converter.ConvertFiles(files);
+
+        std::remove(inputFileName);
+
+        bool allFailed = true;
+
+        for (std::size_t index = 0; index < files.size(); ++index)
+        {
+            allFailed = allFailed && results[index].mCode == ((index % 2 == 0 && index < 128) ? havJSON::havJSONErrorCode::FileNotOpened : havJSON::havJSONErrorCode::FileNotWritten);
+        }
+
+        Check(allFailed == true, "havJSONBatchConverter reports files that can't be read or written");
+
+        // Every message is one whole line
+        std::istringstream errorLines(errorStream.str());
+
+        std::size_t numOfMessages = 0;
+        bool allWhole = true;
+
+        for (std::string line; std::getline(errorLines, line); ++numOfMessages)
+        {
+            allWhole = allWhole && (line.rfind("Unable to parse JSON file: havJSONTestsMissing.json", 0) == 0 || line.rfind("Unable to write BSON file: ", 0) == 0);
+        }
+
+        Check(allWhole == true && numOfMessages == files.size(), "havJSONBatchConverter doesn't interleave the messages of its threads");
+    }
+
+    void TestMalformedLiterals()
+    {
+        for (havJSON::havJSONParserType parserType : { havJSON::havJSONParserType::Tokenizer, havJSON::havJSONParserType::RecursiveDescent })
+        {
+            havJSON::havJSONStream stream;
+            stream.SetParserType(parserType);
+
+            // Note: The tokenizer doesn't require separators, so the rest of a malformed number mustn't become another value
+            for (const char* jsonContent : { "[0,u]", "[u]", R"({"a":u})", "u", "[tru]", "[fals]", R"({"a":nul})", "[01]", "[-01]", "[007]", "[0123,4]", "[2e3-4]", R"({"a":01})" })
+            {
+                havJSON::havJSONData valueNode;
+
+                havJSON::havJSONResult result;
+
+                try
+                {
+                    result = stream.TryParseContent(jsonContent, valueNode);
+                }
+                catch (const std::exception&)
+                {
+                    Check(false, "TryParseContent doesn't throw on malformed literals");
+
+                    continue;
+                }
+
+                Check(result.mCode == havJSON::havJSONErrorCode::SyntaxError || result.mCode == havJSON::havJSONErrorCode::UnexpectedEnd, "Malformed literals and numbers are reported as a syntax error");
+                Check(valueNode.getType() == havJSON::havJSONDataType::Null, "A failed parse leaves an empty value");
+            }
+        }
+    }
+}
+
+int main()
+{
+    TestStreamParserDuplicateKeys();
+    TestStreamParserMalformedInput();
+    TestBoundStructDuplicateKeys();
+    TestOrderedObjectErase();
+    TestNullConversions();
+    TestDeepNesting();
+    TestDefaultDepthLimit();
+    TestMalformedLiterals();
+    TestBatchConverterErrors();
+
+    if (gNumOfFailures == 0)
+    {
+        std::cout << "All checks passed\n";
+    }
+
+    return gNumOfFailures;
+}